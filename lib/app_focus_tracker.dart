@@ -1,19 +1,212 @@
 import 'dart:async';
 import 'package:flutter/services.dart';
 
+/// How often focus events are delivered.
+enum FocusGranularity {
+  /// One event per sample.
+  raw,
+
+  /// One event each time focus moves to another window or title.
+  spans,
+
+  /// Span events, delivered in groups.
+  batched,
+}
+
 class AppFocusTracker {
   static const EventChannel _channel = EventChannel('app_focus_tracker');
+  static const MethodChannel _methods = MethodChannel('app_focus_tracker/methods');
 
   Stream<Map<String, dynamic>>? _stream;
+  StreamController<Map<String, dynamic>>? _budgetAlerts;
 
   Stream<Map<String, dynamic>> get focusStream {
-    _stream ??= _channel.receiveBroadcastStream().map((event) {
+    _stream ??= focusEvents();
+    return _stream!;
+  }
+
+  /// Focus events at [granularity]. Batches are flattened into single events.
+  ///
+  /// [apps] and [excludeApps] restrict events by process name and
+  /// [minDuration] drops shorter events; [fields] limits the keys each event
+  /// carries. All of these are applied natively, before events are encoded.
+  ///
+  /// With [latencyStamps], each event also carries `latency`: when the
+  /// focus change was detected, handed to the plugin, encoded and sent, plus
+  /// `receivedUs` when it arrived here, all in microseconds since the epoch.
+  /// Batches share the stamps of their batch and have no `detectedUs`.
+  ///
+  /// The channel carries one stream per engine, so listening here replaces
+  /// any stream already listening with other arguments.
+  Stream<Map<String, dynamic>> focusEvents({
+    FocusGranularity granularity = FocusGranularity.raw,
+    Duration batchInterval = const Duration(seconds: 10),
+    int maxBatch = 100,
+    List<String>? apps,
+    List<String>? excludeApps,
+    Duration minDuration = Duration.zero,
+    List<String>? fields,
+    bool latencyStamps = false,
+  }) {
+    return _channel.receiveBroadcastStream({
+      'granularity': granularity.name,
+      'batchIntervalMs': batchInterval.inMilliseconds,
+      'maxBatch': maxBatch,
+      'filter': {
+        if (apps != null) 'apps': apps,
+        if (excludeApps != null) 'excludeApps': excludeApps,
+        'minDurationMs': minDuration.inMilliseconds,
+      },
+      if (fields != null) 'fields': fields,
+      if (latencyStamps) 'latency': true,
+    }).expand((event) {
       final Map<String, dynamic> eventMap = Map<String, dynamic>.from(event);
-      return {
-        'appName': eventMap['appName'] as String,
-        'duration': eventMap['duration'] as int,
-      };
+      final latency = _decodeLatency(eventMap['latency']);
+      final batch = eventMap['events'];
+      if (batch is List) {
+        return batch.map((e) => _decode(e, latency));
+      }
+      return [_decode(eventMap, latency)];
     });
-    return _stream!;
+  }
+
+  /// The window focused at the latest sample, or null if nothing has been
+  /// sampled yet. The first call starts sampling if no stream is listening,
+  /// so it may return null once.
+  Future<Map<String, dynamic>?> getCurrentFocus() async {
+    final focus = await _methods.invokeMapMethod<String, dynamic>('getCurrentFocus');
+    return focus;
+  }
+
+  /// Alerts with once per day when the apps covered by [apps] have had focus
+  /// for [limit] in total. Returns an id for [removeBudget]; alerts arrive on
+  /// [budgetAlerts].
+  Future<int> addBudget(List<String> apps, Duration limit) async {
+    _listenForAlerts();
+    final id = await _methods.invokeMethod<int>('addBudget', {
+      'apps': apps,
+      'limitMs': limit.inMilliseconds,
+    });
+    return id!;
+  }
+
+  Future<bool> removeBudget(int id) async {
+    return await _methods.invokeMethod<bool>('removeBudget', {'id': id}) ?? false;
+  }
+
+  /// Starts recording every raw sample to a binary trace at [path], which
+  /// tests and benchmarks can replay. Returns false if the file could not
+  /// be created.
+  Future<bool> startTraceCapture(String path) async {
+    return await _methods.invokeMethod<bool>('startCapture', {'path': path}) ?? false;
+  }
+
+  /// Ends the capture and returns the number of samples recorded, or -1 if
+  /// none was running or the trace could not be written.
+  Future<int> stopTraceCapture() async {
+    return await _methods.invokeMethod<int>('stopCapture') ?? -1;
+  }
+
+  /// Starts appending every focus span to a history in [directory], which
+  /// [exportHistory] exports as CSV or JSON lines.
+  /// Recording continues an existing history and is shared by every engine
+  /// in the process. Returns false if the history could not be opened.
+  Future<bool> startRecording(String directory) async {
+    return await _methods.invokeMethod<bool>('startRecording', {'directory': directory}) ?? false;
+  }
+
+  /// Stops recording and writes the history's final snapshot. Returns false
+  /// if nothing was being recorded.
+  Future<bool> stopRecording() async {
+    return await _methods.invokeMethod<bool>('stopRecording') ?? false;
+  }
+
+  /// Writes the history recorded in [directory] (see [startRecording]) to
+  /// [path] as CSV, or with [jsonLines] as JSON lines, and returns the
+  /// number of sessions written. Only sessions overlapping [from]..[to] are
+  /// written, and with [appName] or [titleContains] only those of that app
+  /// or whose title contains the text, ignoring ASCII case. The export runs
+  /// on a native background thread, one at a time; a failure throws a
+  /// [PlatformException].
+  Future<int> exportHistory(String directory, String path,
+      {bool jsonLines = false, DateTime? from, DateTime? to, String? appName, String? titleContains}) async {
+    final sessions = await _methods.invokeMethod<int>('exportHistory', {
+      'directory': directory,
+      'path': path,
+      'format': jsonLines ? 'jsonl' : 'csv',
+      if (from != null) 'from': from.millisecondsSinceEpoch,
+      if (to != null) 'to': to.millisecondsSinceEpoch,
+      if (appName != null) 'appName': appName,
+      if (titleContains != null) 'titleContains': titleContains,
+    });
+    return sessions ?? 0;
+  }
+
+  /// Starts recording a timeline of the native sampling, title, journal
+  /// and platform threads, discarding any earlier recording.
+  Future<void> startPipelineTracing() async {
+    await _methods.invokeMethod<void>('startTracing');
+  }
+
+  /// Stops recording and returns the timeline as Chrome trace JSON (a
+  /// `String`), or with [perfetto] as a Perfetto trace (a `Uint8List`).
+  Future<Object?> stopPipelineTracing({bool perfetto = false}) async {
+    return _methods.invokeMethod<Object>('stopTracing', {'format': perfetto ? 'perfetto' : 'json'});
+  }
+
+  /// Native counters since the process started: `samples`, `osCalls`,
+  /// `titleFetches`, `titleTimeouts`, `samplesMerged`, `eventsEmitted`,
+  /// `eventBytes`, `eventsDropped`, `journalBytes`, `fsyncs` and `wakeups`;
+  /// the current `queueDepth`; and `titleFetch` and `fsync` timings, each
+  /// with `count`, `meanNs`, `p50Ns`, `p90Ns`, `p99Ns` and `maxNs`.
+  Future<Map<String, dynamic>> getMetrics() async {
+    final metrics = await _methods.invokeMapMethod<String, dynamic>('getMetrics');
+    return metrics ?? {};
+  }
+
+  /// Native latency of focus events sent so far, per stage: `deliver` (OS
+  /// read to plugin), `encode`, `queue` (waiting for the platform thread)
+  /// and `total`. Each has `count`, `meanNs`, `p50Ns`, `p90Ns`, `p99Ns` and
+  /// `maxNs`. [reset] starts the histograms over after reading them.
+  Future<Map<String, dynamic>> getLatencyStats({bool reset = false}) async {
+    final stats = await _methods.invokeMapMethod<String, dynamic>('getLatency', {'reset': reset});
+    return stats ?? {};
+  }
+
+  /// Budget alerts: `id`, `appName`, `usedMs` and `at` (ms since epoch).
+  Stream<Map<String, dynamic>> get budgetAlerts {
+    _listenForAlerts();
+    return _budgetAlerts!.stream;
+  }
+
+  void _listenForAlerts() {
+    if (_budgetAlerts != null) return;
+    _budgetAlerts = StreamController<Map<String, dynamic>>.broadcast();
+    _methods.setMethodCallHandler((call) async {
+      if (call.method == 'onBudgetExceeded') {
+        _budgetAlerts!.add(Map<String, dynamic>.from(call.arguments as Map));
+      }
+    });
+  }
+
+  static Map<String, dynamic> _decode(dynamic event, [Map<String, int>? latency]) {
+    final Map<String, dynamic> eventMap = Map<String, dynamic>.from(event);
+    return {
+      'appName': eventMap['appName'] as String?,
+      'windowTitle': eventMap['windowTitle'] as String?,
+      'processId': eventMap['processId'] as int?,
+      'start': eventMap['start'] as int?,
+      'end': eventMap['end'] as int?,
+      'duration': eventMap['duration'] as int?,
+      if (latency != null) 'latency': latency,
+    };
+  }
+
+  static Map<String, int>? _decodeLatency(dynamic stamps) {
+    if (stamps is! Map) return null;
+    return {
+      ...Map<String, int>.from(stamps),
+      'receivedUs': DateTime.now().microsecondsSinceEpoch,
+    };
   }
 }
@@ -2,90 +2,337 @@
 
 #include <flutter/encodable_value.h>
 #include <flutter/event_channel.h>
+#include <flutter/event_stream_handler_functions.h>
+#include <flutter/method_channel.h>
 #include <flutter/standard_method_codec.h>
-#include <windows.h>
-#include <string>
-#include <thread>
+#include <algorithm>
 #include <chrono>
-#include <map> // For std::map
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "event_encoding.h"
+#include "pipeline_tracing.h"
+
+using app_focus_tracker::AddLatencyStamps;
+using app_focus_tracker::EncodeCurrentFocus;
+using app_focus_tracker::EncodedSize;
+using app_focus_tracker::EncodeEventLatency;
+using app_focus_tracker::EncodeMetrics;
+using app_focus_tracker::EncodeSpans;
+using app_focus_tracker::FindArgument;
+using app_focus_tracker::FocusSpan;
+using app_focus_tracker::GetInt;
+using app_focus_tracker::GetStrings;
+using app_focus_tracker::Granularity;
+using app_focus_tracker::LatencyStamps;
+using app_focus_tracker::MonotonicNowNs;
+using app_focus_tracker::ParseFields;
+using app_focus_tracker::ParseSubscriptionOptions;
+using app_focus_tracker::PipelineTracing;
+using app_focus_tracker::SubscriptionOptions;
+using app_focus_tracker::TrackerMetrics;
+using app_focus_tracker::TracingScope;
 
 namespace {
 
-std::string GetWindowTitle(HWND hwnd) {
-    char window_title[256];
-    GetWindowTextA(hwnd, window_title, sizeof(window_title));
-    return std::string(window_title);
-}
+// An encoded event on its way to the platform thread. It counts towards
+// the queue depth for as long as it exists, so events dropped along with
+// the dispatcher's queue are not counted forever.
+struct QueuedEvent {
+    explicit QueuedEvent(flutter::EncodableValue encoded) : value(std::move(encoded)) {
+        TrackerMetrics::Get().Adjust(app_focus_tracker::Gauge::kQueueDepth, 1);
+    }
+    ~QueuedEvent() { TrackerMetrics::Get().Adjust(app_focus_tracker::Gauge::kQueueDepth, -1); }
+
+    flutter::EncodableValue value;
+};
 
 }  // namespace
 
-AppFocusTrackerPlugin::AppFocusTrackerPlugin() {}
+AppFocusTrackerPlugin::AppFocusTrackerPlugin(
+    std::shared_ptr<app_focus_tracker::FocusSampler> sampler,
+    std::unique_ptr<app_focus_tracker::PlatformDispatcher> dispatcher)
+    : sampler_(std::move(sampler)),
+      dispatcher_(std::move(dispatcher)),
+      channel_(std::make_shared<Channel>()) {}
 
 AppFocusTrackerPlugin::~AppFocusTrackerPlugin() {
-    StopTracking();
+    if (event_channel_) {
+        event_channel_->SetStreamHandler(nullptr);
+    }
+    if (method_channel_) {
+        method_channel_->SetMethodCallHandler(nullptr);
+    }
+    Unsubscribe();
+    for (uint64_t id : budgets_) {
+        sampler_->RemoveBudget(id);
+    }
+    if (presence_ != 0) {
+        sampler_->Unsubscribe(presence_);
+    }
+    // The export posts its answer through |dispatcher_|, which outlives this.
+    cancel_export_ = true;
+    if (export_thread_.joinable()) {
+        export_thread_.join();
+    }
 }
 
-std::string AppFocusTrackerPlugin::GetActiveWindowTitle() {
-    HWND hwnd = GetForegroundWindow();
-    return GetWindowTitle(hwnd);
+void AppFocusTrackerPlugin::EnsureSampling() {
+    if (presence_ == 0) {
+        presence_ = sampler_->Subscribe(app_focus_tracker::SubscriptionOptions(), nullptr);
+    }
 }
 
-void AppFocusTrackerPlugin::StartTracking() {
-    is_tracking_ = true;
-    tracking_thread_ = std::thread([this]() {
-        std::string activeAppName = "Unknown";
-
-        while (is_tracking_) {
-            std::string currentAppName = GetActiveWindowTitle();
-
-            if (currentAppName != activeAppName) {
-                activeAppName = currentAppName;
+uint64_t AppFocusTrackerPlugin::AddBudget(const app_focus_tracker::BudgetRule& rule) {
+    EnsureSampling();
+    std::weak_ptr<Channel> channel = channel_;
+    app_focus_tracker::PlatformDispatcher* dispatcher = dispatcher_.get();
+    uint64_t id = sampler_->AddBudget(rule, [channel, dispatcher](const app_focus_tracker::BudgetAlert& alert) {
+        flutter::EncodableMap event;
+        event[flutter::EncodableValue("id")] = flutter::EncodableValue(static_cast<int64_t>(alert.rule_id));
+        event[flutter::EncodableValue("appName")] = flutter::EncodableValue(alert.app_name);
+        event[flutter::EncodableValue("usedMs")] = flutter::EncodableValue(alert.used_us / 1000);
+        event[flutter::EncodableValue("at")] = flutter::EncodableValue(alert.at_us / 1000);
+        auto arguments = std::make_shared<flutter::EncodableValue>(std::move(event));
+        dispatcher->Post([channel, arguments]() {
+            auto target = channel.lock();
+            if (target && target->methods) {
+                target->methods->InvokeMethod("onBudgetExceeded",
+                                              std::make_unique<flutter::EncodableValue>(*arguments));
             }
+        });
+    });
+    budgets_.push_back(id);
+    return id;
+}
 
-            if (event_sink_) {
-                std::map<flutter::EncodableValue, flutter::EncodableValue> event;
-                event[flutter::EncodableValue("appName")] = flutter::EncodableValue(activeAppName);
-                event[flutter::EncodableValue("duration")] = flutter::EncodableValue(1);
-                event_sink_->Success(event);
+void AppFocusTrackerPlugin::ExportHistory(
+    std::string directory, std::string path, std::string app_name, app_focus_tracker::ExportOptions options,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+    if (exporting_) {
+        result->Error("busy", "an export is already running");
+        return;
+    }
+    if (export_thread_.joinable()) {
+        export_thread_.join();
+    }
+    exporting_ = true;
+    options.progress = [this](const app_focus_tracker::ExportProgress&) { return !cancel_export_; };
+    options.progress_interval = 1000;
+    std::shared_ptr<flutter::MethodResult<flutter::EncodableValue>> reply = std::move(result);
+    app_focus_tracker::PlatformDispatcher* dispatcher = dispatcher_.get();
+    export_thread_ = std::thread([this, dispatcher, directory = std::move(directory), path = std::move(path),
+                                  app_name = std::move(app_name), options = std::move(options), reply]() mutable {
+        PipelineTracing::SetThreadName("export");
+        // Read-only, so the history may be one the sampler is recording.
+        app_focus_tracker::FocusStore::Options store_options;
+        store_options.read_only = true;
+        app_focus_tracker::FocusStore store;
+        app_focus_tracker::ExportResult exported;
+        if (store.Open(directory, store_options)) {
+            if (!app_name.empty()) {
+                options.filter.filter_app = true;
+                options.filter.app_id = store.apps().Find(app_name);
             }
-
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+            exported = app_focus_tracker::ExportSessionsToFile(store, path, options);
         }
+        exporting_ = false;
+        dispatcher->Post([reply, exported]() {
+            if (exported.ok) {
+                reply->Success(flutter::EncodableValue(static_cast<int64_t>(exported.sessions)));
+            } else {
+                reply->Error("export-failed", "the history could not be read or the file written");
+            }
+        });
     });
 }
 
-void AppFocusTrackerPlugin::StopTracking() {
-    is_tracking_ = false;
-    if (tracking_thread_.joinable()) {
-        tracking_thread_.join();
+void AppFocusTrackerPlugin::HandleMethodCall(
+    const flutter::MethodCall<flutter::EncodableValue>& call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+    if (call.method_name() == "getCurrentFocus") {
+        EnsureSampling();
+        result->Success(EncodeCurrentFocus(sampler_->current()));
+    } else if (call.method_name() == "addBudget") {
+        // {"apps": [String], "limitMs": int}
+        app_focus_tracker::BudgetRule rule;
+        rule.apps = GetStrings(FindArgument(call.arguments(), "apps"));
+        int64_t limit_ms = 0;
+        if (rule.apps.empty() || !GetInt(FindArgument(call.arguments(), "limitMs"), &limit_ms) || limit_ms <= 0) {
+            result->Error("bad-arguments", "addBudget needs apps and a positive limitMs");
+            return;
+        }
+        rule.limit_us = limit_ms * 1000;
+        result->Success(flutter::EncodableValue(static_cast<int64_t>(AddBudget(rule))));
+    } else if (call.method_name() == "removeBudget") {
+        int64_t id = 0;
+        auto it = std::find(budgets_.begin(), budgets_.end(), static_cast<uint64_t>(
+            GetInt(FindArgument(call.arguments(), "id"), &id) ? id : 0));
+        bool removed = it != budgets_.end() && sampler_->RemoveBudget(*it);
+        if (it != budgets_.end()) budgets_.erase(it);
+        result->Success(flutter::EncodableValue(removed));
+    } else if (call.method_name() == "startCapture") {
+        // {"path": String}
+        const auto* path = FindArgument(call.arguments(), "path");
+        if (!path || !std::holds_alternative<std::string>(*path)) {
+            result->Error("bad-arguments", "startCapture needs a path");
+            return;
+        }
+        EnsureSampling();
+        bool started = sampler_->StartCapture(std::get<std::string>(*path));
+        result->Success(flutter::EncodableValue(started));
+    } else if (call.method_name() == "stopCapture") {
+        result->Success(flutter::EncodableValue(sampler_->StopCapture()));
+    } else if (call.method_name() == "startRecording") {
+        // {"directory": String}
+        const auto* directory = FindArgument(call.arguments(), "directory");
+        if (!directory || !std::holds_alternative<std::string>(*directory)) {
+            result->Error("bad-arguments", "startRecording needs a directory");
+            return;
+        }
+        EnsureSampling();
+        result->Success(flutter::EncodableValue(sampler_->StartRecording(std::get<std::string>(*directory))));
+    } else if (call.method_name() == "stopRecording") {
+        result->Success(flutter::EncodableValue(sampler_->StopRecording()));
+    } else if (call.method_name() == "exportHistory") {
+        // {"directory": String, "path": String, "format": "csv" | "jsonl",
+        //  "from": int?, "to": int? (ms since epoch), "appName": String?,
+        //  "titleContains": String?}
+        const auto* directory = FindArgument(call.arguments(), "directory");
+        const auto* path = FindArgument(call.arguments(), "path");
+        if (!directory || !std::holds_alternative<std::string>(*directory) || !path ||
+            !std::holds_alternative<std::string>(*path)) {
+            result->Error("bad-arguments", "exportHistory needs a directory and a path");
+            return;
+        }
+        app_focus_tracker::ExportOptions options;
+        const auto* format = FindArgument(call.arguments(), "format");
+        if (format && std::holds_alternative<std::string>(*format) && std::get<std::string>(*format) == "jsonl") {
+            options.format = app_focus_tracker::ExportFormat::kJsonLines;
+        }
+        int64_t ms = 0;
+        if (GetInt(FindArgument(call.arguments(), "from"), &ms)) options.filter.from_us = ms * 1000;
+        if (GetInt(FindArgument(call.arguments(), "to"), &ms)) options.filter.to_us = ms * 1000;
+        const auto* title = FindArgument(call.arguments(), "titleContains");
+        if (title && std::holds_alternative<std::string>(*title)) {
+            options.filter.title_contains = std::get<std::string>(*title);
+        }
+        const auto* app = FindArgument(call.arguments(), "appName");
+        ExportHistory(std::get<std::string>(*directory), std::get<std::string>(*path),
+                      app && std::holds_alternative<std::string>(*app) ? std::get<std::string>(*app) : std::string(),
+                      std::move(options), std::move(result));
+    } else if (call.method_name() == "getMetrics") {
+        result->Success(EncodeMetrics(TrackerMetrics::Get()));
+    } else if (call.method_name() == "startTracing") {
+        PipelineTracing::Start();
+        result->Success();
+    } else if (call.method_name() == "stopTracing") {
+        // {"format": "json" | "perfetto"}
+        PipelineTracing::Stop();
+        const auto* format = FindArgument(call.arguments(), "format");
+        if (format && std::holds_alternative<std::string>(*format) && std::get<std::string>(*format) == "perfetto") {
+            std::string trace = PipelineTracing::PerfettoProto();
+            result->Success(flutter::EncodableValue(std::vector<uint8_t>(trace.begin(), trace.end())));
+        } else {
+            result->Success(flutter::EncodableValue(PipelineTracing::ChromeJson()));
+        }
+    } else if (call.method_name() == "getLatency") {
+        // {"reset": bool}
+        result->Success(EncodeEventLatency(channel_->latency));
+        const auto* reset = FindArgument(call.arguments(), "reset");
+        if (reset && std::holds_alternative<bool>(*reset) && std::get<bool>(*reset)) {
+            channel_->latency.Reset();
+        }
+    } else {
+        result->NotImplemented();
+    }
+}
+
+void AppFocusTrackerPlugin::Unsubscribe() {
+    if (subscription_ != 0) {
+        sampler_->Unsubscribe(subscription_);
+        subscription_ = 0;
     }
 }
 
 std::unique_ptr<flutter::StreamHandlerError<flutter::EncodableValue>> AppFocusTrackerPlugin::OnListenInternal(
     const flutter::EncodableValue* arguments,
     std::unique_ptr<flutter::EventSink<flutter::EncodableValue>>&& events) {
-    event_sink_ = std::move(events);
-    StartTracking();
+    // Dart allows one active stream per channel; a new listen replaces it.
+    Unsubscribe();
+    channel_->sink = std::move(events);
+    uint64_t generation = ++channel_->generation;
+
+    SubscriptionOptions options = ParseSubscriptionOptions(arguments);
+    uint32_t fields = ParseFields(arguments);
+    const auto* latency = FindArgument(arguments, "latency");
+    bool add_stamps = latency && std::holds_alternative<bool>(*latency) && std::get<bool>(*latency);
+    std::weak_ptr<Channel> channel = channel_;
+    app_focus_tracker::PlatformDispatcher* dispatcher = dispatcher_.get();
+    // Encoding happens on the sampling thread; only the send is posted.
+    subscription_ = sampler_->Subscribe(options, [=](const FocusSpan* spans, size_t count) {
+        LatencyStamps stamps;
+        // Batches wait on purpose, so only their encoding and queueing count.
+        if (options.granularity != Granularity::kBatched) stamps.detected_ns = spans[0].detected_ns;
+        stamps.delivered_ns = MonotonicNowNs();
+        std::shared_ptr<QueuedEvent> event;
+        {
+            TracingScope tracing("encode");
+            event = std::make_shared<QueuedEvent>(EncodeSpans(spans, count, options.granularity, fields));
+        }
+        stamps.encoded_ns = MonotonicNowNs();
+        dispatcher->Post([channel, generation, event, stamps, add_stamps]() mutable {
+            PipelineTracing::SetThreadName("platform");
+            TracingScope tracing("dispatch");
+            TrackerMetrics& metrics = TrackerMetrics::Get();
+            auto target = channel.lock();
+            if (target && target->generation == generation && target->sink) {
+                stamps.dispatched_ns = MonotonicNowNs();
+                target->latency.Record(stamps);
+                if (add_stamps) AddLatencyStamps(stamps, &event->value);
+                metrics.Add(app_focus_tracker::Counter::kEventsEmitted);
+                metrics.Add(app_focus_tracker::Counter::kEventBytes, EncodedSize(event->value));
+                target->sink->Success(event->value);
+            } else {
+                metrics.Add(app_focus_tracker::Counter::kEventsDropped);
+            }
+        });
+    });
     return nullptr;
 }
 
 std::unique_ptr<flutter::StreamHandlerError<flutter::EncodableValue>> AppFocusTrackerPlugin::OnCancelInternal(
-    const flutter::EncodableValue* arguments) {
-    StopTracking();
-    event_sink_ = nullptr;
+    const flutter::EncodableValue* /*arguments*/) {
+    Unsubscribe();
+    ++channel_->generation;
+    channel_->sink = nullptr;
     return nullptr;
 }
 
-void AppFocusTrackerPlugin::RegisterWithRegistrar(flutter::PluginRegistrarWindows* registrar) {
-    auto plugin = std::make_unique<AppFocusTrackerPlugin>();
-
-    auto event_channel = std::make_unique<flutter::EventChannel<flutter::EncodableValue>>(
-        registrar->messenger(), "app_focus_tracker", &flutter::StandardMethodCodec::GetInstance());
+void AppFocusTrackerPlugin::ConnectChannels(flutter::BinaryMessenger* messenger) {
+    event_channel_ = std::make_unique<flutter::EventChannel<flutter::EncodableValue>>(
+        messenger, "app_focus_tracker", &flutter::StandardMethodCodec::GetInstance());
 
-    event_channel->SetStreamHandler(std::make_unique<AppFocusTrackerPlugin>());
+    // The plugin owns the channels, so they never outlive it.
+    AppFocusTrackerPlugin* handler = this;
+    event_channel_->SetStreamHandler(
+        std::make_unique<flutter::StreamHandlerFunctions<flutter::EncodableValue>>(
+            [handler](const flutter::EncodableValue* arguments,
+                      std::unique_ptr<flutter::EventSink<flutter::EncodableValue>>&& events) {
+                return handler->OnListen(arguments, std::move(events));
+            },
+            [handler](const flutter::EncodableValue* arguments) {
+                return handler->OnCancel(arguments);
+            }));
 
-    registrar->AddPlugin(std::move(plugin));
+    method_channel_ = std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+        messenger, "app_focus_tracker/methods", &flutter::StandardMethodCodec::GetInstance());
+    channel_->methods = method_channel_.get();
+    method_channel_->SetMethodCallHandler(
+        [handler](const flutter::MethodCall<flutter::EncodableValue>& call,
+                  std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+            handler->HandleMethodCall(call, std::move(result));
+        });
 }
-
-
-
@@ -1,29 +1,76 @@
 #ifndef FLUTTER_PLUGIN_APP_FOCUS_TRACKER_PLUGIN_H_
 #define FLUTTER_PLUGIN_APP_FOCUS_TRACKER_PLUGIN_H_
 
+#include <flutter/binary_messenger.h>
 #include <flutter/encodable_value.h>
 #include <flutter/event_channel.h>
+#include <flutter/method_channel.h>
 #include <flutter/plugin_registrar_windows.h>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
+#include "event_latency.h"
+#include "focus_export.h"
+#include "focus_sampler.h"
+#include "platform_dispatcher.h"
+#include "session_monitor.h"
 
 class AppFocusTrackerPlugin : public flutter::Plugin, public flutter::StreamHandler<flutter::EncodableValue> {
 public:
     static void RegisterWithRegistrar(flutter::PluginRegistrarWindows* registrar);
 
-    AppFocusTrackerPlugin();
+    AppFocusTrackerPlugin(std::shared_ptr<app_focus_tracker::FocusSampler> sampler,
+                          std::unique_ptr<app_focus_tracker::PlatformDispatcher> dispatcher);
     virtual ~AppFocusTrackerPlugin();
 
+    // Creates the event and method channels on |messenger| and routes them
+    // to this plugin. RegisterWithRegistrar does this with the engine's
+    // messenger; tests use a fake one.
+    void ConnectChannels(flutter::BinaryMessenger* messenger);
+
+    void HandleMethodCall(const flutter::MethodCall<flutter::EncodableValue>& call,
+                          std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
 private:
-    std::unique_ptr<flutter::EventSink<flutter::EncodableValue>> event_sink_;
-    std::thread tracking_thread_;
-    bool is_tracking_ = false;
+    // Platform-thread state that queued tasks may outlive the plugin with.
+    struct Channel {
+        std::unique_ptr<flutter::EventSink<flutter::EncodableValue>> sink;
+        // Bumped on every listen/cancel so stale events are dropped.
+        uint64_t generation = 0;
+        flutter::MethodChannel<flutter::EncodableValue>* methods = nullptr;
+        // Recorded on the platform thread as each event is sent.
+        app_focus_tracker::EventLatency latency;
+    };
+
+    std::shared_ptr<app_focus_tracker::FocusSampler> sampler_;
+    std::unique_ptr<app_focus_tracker::PlatformDispatcher> dispatcher_;
+    std::unique_ptr<app_focus_tracker::SessionMonitor> session_monitor_;
+    std::unique_ptr<flutter::EventChannel<flutter::EncodableValue>> event_channel_;
+    std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> method_channel_;
+    std::shared_ptr<Channel> channel_;
+    app_focus_tracker::FocusSampler::SubscriptionId subscription_ = 0;
+    // Keeps the sampler running for getCurrentFocus and budgets once either
+    // has been used.
+    app_focus_tracker::FocusSampler::SubscriptionId presence_ = 0;
+    std::vector<uint64_t> budgets_;
+    // Runs exportHistory off the platform thread, one export at a time.
+    // The destructor cancels a running export and joins it.
+    std::thread export_thread_;
+    std::atomic<bool> exporting_{false};
+    std::atomic<bool> cancel_export_{false};
 
-    std::string GetActiveWindowTitle();
-    void StartTracking();
-    void StopTracking();
+    void Unsubscribe();
+    void EnsureSampling();
+    uint64_t AddBudget(const app_focus_tracker::BudgetRule& rule);
+    // Exports the history in |directory| to |path| on |export_thread_| and
+    // answers |result| with the number of sessions from the platform thread.
+    void ExportHistory(std::string directory, std::string path, std::string app_name,
+                       app_focus_tracker::ExportOptions options,
+                       std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
 
     // StreamHandler methods
     std::unique_ptr<flutter::StreamHandlerError<flutter::EncodableValue>> OnListenInternal(
@@ -1,5 +1,12 @@
 #include "include/app_focus_tracker/app_focus_tracker_plugin_c_api.h"
 #include "app_focus_tracker_plugin.h"
+#include <cstring>
+#include <string>
+
+#include "focus_export.h"
+#include "focus_sampler.h"
+#include "focus_store.h"
+#include "tracker_metrics.h"
 
 void AppFocusTrackerPluginCApiRegisterWithRegistrar(
     FlutterDesktopPluginRegistrarRef registrar) {
@@ -7,3 +14,82 @@ void AppFocusTrackerPluginCApiRegisterWithRegistrar(
         flutter::PluginRegistrarManager::GetInstance()
             ->GetRegistrar<flutter::PluginRegistrarWindows>(registrar));
 }
+
+int64_t AppFocusTrackerExportHistory(
+    const char* directory, const char* output_path, int output_fd,
+    int format, int64_t from_us, int64_t to_us, const char* app_name,
+    AppFocusTrackerExportProgressCallback progress, void* user_data) {
+    using namespace app_focus_tracker;
+    if (!directory) return -1;
+
+    FocusStore::Options store_options;
+    store_options.read_only = true;
+    FocusStore store;
+    if (!store.Open(directory, store_options)) return -1;
+
+    ExportOptions options;
+    options.format = format == APP_FOCUS_TRACKER_EXPORT_JSON_LINES ? ExportFormat::kJsonLines
+                                                                   : ExportFormat::kCsv;
+    options.filter.from_us = from_us;
+    options.filter.to_us = to_us;
+    if (app_name) {
+        options.filter.filter_app = true;
+        options.filter.app_id = store.apps().Find(app_name);
+    }
+    if (progress) {
+        options.progress = [progress, user_data](const ExportProgress& state) {
+            return progress(state.sessions, state.bytes, user_data) != 0;
+        };
+    }
+
+    ExportResult result = output_path ? ExportSessionsToFile(store, output_path, options)
+                                      : ExportSessionsToFd(store, output_fd, options);
+    if (result.cancelled) return -2;
+    return result.ok ? static_cast<int64_t>(result.sessions) : -1;
+}
+
+int AppFocusTrackerGetCurrentFocus(AppFocusTrackerCurrentFocus* focus) {
+    using namespace app_focus_tracker;
+    if (!focus) return 0;
+    std::shared_ptr<FocusSampler> sampler = FocusSampler::Current();
+    if (!sampler) return 0;
+
+    CurrentFocus current;
+    if (!sampler->current().Read(&current)) return 0;
+    focus->since_us = current.since_us;
+    focus->updated_us = current.updated_us;
+    focus->window_id = current.window_id;
+    focus->process_id = current.process_id;
+    static_assert(sizeof(focus->app_name) == CurrentFocus::kAppNameSize &&
+                      sizeof(focus->title) == CurrentFocus::kTitleSize,
+                  "the C API and the slot must agree on name sizes");
+    std::memcpy(focus->app_name, current.app_name, sizeof(focus->app_name));
+    std::memcpy(focus->title, current.title, sizeof(focus->title));
+    return 1;
+}
+
+void AppFocusTrackerGetMetrics(AppFocusTrackerMetrics* metrics) {
+    using namespace app_focus_tracker;
+    if (!metrics) return;
+    const TrackerMetrics& source = TrackerMetrics::Get();
+    metrics->samples = source.value(Counter::kSamples);
+    metrics->os_calls = source.value(Counter::kOsCalls);
+    metrics->title_fetches = source.value(Counter::kTitleFetches);
+    metrics->title_timeouts = source.value(Counter::kTitleTimeouts);
+    metrics->samples_merged = source.value(Counter::kSamplesMerged);
+    metrics->events_emitted = source.value(Counter::kEventsEmitted);
+    metrics->event_bytes = source.value(Counter::kEventBytes);
+    metrics->events_dropped = source.value(Counter::kEventsDropped);
+    metrics->journal_bytes = source.value(Counter::kJournalBytes);
+    metrics->fsyncs = source.value(Counter::kFsyncs);
+    metrics->wakeups = source.value(Counter::kWakeups);
+    metrics->queue_depth = source.value(Gauge::kQueueDepth);
+    const LatencyHistogram& title_fetch = source.timing(Timing::kTitleFetch);
+    metrics->title_fetch_p50_ns = title_fetch.Percentile(50);
+    metrics->title_fetch_p99_ns = title_fetch.Percentile(99);
+    metrics->title_fetch_max_ns = title_fetch.max();
+    const LatencyHistogram& fsync = source.timing(Timing::kFsync);
+    metrics->fsync_p50_ns = fsync.Percentile(50);
+    metrics->fsync_p99_ns = fsync.Percentile(99);
+    metrics->fsync_max_ns = fsync.max();
+}
@@ -0,0 +1,239 @@
+// Replays months of synthetic focus activity through the whole pipeline
+// (sampler, sessionizer, span encoding, store aggregates and journal) on a
+// VirtualClock, checking memory after every simulated day, e.g.
+//
+//   focus_soak                            180 days of "typical"
+//   focus_soak title_churn --days=365 --json
+//   focus_soak --days=28 --rollup-days=7  a quick run
+//
+// Once the daily rollups are full (--warmup-days, by default
+// --rollup-days) nothing the tracker keeps should grow with the length of
+// history: the profile draws from a fixed set of apps and titles, so the
+// dictionaries stop growing early. Exits with 1 if live heap bytes or
+// allocations grew by more than --tolerance-kb plus 2% over the rest of the
+// run. Resident memory is reported but not judged, since allocators keep
+// freed pages.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "event_encoding.h"
+#include "focus_sampler.h"
+#include "focus_store.h"
+#include "process_memory.h"
+#include "synthetic_workload.h"
+#include "virtual_clock.h"
+
+namespace {
+
+using app_focus_tracker::FocusSampler;
+using app_focus_tracker::FocusSpan;
+using app_focus_tracker::FocusStore;
+using app_focus_tracker::ProcessMemory;
+using app_focus_tracker::WorkloadProfile;
+
+std::atomic<int64_t> g_live_allocations{0};
+std::atomic<int64_t> g_live_bytes{0};
+
+// Each block carries its size in front, so delete knows how much it frees.
+constexpr size_t kBlockHeader = alignof(std::max_align_t);
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    void* block = std::malloc(size + kBlockHeader);
+    if (!block) throw std::bad_alloc();
+    *static_cast<std::size_t*>(block) = size;
+    g_live_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_live_bytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+    return static_cast<char*>(block) + kBlockHeader;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (!pointer) return;
+    char* block = static_cast<char*>(pointer) - kBlockHeader;
+    g_live_allocations.fetch_sub(1, std::memory_order_relaxed);
+    g_live_bytes.fetch_sub(static_cast<int64_t>(*reinterpret_cast<std::size_t*>(block)),
+                           std::memory_order_relaxed);
+    std::free(block);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    operator delete(pointer);
+}
+
+namespace {
+
+// 2026-01-01T00:00:00Z.
+constexpr int64_t kStartUs = 1767225600LL * 1000000;
+
+struct Checkpoint {
+    int day = 0;
+    int64_t live_allocations = 0;
+    int64_t live_bytes = 0;
+    uint64_t resident_bytes = 0;
+    uint64_t sessions = 0;
+    size_t titles = 0;
+};
+
+bool ParseFlag(const char* arg, const char* name, std::string* value) {
+    size_t length = std::strlen(name);
+    if (std::strncmp(arg, name, length) != 0 || arg[length] != '=') return false;
+    *value = arg + length + 1;
+    return true;
+}
+
+Checkpoint Measure(int day, const FocusStore& store) {
+    Checkpoint checkpoint;
+    checkpoint.day = day;
+    checkpoint.live_allocations = g_live_allocations.load(std::memory_order_relaxed);
+    checkpoint.live_bytes = g_live_bytes.load(std::memory_order_relaxed);
+    ProcessMemory memory;
+    if (app_focus_tracker::QueryProcessMemory(&memory)) checkpoint.resident_bytes = memory.resident_bytes;
+    checkpoint.sessions = store.aggregates().session_count();
+    checkpoint.titles = store.titles().size();
+    return checkpoint;
+}
+
+void PrintText(const Checkpoint& checkpoint) {
+    std::printf("day %4d  %10llu sessions %8zu titles  live %9lld allocations %9.2fMB  rss %8.2fMB\n",
+                checkpoint.day, static_cast<unsigned long long>(checkpoint.sessions), checkpoint.titles,
+                static_cast<long long>(checkpoint.live_allocations), checkpoint.live_bytes / (1024.0 * 1024.0),
+                checkpoint.resident_bytes / (1024.0 * 1024.0));
+}
+
+void PrintJson(const Checkpoint& checkpoint, bool last) {
+    std::printf("    {\"day\": %d, \"sessions\": %llu, \"titles\": %zu, \"live_allocations\": %lld, "
+                "\"live_bytes\": %lld, \"resident_bytes\": %llu}%s\n",
+                checkpoint.day, static_cast<unsigned long long>(checkpoint.sessions), checkpoint.titles,
+                static_cast<long long>(checkpoint.live_allocations), static_cast<long long>(checkpoint.live_bytes),
+                static_cast<unsigned long long>(checkpoint.resident_bytes), last ? "" : ",");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    WorkloadProfile profile;
+    app_focus_tracker::FindWorkloadProfile("typical", &profile);
+    int days = 180;
+    int interval_ms = 5000;
+    int rollup_days = 90;
+    int warmup_days = -1;
+    int64_t tolerance_kb = 256;
+    std::string directory = (std::filesystem::temp_directory_path() / "aft_focus_soak").string();
+    bool json = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string value;
+        if (ParseFlag(argv[i], "--days", &value)) {
+            days = std::atoi(value.c_str());
+        } else if (ParseFlag(argv[i], "--interval-ms", &value)) {
+            interval_ms = std::atoi(value.c_str());
+        } else if (ParseFlag(argv[i], "--rollup-days", &value)) {
+            rollup_days = std::atoi(value.c_str());
+        } else if (ParseFlag(argv[i], "--warmup-days", &value)) {
+            warmup_days = std::atoi(value.c_str());
+        } else if (ParseFlag(argv[i], "--tolerance-kb", &value)) {
+            tolerance_kb = std::atoll(value.c_str());
+        } else if (ParseFlag(argv[i], "--seed", &value)) {
+            profile.seed = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (ParseFlag(argv[i], "--dir", &value)) {
+            directory = value;
+        } else if (std::strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (!app_focus_tracker::FindWorkloadProfile(argv[i], &profile)) {
+            std::fprintf(stderr, "unknown profile or flag: %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (warmup_days < 0) warmup_days = rollup_days;
+    if (days <= warmup_days || interval_ms <= 0 || rollup_days <= 0) {
+        std::fprintf(stderr, "--days must exceed --warmup-days, and intervals and rollups must be positive\n");
+        return 2;
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(directory, ec);
+    std::vector<Checkpoint> checkpoints;
+    bool stored = true;
+    auto started = std::chrono::steady_clock::now();
+    {
+        FocusStore store;
+        FocusStore::Options store_options;
+        store_options.aggregates.rollup_days = static_cast<size_t>(rollup_days);
+        if (!store.Open(directory, store_options)) {
+            std::fprintf(stderr, "could not open a store in %s\n", directory.c_str());
+            return 2;
+        }
+        app_focus_tracker::VirtualClock clock(kStartUs);
+        app_focus_tracker::ScheduleOptions schedule =
+            app_focus_tracker::ScheduleOptions::Fixed(std::chrono::milliseconds(interval_ms));
+        schedule.clock = &clock;
+        FocusSampler sampler(std::make_unique<app_focus_tracker::SyntheticFocusSource>(profile), schedule);
+        app_focus_tracker::SubscriptionOptions options;
+        options.granularity = app_focus_tracker::Granularity::kSpans;
+        // Runs on the sampling thread, which is waiting on the clock
+        // whenever the main thread looks at the store.
+        auto id = sampler.Subscribe(options, [&store, &stored](const FocusSpan* spans, size_t count) {
+            app_focus_tracker::EncodeSpans(spans, count, app_focus_tracker::Granularity::kSpans,
+                                           app_focus_tracker::kAllFields);
+            for (size_t i = 0; i < count; ++i) {
+                stored &= store.Append(spans[i].app_name, spans[i].title, spans[i].start_us, spans[i].end_us);
+            }
+        });
+        for (int day = 1; day <= days; ++day) {
+            clock.RunFor(std::chrono::hours(24));
+            checkpoints.push_back(Measure(day, store));
+        }
+        sampler.Unsubscribe(id);
+        store.Close();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::filesystem::remove_all(directory, ec);
+
+    // Compare the rest of the run with the day the rollups filled up.
+    const Checkpoint& settled = checkpoints[warmup_days > 0 ? warmup_days - 1 : 0];
+    Checkpoint peak = settled;
+    for (size_t i = static_cast<size_t>(warmup_days); i < checkpoints.size(); ++i) {
+        peak.live_bytes = std::max(peak.live_bytes, checkpoints[i].live_bytes);
+        peak.live_allocations = std::max(peak.live_allocations, checkpoints[i].live_allocations);
+    }
+    int64_t byte_growth = peak.live_bytes - settled.live_bytes;
+    int64_t allocation_growth = peak.live_allocations - settled.live_allocations;
+    bool bounded = byte_growth <= tolerance_kb * 1024 + settled.live_bytes / 50 &&
+                   allocation_growth <= settled.live_allocations / 50 + 64;
+
+    if (json) {
+        std::printf("{\"profile\": \"%s\", \"days\": %d, \"seconds\": %.3f, \"stored\": %s, "
+                    "\"live_byte_growth\": %lld, \"live_allocation_growth\": %lld, \"bounded\": %s,\n"
+                    "  \"checkpoints\": [\n",
+                    profile.name.c_str(), days, seconds, stored ? "true" : "false",
+                    static_cast<long long>(byte_growth), static_cast<long long>(allocation_growth),
+                    bounded ? "true" : "false");
+        for (size_t i = 0; i < checkpoints.size(); ++i) PrintJson(checkpoints[i], i + 1 == checkpoints.size());
+        std::printf("  ]}\n");
+    } else {
+        for (const Checkpoint& checkpoint : checkpoints) {
+            if (checkpoint.day % 7 == 0 || checkpoint.day == warmup_days || checkpoint.day == days) {
+                PrintText(checkpoint);
+            }
+        }
+        std::printf("%s: %d days in %.1fs; after day %d live heap grew %+lld bytes, %+lld allocations%s\n",
+                    profile.name.c_str(), days, seconds, warmup_days, static_cast<long long>(byte_growth),
+                    static_cast<long long>(allocation_growth), bounded ? "" : "  UNBOUNDED");
+    }
+    if (!stored) {
+        std::fprintf(stderr, "the store rejected sessions\n");
+        return 2;
+    }
+    return bounded ? 0 : 1;
+}
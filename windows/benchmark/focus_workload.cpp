@@ -0,0 +1,126 @@
+// Runs synthetic workloads through the sampling pipeline and reports
+// throughput, latency and memory for each, e.g.
+//
+//   focus_workload                      every stock profile
+//   focus_workload switch_storm --samples=1000000 --json
+//   focus_workload flapping --trace=flapping.trace
+//
+// --seed changes the generator seed. --trace also records the profile's
+// samples to a trace that TraceReplaySource can play back. Exits with 1 if
+// a profile misses its target rate.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "focus_trace.h"
+#include "synthetic_workload.h"
+
+namespace {
+
+using app_focus_tracker::FocusSample;
+using app_focus_tracker::FocusTraceWriter;
+using app_focus_tracker::SyntheticFocusSource;
+using app_focus_tracker::WorkloadProfile;
+using app_focus_tracker::WorkloadReport;
+
+bool ParseFlag(const char* arg, const char* name, std::string* value) {
+    size_t length = std::strlen(name);
+    if (std::strncmp(arg, name, length) != 0 || arg[length] != '=') return false;
+    *value = arg + length + 1;
+    return true;
+}
+
+bool WriteTrace(const WorkloadProfile& profile, uint64_t samples, const std::string& path) {
+    FocusTraceWriter writer;
+    if (!writer.Open(path)) return false;
+    SyntheticFocusSource source(profile);
+    FocusSample sample;
+    for (uint64_t i = 0; i < samples; ++i) {
+        sample.timestamp_us = static_cast<int64_t>(i) * 1000;
+        sample.interval_us = 1000;
+        source.Sample(&sample);
+        writer.Append(sample);
+    }
+    return writer.Close();
+}
+
+void PrintText(const WorkloadReport& report) {
+    std::printf("%-14s %10llu samples %9.0f/s %9.0f switches/s  p50 %7.1fus  p99 %7.1fus  max %8.1fus  rss %+8.1fMB%s\n",
+                report.profile.c_str(), static_cast<unsigned long long>(report.samples),
+                report.samples_per_second, report.switches_per_second, report.latency_p50_ns / 1000.0,
+                report.latency_p99_ns / 1000.0, report.latency_max_ns / 1000.0,
+                report.resident_growth_bytes / (1024.0 * 1024.0), report.met_target ? "" : "  MISSED TARGET");
+}
+
+void PrintJson(const WorkloadReport& report, bool last) {
+    std::printf("  {\"profile\": \"%s\", \"samples\": %llu, \"switches\": %llu, \"spans\": %llu, "
+                "\"seconds\": %.6f, \"samples_per_second\": %.1f, \"switches_per_second\": %.1f, "
+                "\"met_target\": %s, \"latency_p50_ns\": %lld, \"latency_p99_ns\": %lld, "
+                "\"latency_max_ns\": %lld, \"resident_growth_bytes\": %lld, \"peak_resident_bytes\": %llu}%s\n",
+                report.profile.c_str(), static_cast<unsigned long long>(report.samples),
+                static_cast<unsigned long long>(report.switches), static_cast<unsigned long long>(report.spans),
+                report.seconds, report.samples_per_second, report.switches_per_second,
+                report.met_target ? "true" : "false", static_cast<long long>(report.latency_p50_ns),
+                static_cast<long long>(report.latency_p99_ns), static_cast<long long>(report.latency_max_ns),
+                static_cast<long long>(report.resident_growth_bytes),
+                static_cast<unsigned long long>(report.peak_resident_bytes), last ? "" : ",");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::vector<WorkloadProfile> profiles;
+    uint64_t samples = 200000;
+    std::string seed;
+    std::string trace;
+    bool json = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string value;
+        if (ParseFlag(argv[i], "--samples", &value)) {
+            samples = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (ParseFlag(argv[i], "--seed", &value)) {
+            seed = value;
+        } else if (ParseFlag(argv[i], "--trace", &value)) {
+            trace = value;
+        } else if (std::strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else {
+            WorkloadProfile profile;
+            if (!app_focus_tracker::FindWorkloadProfile(argv[i], &profile)) {
+                std::fprintf(stderr, "unknown profile or flag: %s\n", argv[i]);
+                return 2;
+            }
+            profiles.push_back(profile);
+        }
+    }
+    if (profiles.empty()) profiles = app_focus_tracker::WorkloadProfiles();
+    if (!seed.empty()) {
+        for (WorkloadProfile& profile : profiles) profile.seed = std::strtoull(seed.c_str(), nullptr, 10);
+    }
+    if (!trace.empty() && profiles.size() != 1) {
+        std::fprintf(stderr, "--trace records a single profile\n");
+        return 2;
+    }
+
+    bool met_targets = true;
+    if (json) std::printf("[\n");
+    for (size_t i = 0; i < profiles.size(); ++i) {
+        WorkloadReport report = app_focus_tracker::RunWorkload(profiles[i], samples);
+        met_targets &= report.met_target;
+        if (json) {
+            PrintJson(report, i + 1 == profiles.size());
+        } else {
+            PrintText(report);
+        }
+        std::fflush(stdout);
+    }
+    if (json) std::printf("]\n");
+    if (!trace.empty() && !WriteTrace(profiles[0], samples, trace)) {
+        std::fprintf(stderr, "could not write %s\n", trace.c_str());
+        return 2;
+    }
+    return met_targets ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+// Per-stage costs of the tracking pipeline, driven by fake sources so they
+// run anywhere: title capture and transcoding, change detection, event
+// encoding, the hand-off to the platform thread and aggregation. Build with
+// ../host and run the benchmark_json target for machine-readable results.
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "event_encoding.h"
+#include "focus_aggregates.h"
+#include "focus_journal.h"
+#include "queue_dispatcher.h"
+#include "sessionizer.h"
+#include "string_dictionary.h"
+#include "text_encoding.h"
+#include "title_fetcher.h"
+
+namespace app_focus_tracker {
+namespace {
+
+constexpr int64_t kSecondUs = 1000000;
+
+// Answers title lookups at once, as a responsive window would.
+class FakeTitleSource : public FocusSource {
+public:
+    bool Sample(FocusSample* sample) override {
+        sample->window_id = 1;
+        return true;
+    }
+    bool slow_titles() const override { return true; }
+    bool FetchTitle(const FocusSample& sample, std::string* title) override {
+        *title = "Document " + std::to_string(sample.window_id) + " - Editor";
+        return true;
+    }
+};
+
+FocusSpan MakeSpan(int i) {
+    FocusSpan span;
+    span.start_us = 1700000000 * kSecondUs + i * 10 * kSecondUs;
+    span.end_us = span.start_us + 7 * kSecondUs;
+    span.window_id = 0x10000 + i % 16;
+    span.process_id = 4000 + i % 8;
+    span.app_name = "app" + std::to_string(i % 8) + ".exe";
+    span.title = "Quarterly report (" + std::to_string(i % 32) + ").docx - Word";
+    return span;
+}
+
+void BM_TitleTranscode(benchmark::State& state) {
+    // Mostly ASCII with some accented and CJK text, like real titles.
+    std::u16string title;
+    while (title.size() < static_cast<size_t>(state.range(0))) title += u"Résumé 日本 - Notepad ";
+    title.resize(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Utf16ToUtf8(title.data(), title.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(char16_t));
+}
+BENCHMARK(BM_TitleTranscode)->Arg(32)->Arg(256);
+
+// Round trip through the title helper thread.
+void BM_TitleFetch(benchmark::State& state) {
+    TitleFetcher fetcher(std::make_shared<FakeTitleSource>(), std::chrono::milliseconds(200));
+    FocusSample sample;
+    for (auto _ : state) {
+        sample.window_id = sample.window_id % 8 + 1;
+        benchmark::DoNotOptimize(fetcher.Fetch(sample));
+    }
+}
+BENCHMARK(BM_TitleFetch)->UseRealTime();
+
+// Argument 1 makes every sample a focus change.
+void BM_ChangeDetection(benchmark::State& state) {
+    bool switching = state.range(0) != 0;
+    std::vector<FocusSample> samples(64);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        FocusSpan span = MakeSpan(switching ? static_cast<int>(i) : 0);
+        samples[i].timestamp_us = span.start_us + static_cast<int64_t>(i) * kSecondUs;
+        samples[i].window_id = span.window_id;
+        samples[i].app_name = span.app_name;
+        samples[i].title = span.title;
+    }
+    Sessionizer sessionizer;
+    FocusSpan closed;
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sessionizer.Push(samples[i++ % samples.size()], &closed));
+    }
+}
+BENCHMARK(BM_ChangeDetection)->ArgName("switching")->Arg(0)->Arg(1);
+
+// The EncodableMap events the plugin sends today.
+void BM_EncodeMap(benchmark::State& state) {
+    std::vector<FocusSpan> spans;
+    for (int i = 0; i < state.range(0); ++i) spans.push_back(MakeSpan(i));
+    Granularity granularity = spans.size() == 1 ? Granularity::kSpans : Granularity::kBatched;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(EncodeSpans(spans.data(), spans.size(), granularity, kAllFields));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EncodeMap)->ArgName("spans")->Arg(1)->Arg(100);
+
+// The same spans as journal session records, with names sent once through
+// a dictionary, as a compact binary alternative.
+void BM_EncodeBinary(benchmark::State& state) {
+    std::vector<FocusSpan> spans;
+    for (int i = 0; i < state.range(0); ++i) spans.push_back(MakeSpan(i));
+    StringDictionary apps;
+    StringDictionary titles;
+    JournalRecord record;
+    std::string out;
+    for (auto _ : state) {
+        out.clear();
+        for (const FocusSpan& span : spans) {
+            record.session.start_us = span.start_us;
+            record.session.end_us = span.end_us;
+            record.session.app_id = apps.Intern(span.app_name);
+            record.session.title_id = titles.Intern(span.title);
+            EncodeJournalRecord(record, &out);
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["bytes_per_span"] = static_cast<double>(out.size()) / spans.size();
+}
+BENCHMARK(BM_EncodeBinary)->ArgName("spans")->Arg(1)->Arg(100);
+
+// Encoded events posted from the sampling thread and pumped by a stand-in
+// platform thread, as OnListenInternal does.
+void BM_Queueing(benchmark::State& state) {
+    QueueDispatcher dispatcher;
+    std::atomic<bool> stop{false};
+    std::atomic<int64_t> delivered{0};
+    std::thread platform([&] {
+        while (!stop.load()) dispatcher.WaitAndRun(std::chrono::milliseconds(10));
+        dispatcher.RunPending();
+    });
+    auto event = std::make_shared<flutter::EncodableValue>(EncodeSpan(MakeSpan(0), kAllFields));
+    for (auto _ : state) {
+        dispatcher.Post([event, &delivered] {
+            benchmark::DoNotOptimize(event.get());
+            delivered.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+    stop = true;
+    platform.join();
+    state.SetItemsProcessed(delivered.load());
+}
+BENCHMARK(BM_Queueing)->UseRealTime();
+
+void BM_Aggregation(benchmark::State& state) {
+    std::vector<FocusSession> sessions(1024);
+    for (size_t i = 0; i < sessions.size(); ++i) {
+        FocusSpan span = MakeSpan(static_cast<int>(i));
+        // Spread over a few weeks so daily rollups see many days.
+        sessions[i].start_us = span.start_us + static_cast<int64_t>(i) * 3600 * kSecondUs;
+        sessions[i].end_us = sessions[i].start_us + span.duration_us();
+        sessions[i].app_id = static_cast<uint32_t>(i % 40);
+        sessions[i].title_id = static_cast<uint32_t>(i);
+    }
+    FocusAggregates aggregates;
+    size_t i = 0;
+    for (auto _ : state) {
+        aggregates.Apply(sessions[i++ % sessions.size()]);
+    }
+    benchmark::DoNotOptimize(aggregates.total_focus_us());
+}
+BENCHMARK(BM_Aggregation);
+
+}  // namespace
+}  // namespace app_focus_tracker
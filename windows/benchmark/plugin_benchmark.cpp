@@ -0,0 +1,108 @@
+// Drives AppFocusTrackerPlugin end to end through the host embedder
+// stand-ins: "listen" and "cancel" arrive as encoded method calls on a
+// FakeBinaryMessenger, events travel through the sampler, the encoder, the
+// platform-thread queue and the standard codec, and the messenger records
+// what was sent.
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "app_focus_tracker_plugin.h"
+#include "fake_binary_messenger.h"
+#include "queue_dispatcher.h"
+
+namespace app_focus_tracker {
+namespace {
+
+using std::chrono::milliseconds;
+
+constexpr char kEvents[] = "app_focus_tracker";
+
+class SwitchingSource : public FocusSource {
+public:
+    bool Sample(FocusSample* sample) override {
+        ++n_;
+        sample->window_id = n_;
+        sample->process_id = 4242;
+        sample->app_name = "app" + std::to_string(n_ % 16) + ".exe";
+        sample->title = "Quarterly report - Word";
+        return true;
+    }
+
+private:
+    uint64_t n_ = 0;
+};
+
+struct Harness {
+    explicit Harness(milliseconds interval)
+        : sampler(std::make_shared<FocusSampler>(std::make_unique<SwitchingSource>(), interval)) {
+        auto queue = std::make_unique<QueueDispatcher>();
+        dispatcher = queue.get();
+        plugin = std::make_unique<AppFocusTrackerPlugin>(sampler, std::move(queue));
+        plugin->ConnectChannels(&messenger);
+    }
+
+    void Listen(const char* granularity) {
+        flutter::EncodableMap arguments;
+        arguments[flutter::EncodableValue("granularity")] = flutter::EncodableValue(granularity);
+        messenger.Call(kEvents, "listen", flutter::EncodableValue(arguments));
+    }
+
+    // Runs the platform thread's queue until |count| events were sent.
+    void PumpUntilSent(size_t count) {
+        while (messenger.sent_count() < count) dispatcher->WaitAndRun(milliseconds(10));
+    }
+
+    FakeBinaryMessenger messenger;
+    QueueDispatcher* dispatcher = nullptr;
+    std::shared_ptr<FocusSampler> sampler;
+    std::unique_ptr<AppFocusTrackerPlugin> plugin;
+};
+
+// Events per second reaching the messenger while sampling as fast as the
+// scheduler allows (1 ms), with focus moving on every sample.
+void BM_PluginThroughput(benchmark::State& state) {
+    Harness harness(milliseconds(1));
+    harness.Listen(state.range(0) == 0 ? "raw" : "spans");
+    size_t sent = 0;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        harness.PumpUntilSent(1);
+        for (const auto& message : harness.messenger.Take()) {
+            ++sent;
+            bytes += message.bytes.size();
+        }
+    }
+    harness.messenger.Call(kEvents, "cancel");
+    state.SetItemsProcessed(static_cast<int64_t>(sent));
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_PluginThroughput)->ArgName("spans")->Arg(0)->Arg(1)->UseRealTime()->MinTime(0.5);
+
+// Time for "cancel" to return while events flow, which includes stopping
+// the sampling thread. It should not depend on the sampling interval.
+void BM_PluginStopLatency(benchmark::State& state) {
+    Harness harness(milliseconds(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        harness.Listen("raw");
+        harness.PumpUntilSent(1);
+        harness.messenger.Take();
+        state.ResumeTiming();
+        harness.messenger.Call(kEvents, "cancel");
+    }
+}
+BENCHMARK(BM_PluginStopLatency)
+    ->ArgName("interval_ms")
+    ->Arg(1)
+    ->Arg(1000)
+    ->UseRealTime()
+    ->Iterations(50)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace app_focus_tracker
@@ -0,0 +1,75 @@
+// Whole-pipeline throughput on simulated time: a month of one-second
+// sampling through the shared sampler, span subscribers and budgets, run on
+// a VirtualClock so it takes as long as the work and nothing else.
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "focus_sampler.h"
+#include "virtual_clock.h"
+
+namespace app_focus_tracker {
+namespace {
+
+// 2026-01-01T00:00:00Z.
+constexpr int64_t kStartUs = 1767225600LL * 1000000;
+
+// A new window every |period| samples, cycling through 16 apps.
+class CyclingSource : public FocusSource {
+public:
+    explicit CyclingSource(int64_t period) : period_(period) {}
+    bool Sample(FocusSample* sample) override {
+        int64_t window = n_++ / period_;
+        sample->window_id = static_cast<uint64_t>(window);
+        sample->process_id = static_cast<uint32_t>(1000 + window % 16);
+        sample->app_name = "app" + std::to_string(window % 16) + ".exe";
+        sample->title = "Document " + std::to_string(window % 64);
+        return true;
+    }
+    int64_t samples() const { return n_; }
+
+private:
+    int64_t period_;
+    int64_t n_ = 0;
+};
+
+void BM_SimulatedMonth(benchmark::State& state) {
+    int64_t samples = 0;
+    int64_t spans = 0;
+    for (auto _ : state) {
+        VirtualClock clock(kStartUs);
+        ScheduleOptions schedule = ScheduleOptions::Fixed(std::chrono::seconds(1));
+        schedule.clock = &clock;
+        auto source = std::make_unique<CyclingSource>(state.range(0));
+        CyclingSource* counter = source.get();
+        FocusSampler sampler(std::move(source), schedule);
+        SubscriptionOptions options;
+        options.granularity = Granularity::kSpans;
+        auto id = sampler.Subscribe(options, [&spans](const FocusSpan*, size_t count) {
+            spans += static_cast<int64_t>(count);
+        });
+        BudgetRule rule;
+        rule.apps = {"app0.exe", "app1.exe"};
+        rule.limit_us = 3600LL * 1000000;
+        sampler.AddBudget(rule, [](const BudgetAlert&) {});
+
+        clock.RunFor(std::chrono::hours(24 * 30));
+        sampler.Unsubscribe(id);
+        samples += counter->samples();
+    }
+    state.SetItemsProcessed(samples);
+    state.counters["spans"] = benchmark::Counter(static_cast<double>(spans), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_SimulatedMonth)
+    ->ArgName("switch_every")
+    ->Arg(1)
+    ->Arg(60)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime()
+    ->Iterations(1);
+
+}  // namespace
+}  // namespace app_focus_tracker
@@ -0,0 +1,57 @@
+// Measures how late a foreground thread wakes from a 1 ms sleep while every
+// CPU is kept busy by threads running at a given ThreadPriority. Background
+// work at kNormal competes with the foreground thread for its time slice;
+// at kIdle the foreground thread should wake almost on time.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "thread_qos.h"
+
+namespace app_focus_tracker {
+namespace {
+
+using std::chrono::steady_clock;
+
+void BM_ForegroundWakeLatency(benchmark::State& state) {
+    ThreadQos qos;
+    qos.priority = static_cast<ThreadPriority>(state.range(0));
+
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> hogs;
+    unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < cpus; ++i) {
+        hogs.emplace_back([&] {
+            ApplyThreadQos(qos);
+            while (!stop.load(std::memory_order_relaxed)) {
+            }
+        });
+    }
+
+    const auto sleep = std::chrono::milliseconds(1);
+    for (auto _ : state) {
+        auto start = steady_clock::now();
+        std::this_thread::sleep_for(sleep);
+        auto late = steady_clock::now() - start - sleep;
+        state.SetIterationTime(std::chrono::duration<double>(late).count());
+    }
+
+    stop = true;
+    for (std::thread& hog : hogs) hog.join();
+}
+BENCHMARK(BM_ForegroundWakeLatency)
+    ->ArgName("priority")
+    ->Arg(static_cast<int>(ThreadPriority::kNormal))
+    ->Arg(static_cast<int>(ThreadPriority::kBackground))
+    ->Arg(static_cast<int>(ThreadPriority::kIdle))
+    ->UseManualTime()
+    ->Iterations(200)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace app_focus_tracker
@@ -0,0 +1,102 @@
+// Capture and replay of focus traces: the cost of recording each sample,
+// of loading a trace, and of pushing one back through the sampler on a
+// VirtualClock as fast as the pipeline allows.
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "focus_sampler.h"
+#include "focus_trace.h"
+#include "virtual_clock.h"
+
+namespace app_focus_tracker {
+namespace {
+
+// 2026-01-01T00:00:00Z.
+constexpr int64_t kStartUs = 1767225600LL * 1000000;
+constexpr int64_t kSecondUs = 1000000;
+
+std::string TracePath() {
+    return (std::filesystem::temp_directory_path() / "aft_trace_benchmark.trace").string();
+}
+
+// One-second samples with a switch every |period|, across 16 apps and 256
+// titles.
+std::vector<FocusSample> MakeTrace(int64_t count, int64_t period) {
+    std::vector<FocusSample> trace(count);
+    for (int64_t i = 0; i < count; ++i) {
+        int64_t window = i / period;
+        FocusSample& sample = trace[i];
+        sample.timestamp_us = kStartUs + i * kSecondUs;
+        sample.interval_us = kSecondUs;
+        sample.window_id = 0x10000 + window;
+        sample.process_id = static_cast<uint32_t>(4000 + window % 16);
+        sample.app_name = "app" + std::to_string(window % 16) + ".exe";
+        sample.title = "Quarterly report (" + std::to_string(window % 256) + ").docx - Word";
+    }
+    return trace;
+}
+
+void BM_TraceCapture(benchmark::State& state) {
+    std::vector<FocusSample> trace = MakeTrace(4096, state.range(0));
+    FocusTraceWriter writer;
+    writer.Open(TracePath());
+    size_t i = 0;
+    for (auto _ : state) {
+        writer.Append(trace[i++ % trace.size()]);
+    }
+    writer.Close();
+    state.SetItemsProcessed(state.iterations());
+    state.counters["bytes_per_sample"] = static_cast<double>(writer.bytes()) / writer.samples();
+}
+BENCHMARK(BM_TraceCapture)->ArgName("switch_every")->Arg(1)->Arg(60);
+
+void BM_TraceLoad(benchmark::State& state) {
+    std::vector<FocusSample> trace = MakeTrace(state.range(0), 60);
+    FocusTraceWriter writer;
+    writer.Open(TracePath());
+    for (const FocusSample& sample : trace) writer.Append(sample);
+    writer.Close();
+    std::vector<FocusSample> loaded;
+    for (auto _ : state) {
+        ReadFocusTrace(TracePath(), &loaded);
+        benchmark::DoNotOptimize(loaded.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TraceLoad)->ArgName("samples")->Arg(86400);
+
+// A day of samples through the sampler and a span subscriber.
+void BM_TraceReplay(benchmark::State& state) {
+    std::vector<FocusSample> trace = MakeTrace(86400, state.range(0));
+    int64_t replayed = 0;
+    for (auto _ : state) {
+        VirtualClock clock(kStartUs);
+        ScheduleOptions schedule = ScheduleOptions::Fixed(std::chrono::seconds(1));
+        schedule.clock = &clock;
+        auto source = std::make_unique<TraceReplaySource>(trace, TraceReplaySource::Speed::kAsFastAsPossible);
+        TraceReplaySource* replay = source.get();
+        FocusSampler sampler(std::move(source), schedule);
+        SubscriptionOptions options;
+        options.granularity = Granularity::kSpans;
+        auto id = sampler.Subscribe(options, [](const FocusSpan* spans, size_t) { benchmark::DoNotOptimize(spans); });
+        clock.RunFor(std::chrono::seconds(trace.size()));
+        sampler.Unsubscribe(id);
+        replayed += static_cast<int64_t>(replay->replayed());
+    }
+    state.SetItemsProcessed(replayed);
+}
+BENCHMARK(BM_TraceReplay)
+    ->ArgName("switch_every")
+    ->Arg(1)
+    ->Arg(60)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace app_focus_tracker
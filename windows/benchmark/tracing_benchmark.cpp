@@ -0,0 +1,61 @@
+// Pipeline tracing overhead: a TracingScope with tracing off, one recorded
+// with tracing on, and dumping a full buffer in either format.
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <string>
+
+#include "pipeline_tracing.h"
+
+namespace app_focus_tracker {
+namespace {
+
+void BM_TracingScopeDisabled(benchmark::State& state) {
+    PipelineTracing::Stop();
+    for (auto _ : state) {
+        TracingScope scope("disabled");
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TracingScopeDisabled);
+
+void BM_TracingScopeEnabled(benchmark::State& state) {
+    constexpr size_t kBatch = PipelineTracing::kThreadCapacity / 2;
+    for (auto _ : state) {
+        // Start over before the buffer fills, so every span is kept.
+        state.PauseTiming();
+        PipelineTracing::Start();
+        state.ResumeTiming();
+        for (size_t i = 0; i < kBatch; ++i) {
+            TracingScope scope("enabled");
+            benchmark::ClobberMemory();
+        }
+    }
+    PipelineTracing::Stop();
+    state.SetItemsProcessed(state.iterations() * kBatch);
+    state.counters["dropped"] = static_cast<double>(PipelineTracing::dropped());
+}
+BENCHMARK(BM_TracingScopeEnabled);
+
+void BM_TracingDump(benchmark::State& state) {
+    bool perfetto = state.range(0) != 0;
+    PipelineTracing::Start();
+    for (size_t i = 0; i < PipelineTracing::kThreadCapacity; ++i) {
+        TracingScope scope("span");
+    }
+    PipelineTracing::Stop();
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::string trace = perfetto ? PipelineTracing::PerfettoProto() : PipelineTracing::ChromeJson();
+        bytes = trace.size();
+        benchmark::DoNotOptimize(trace.data());
+    }
+    state.SetItemsProcessed(state.iterations() * PipelineTracing::kThreadCapacity);
+    state.counters["bytes_per_span"] = static_cast<double>(bytes) / PipelineTracing::kThreadCapacity;
+}
+BENCHMARK(BM_TracingDump)->ArgName("perfetto")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace app_focus_tracker
@@ -0,0 +1,37 @@
+// The stock synthetic workloads through the whole sampling pipeline, one
+// benchmark per profile. focus_workload reports the same runs with
+// latency percentiles and memory.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "synthetic_workload.h"
+
+namespace app_focus_tracker {
+namespace {
+
+void BM_Workload(benchmark::State& state, const WorkloadProfile& profile) {
+    WorkloadReport report;
+    uint64_t samples = 0;
+    for (auto _ : state) {
+        report = RunWorkload(profile, 50000);
+        samples += report.samples;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(samples));
+    state.counters["switches_per_second"] = report.switches_per_second;
+    state.counters["p99_us"] = report.latency_p99_ns / 1000.0;
+}
+
+int RegisterWorkloads() {
+    for (const WorkloadProfile& profile : WorkloadProfiles()) {
+        benchmark::RegisterBenchmark(("BM_Workload/" + profile.name).c_str(), BM_Workload, profile)
+            ->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
+    }
+    return 0;
+}
+const int kRegistered = RegisterWorkloads();
+
+}  // namespace
+}  // namespace app_focus_tracker
@@ -0,0 +1,153 @@
+#ifndef FLUTTER_PLUGIN_BINARY_IO_H_
+#define FLUTTER_PLUGIN_BINARY_IO_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace app_focus_tracker {
+
+// Little-endian encoders shared by the journal, snapshots and trace files.
+inline void PutU8(std::string& out, uint8_t value) {
+    out.push_back(static_cast<char>(value));
+}
+
+inline void PutU32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+inline void PutU64(std::string& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+inline void PutI64(std::string& out, int64_t value) {
+    PutU64(out, static_cast<uint64_t>(value));
+}
+
+inline void PutString(std::string& out, const std::string& value) {
+    PutU32(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+// LEB128 variable-length integer, used for delta-compressed posting lists.
+inline void PutVarU64(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+inline uint32_t LoadU32(const uint8_t* data) {
+    return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+           (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+// Bounds-checked decoder. Once a read fails every later read fails too, so
+// callers can decode a whole structure and check ok() once at the end.
+class ByteReader {
+public:
+    ByteReader(const void* data, size_t size)
+        : data_(static_cast<const uint8_t*>(data)), size_(size) {}
+
+    bool ReadU8(uint8_t* value) {
+        if (!Require(1)) return false;
+        *value = data_[pos_++];
+        return true;
+    }
+
+    bool ReadU32(uint32_t* value) {
+        if (!Require(4)) return false;
+        *value = LoadU32(data_ + pos_);
+        pos_ += 4;
+        return true;
+    }
+
+    bool ReadU64(uint64_t* value) {
+        if (!Require(8)) return false;
+        uint64_t result = 0;
+        for (int i = 0; i < 8; ++i) {
+            result |= static_cast<uint64_t>(data_[pos_ + i]) << (8 * i);
+        }
+        *value = result;
+        pos_ += 8;
+        return true;
+    }
+
+    bool ReadI64(int64_t* value) {
+        uint64_t raw = 0;
+        if (!ReadU64(&raw)) return false;
+        *value = static_cast<int64_t>(raw);
+        return true;
+    }
+
+    bool ReadVarU64(uint64_t* value) {
+        uint64_t result = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = 0;
+            if (!ReadU8(&byte)) return false;
+            result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                *value = result;
+                return true;
+            }
+        }
+        ok_ = false;
+        return false;
+    }
+
+    bool ReadString(std::string* value) {
+        uint32_t length = 0;
+        if (!ReadU32(&length) || !Require(length)) return false;
+        value->assign(reinterpret_cast<const char*>(data_ + pos_), length);
+        pos_ += length;
+        return true;
+    }
+
+    bool ok() const { return ok_; }
+    size_t position() const { return pos_; }
+    size_t remaining() const { return size_ - pos_; }
+
+private:
+    bool Require(size_t count) {
+        if (!ok_ || size_ - pos_ < count) {
+            ok_ = false;
+            return false;
+        }
+        return true;
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+    bool ok_ = true;
+};
+
+// CRC-32 (IEEE 802.3), used to detect torn or corrupted records.
+inline uint32_t Crc32(const void* data, size_t size, uint32_t crc = 0) {
+    static const auto table = [] {
+        struct Table { uint32_t entries[256]; } t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t.entries[i] = c;
+        }
+        return t;
+    }();
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table.entries[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_BINARY_IO_H_
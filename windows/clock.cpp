@@ -0,0 +1,37 @@
+#include "clock.h"
+
+namespace app_focus_tracker {
+
+namespace {
+
+class SystemClock : public Clock {
+public:
+    SteadyTime SteadyNow() override { return std::chrono::steady_clock::now(); }
+    std::chrono::system_clock::time_point WallNow() override { return std::chrono::system_clock::now(); }
+    bool WaitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& cv, SteadyTime deadline,
+                   const std::function<bool()>& done) override {
+        if (deadline == SteadyTime::max()) {
+            cv.wait(lock, done);
+            return true;
+        }
+        return cv.wait_until(lock, deadline, done);
+    }
+};
+
+}  // namespace
+
+Clock* Clock::System() {
+    static SystemClock clock;
+    return &clock;
+}
+
+int64_t MonotonicToWallUs(int64_t monotonic_ns) {
+    // Taken once, so stamps stay consistent with each other even if the
+    // wall clock is adjusted later.
+    static const int64_t offset_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                                         std::chrono::system_clock::now().time_since_epoch()).count() -
+                                     MonotonicNowNs() / 1000;
+    return monotonic_ns / 1000 + offset_us;
+}
+
+}  // namespace app_focus_tracker
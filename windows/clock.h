@@ -0,0 +1,54 @@
+#ifndef FLUTTER_PLUGIN_CLOCK_H_
+#define FLUTTER_PLUGIN_CLOCK_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace app_focus_tracker {
+
+// Time source and sleeping primitive for the sampling thread. The system
+// clock is used in production; VirtualClock lets tests and benchmarks run
+// days of sampling in moments.
+class Clock {
+public:
+    using SteadyTime = std::chrono::steady_clock::time_point;
+
+    virtual ~Clock() = default;
+
+    virtual SteadyTime SteadyNow() = 0;
+    virtual std::chrono::system_clock::time_point WallNow() = 0;
+    // Waits on |cv|, whose mutex |lock| holds, until |done| returns true or
+    // |deadline| passes, and returns done(). SteadyTime::max() means no
+    // deadline.
+    virtual bool WaitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& cv,
+                           SteadyTime deadline, const std::function<bool()>& done) = 0;
+    // Bracket the life of a thread that waits through this clock.
+    // ThreadStarting() runs on the thread that creates it.
+    virtual void ThreadStarting() {}
+    virtual void ThreadExited() {}
+
+    int64_t WallNowUs() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(WallNow().time_since_epoch()).count();
+    }
+
+    // The real clocks, shared by the whole process.
+    static Clock* System();
+};
+
+// Real steady time in nanoseconds, whatever Clock the pipeline runs on,
+// for measuring how long work actually takes.
+inline int64_t MonotonicNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+// The wall-clock time, in microseconds since the epoch, of a
+// MonotonicNowNs() reading, so it can be compared with stamps taken in
+// another process or runtime.
+int64_t MonotonicToWallUs(int64_t monotonic_ns);
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_CLOCK_H_
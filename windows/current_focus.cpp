@@ -0,0 +1,45 @@
+#include "current_focus.h"
+
+#include <cstring>
+#include <string>
+
+namespace app_focus_tracker {
+
+namespace {
+
+// Copies as much of |value| as fits, never ending inside a UTF-8 sequence.
+template <size_t N>
+void CopyName(const std::string& value, char (&buffer)[N]) {
+    size_t length = value.size();
+    if (length >= N) {
+        length = N - 1;
+        while (length > 0 && (static_cast<unsigned char>(value[length]) & 0xc0) == 0x80) --length;
+    }
+    std::memcpy(buffer, value.data(), length);
+    buffer[length] = '\0';
+}
+
+}  // namespace
+
+void CurrentFocusSlot::Publish(const FocusSpan& span, int64_t updated_us) {
+    CurrentFocus focus;
+    focus.valid = true;
+    focus.process_id = span.process_id;
+    focus.window_id = span.window_id;
+    focus.since_us = span.start_us;
+    focus.updated_us = updated_us;
+    CopyName(span.app_name, focus.app_name);
+    CopyName(span.title, focus.title);
+    slot_.Store(focus);
+}
+
+void CurrentFocusSlot::Clear() {
+    slot_.Store(CurrentFocus());
+}
+
+bool CurrentFocusSlot::Read(CurrentFocus* focus) const {
+    *focus = slot_.Load();
+    return focus->valid;
+}
+
+}  // namespace app_focus_tracker
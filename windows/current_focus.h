@@ -0,0 +1,47 @@
+#ifndef FLUTTER_PLUGIN_CURRENT_FOCUS_H_
+#define FLUTTER_PLUGIN_CURRENT_FOCUS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "seqlock.h"
+#include "sessionizer.h"
+
+namespace app_focus_tracker {
+
+// What currently has focus, as published by the sampling thread. Names are
+// held inline, so nothing outlives the sample that published them; they are
+// NUL-terminated UTF-8, cut at a character boundary to fit.
+struct CurrentFocus {
+    static constexpr size_t kAppNameSize = 256;
+    static constexpr size_t kTitleSize = 1024;
+
+    bool valid = false;
+    uint32_t process_id = 0;
+    uint64_t window_id = 0;
+    // When focus moved here, and when it was last confirmed.
+    int64_t since_us = 0;
+    int64_t updated_us = 0;
+    char app_name[kAppNameSize] = {};
+    char title[kTitleSize] = {};
+};
+
+// Seqlock-protected slot holding the latest CurrentFocus. There is one
+// copy of it: reads copy about a kilobyte and never block the writer, and a
+// read that overlaps a write retries.
+class CurrentFocusSlot {
+public:
+    // Writer side; calls must be serialized by the caller.
+    void Publish(const FocusSpan& span, int64_t updated_us);
+    void Clear();
+
+    // Any thread. Returns false when nothing is being tracked.
+    bool Read(CurrentFocus* focus) const;
+
+private:
+    SeqLock<CurrentFocus> slot_;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_CURRENT_FOCUS_H_
@@ -0,0 +1,227 @@
+#include "event_encoding.h"
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace app_focus_tracker {
+
+namespace {
+
+struct FieldName {
+    const char* name;
+    EventField field;
+};
+
+constexpr FieldName kFieldNames[] = {
+    {"appName", kAppNameField}, {"windowTitle", kWindowTitleField}, {"processId", kProcessIdField},
+    {"start", kStartField},     {"end", kEndField},                 {"duration", kDurationField},
+};
+
+}  // namespace
+
+const flutter::EncodableValue* FindArgument(const flutter::EncodableValue* arguments, const char* key) {
+    const auto* map = arguments ? std::get_if<flutter::EncodableMap>(arguments) : nullptr;
+    if (!map) return nullptr;
+    auto it = map->find(flutter::EncodableValue(key));
+    return it == map->end() ? nullptr : &it->second;
+}
+
+bool GetInt(const flutter::EncodableValue* value, int64_t* result) {
+    if (!value) return false;
+    if (const auto* v = std::get_if<int32_t>(value)) {
+        *result = *v;
+        return true;
+    }
+    if (const auto* v = std::get_if<int64_t>(value)) {
+        *result = *v;
+        return true;
+    }
+    return false;
+}
+
+std::vector<std::string> GetStrings(const flutter::EncodableValue* value) {
+    std::vector<std::string> strings;
+    const auto* list = value ? std::get_if<flutter::EncodableList>(value) : nullptr;
+    if (!list) return strings;
+    for (const auto& item : *list) {
+        if (const auto* text = std::get_if<std::string>(&item)) strings.push_back(*text);
+    }
+    return strings;
+}
+
+SpanFilter ParseFilter(const flutter::EncodableValue* arguments) {
+    SpanFilter filter;
+    filter.apps = GetStrings(FindArgument(arguments, "apps"));
+    filter.exclude_apps = GetStrings(FindArgument(arguments, "excludeApps"));
+    int64_t min_duration_ms = 0;
+    if (GetInt(FindArgument(arguments, "minDurationMs"), &min_duration_ms) && min_duration_ms > 0) {
+        filter.min_duration_us = min_duration_ms * 1000;
+    }
+    return filter;
+}
+
+uint32_t ParseFields(const flutter::EncodableValue* arguments) {
+    uint32_t fields = 0;
+    for (const std::string& name : GetStrings(FindArgument(arguments, "fields"))) {
+        for (const FieldName& entry : kFieldNames) {
+            if (name == entry.name) fields |= entry.field;
+        }
+    }
+    return fields == 0 ? kAllFields : fields;
+}
+
+SubscriptionOptions ParseSubscriptionOptions(const flutter::EncodableValue* arguments) {
+    SubscriptionOptions options;
+    if (const auto* value = FindArgument(arguments, "granularity")) {
+        if (const auto* name = std::get_if<std::string>(value)) {
+            if (*name == "spans") options.granularity = Granularity::kSpans;
+            if (*name == "batched") options.granularity = Granularity::kBatched;
+        }
+    }
+    int64_t number = 0;
+    if (GetInt(FindArgument(arguments, "batchIntervalMs"), &number) && number > 0) {
+        options.batch_interval = std::chrono::milliseconds(number);
+    }
+    if (GetInt(FindArgument(arguments, "maxBatch"), &number) && number > 0) {
+        options.max_batch = static_cast<size_t>(number);
+    }
+    options.filter = ParseFilter(FindArgument(arguments, "filter"));
+    return options;
+}
+
+flutter::EncodableValue EncodeSpan(const FocusSpan& span, uint32_t fields) {
+    flutter::EncodableMap event;
+    if (fields & kAppNameField) {
+        event[flutter::EncodableValue("appName")] = flutter::EncodableValue(span.app_name);
+    }
+    if (fields & kWindowTitleField) {
+        event[flutter::EncodableValue("windowTitle")] = flutter::EncodableValue(span.title);
+    }
+    if (fields & kProcessIdField) {
+        event[flutter::EncodableValue("processId")] = flutter::EncodableValue(static_cast<int64_t>(span.process_id));
+    }
+    if (fields & kStartField) {
+        event[flutter::EncodableValue("start")] = flutter::EncodableValue(span.start_us / 1000);
+    }
+    if (fields & kEndField) {
+        event[flutter::EncodableValue("end")] = flutter::EncodableValue(span.end_us / 1000);
+    }
+    if (fields & kDurationField) {
+        event[flutter::EncodableValue("duration")] =
+            flutter::EncodableValue(static_cast<int32_t>((span.duration_us() + 500000) / 1000000));
+    }
+    return flutter::EncodableValue(std::move(event));
+}
+
+flutter::EncodableValue EncodeSpans(const FocusSpan* spans, size_t count, Granularity granularity, uint32_t fields) {
+    if (granularity != Granularity::kBatched) {
+        return EncodeSpan(spans[0], fields);
+    }
+    flutter::EncodableList list;
+    list.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        list.push_back(EncodeSpan(spans[i], fields));
+    }
+    flutter::EncodableMap batch;
+    batch[flutter::EncodableValue("events")] = flutter::EncodableValue(std::move(list));
+    return flutter::EncodableValue(std::move(batch));
+}
+
+flutter::EncodableValue EncodeCurrentFocus(const CurrentFocusSlot& slot) {
+    CurrentFocus focus;
+    if (!slot.Read(&focus)) return flutter::EncodableValue();
+    flutter::EncodableMap event;
+    event[flutter::EncodableValue("appName")] = flutter::EncodableValue(std::string(focus.app_name));
+    event[flutter::EncodableValue("windowTitle")] = flutter::EncodableValue(std::string(focus.title));
+    event[flutter::EncodableValue("processId")] = flutter::EncodableValue(static_cast<int64_t>(focus.process_id));
+    event[flutter::EncodableValue("since")] = flutter::EncodableValue(focus.since_us / 1000);
+    event[flutter::EncodableValue("updated")] = flutter::EncodableValue(focus.updated_us / 1000);
+    return flutter::EncodableValue(std::move(event));
+}
+
+namespace {
+
+flutter::EncodableValue EncodeHistogram(const LatencyHistogram& histogram) {
+    flutter::EncodableMap summary;
+    summary[flutter::EncodableValue("count")] = flutter::EncodableValue(static_cast<int64_t>(histogram.count()));
+    summary[flutter::EncodableValue("meanNs")] = flutter::EncodableValue(histogram.mean());
+    summary[flutter::EncodableValue("p50Ns")] = flutter::EncodableValue(histogram.Percentile(50));
+    summary[flutter::EncodableValue("p90Ns")] = flutter::EncodableValue(histogram.Percentile(90));
+    summary[flutter::EncodableValue("p99Ns")] = flutter::EncodableValue(histogram.Percentile(99));
+    summary[flutter::EncodableValue("maxNs")] = flutter::EncodableValue(histogram.max());
+    return flutter::EncodableValue(std::move(summary));
+}
+
+}  // namespace
+
+void AddLatencyStamps(const LatencyStamps& stamps, flutter::EncodableValue* event) {
+    auto* map = std::get_if<flutter::EncodableMap>(event);
+    if (!map) return;
+    flutter::EncodableMap latency;
+    auto stamp = [&latency](const char* key, int64_t ns) {
+        if (ns != 0) latency[flutter::EncodableValue(key)] = flutter::EncodableValue(MonotonicToWallUs(ns));
+    };
+    stamp("detectedUs", stamps.detected_ns);
+    stamp("deliveredUs", stamps.delivered_ns);
+    stamp("encodedUs", stamps.encoded_ns);
+    stamp("dispatchedUs", stamps.dispatched_ns);
+    (*map)[flutter::EncodableValue("latency")] = flutter::EncodableValue(std::move(latency));
+}
+
+flutter::EncodableValue EncodeEventLatency(const EventLatency& latency) {
+    flutter::EncodableMap stages;
+    for (size_t i = 0; i < kLatencyStageCount; ++i) {
+        auto stage = static_cast<LatencyStage>(i);
+        stages[flutter::EncodableValue(LatencyStageName(stage))] = EncodeHistogram(latency.histogram(stage));
+    }
+    return flutter::EncodableValue(std::move(stages));
+}
+
+flutter::EncodableValue EncodeMetrics(const TrackerMetrics& metrics) {
+    flutter::EncodableMap values;
+    for (size_t i = 0; i < kCounterCount; ++i) {
+        auto counter = static_cast<Counter>(i);
+        values[flutter::EncodableValue(TrackerMetrics::Name(counter))] =
+            flutter::EncodableValue(static_cast<int64_t>(metrics.value(counter)));
+    }
+    for (size_t i = 0; i < kGaugeCount; ++i) {
+        auto gauge = static_cast<Gauge>(i);
+        values[flutter::EncodableValue(TrackerMetrics::Name(gauge))] = flutter::EncodableValue(metrics.value(gauge));
+    }
+    for (size_t i = 0; i < kTimingCount; ++i) {
+        auto timing = static_cast<Timing>(i);
+        values[flutter::EncodableValue(TrackerMetrics::Name(timing))] = EncodeHistogram(metrics.timing(timing));
+    }
+    return flutter::EncodableValue(std::move(values));
+}
+
+size_t EncodedSize(const flutter::EncodableValue& value) {
+    // Type byte, then a size of 1, 3 or 5 bytes for variable-length data.
+    auto sized = [](size_t count, size_t element_bytes) {
+        return 1 + (count < 254 ? 1 : count <= 0xffff ? 3 : 5) + count * element_bytes;
+    };
+    if (std::holds_alternative<std::monostate>(value) || std::holds_alternative<bool>(value)) return 1;
+    if (std::holds_alternative<int32_t>(value)) return 5;
+    if (std::holds_alternative<int64_t>(value) || std::holds_alternative<double>(value)) return 9;
+    if (const auto* text = std::get_if<std::string>(&value)) return sized(text->size(), 1);
+    if (const auto* bytes = std::get_if<std::vector<uint8_t>>(&value)) return sized(bytes->size(), 1);
+    if (const auto* ints = std::get_if<std::vector<int32_t>>(&value)) return sized(ints->size(), 4);
+    if (const auto* longs = std::get_if<std::vector<int64_t>>(&value)) return sized(longs->size(), 8);
+    if (const auto* doubles = std::get_if<std::vector<double>>(&value)) return sized(doubles->size(), 8);
+    if (const auto* list = std::get_if<flutter::EncodableList>(&value)) {
+        size_t size = sized(list->size(), 0);
+        for (const auto& element : *list) size += EncodedSize(element);
+        return size;
+    }
+    if (const auto* map = std::get_if<flutter::EncodableMap>(&value)) {
+        size_t size = sized(map->size(), 0);
+        for (const auto& entry : *map) size += EncodedSize(entry.first) + EncodedSize(entry.second);
+        return size;
+    }
+    return 0;
+}
+
+}  // namespace app_focus_tracker
@@ -0,0 +1,68 @@
+#ifndef FLUTTER_PLUGIN_EVENT_ENCODING_H_
+#define FLUTTER_PLUGIN_EVENT_ENCODING_H_
+
+#include <flutter/encodable_value.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "current_focus.h"
+#include "event_latency.h"
+#include "focus_sampler.h"
+#include "tracker_metrics.h"
+
+namespace app_focus_tracker {
+
+// Bits selecting which keys an encoded event carries.
+enum EventField : uint32_t {
+    kAppNameField = 1u << 0,
+    kWindowTitleField = 1u << 1,
+    kProcessIdField = 1u << 2,
+    kStartField = 1u << 3,
+    kEndField = 1u << 4,
+    kDurationField = 1u << 5,
+    kAllFields = (1u << 6) - 1,
+};
+
+// Value of |key| in a map argument, or null.
+const flutter::EncodableValue* FindArgument(const flutter::EncodableValue* arguments, const char* key);
+bool GetInt(const flutter::EncodableValue* value, int64_t* result);
+// The string elements of a list argument; anything else is skipped.
+std::vector<std::string> GetStrings(const flutter::EncodableValue* value);
+
+// {"apps": [String], "excludeApps": [String], "minDurationMs": int}
+SpanFilter ParseFilter(const flutter::EncodableValue* arguments);
+// ["appName", "duration", ...]; absent or empty means every field.
+uint32_t ParseFields(const flutter::EncodableValue* arguments);
+// Listen arguments: {"granularity": "raw" | "spans" | "batched",
+// "batchIntervalMs": int, "maxBatch": int, "filter": {...}, "fields": [...]}.
+// Missing keys keep their defaults.
+SubscriptionOptions ParseSubscriptionOptions(const flutter::EncodableValue* arguments);
+
+flutter::EncodableValue EncodeSpan(const FocusSpan& span, uint32_t fields);
+// One event for raw and span subscribers, {"events": [...]} for batches.
+flutter::EncodableValue EncodeSpans(const FocusSpan* spans, size_t count, Granularity granularity, uint32_t fields);
+// Null when nothing is focused.
+flutter::EncodableValue EncodeCurrentFocus(const CurrentFocusSlot& slot);
+
+// Adds {"latency": {"detectedUs", "deliveredUs", "encodedUs",
+// "dispatchedUs"}} to an encoded event, as wall-clock microseconds since
+// the epoch so Dart can compare them with its own clock.
+void AddLatencyStamps(const LatencyStamps& stamps, flutter::EncodableValue* event);
+// {"deliver": {"count", "meanNs", "p50Ns", "p90Ns", "p99Ns", "maxNs"},
+// "encode": {...}, "queue": {...}, "total": {...}}
+flutter::EncodableValue EncodeEventLatency(const EventLatency& latency);
+// Every counter and gauge by name, and each timing as a summary like
+// EncodeEventLatency's.
+flutter::EncodableValue EncodeMetrics(const TrackerMetrics& metrics);
+
+// Bytes the standard codec writes for |value|, without the alignment
+// padding it inserts before doubles and numeric arrays, which depends on
+// where in the message they land.
+size_t EncodedSize(const flutter::EncodableValue& value);
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_EVENT_ENCODING_H_
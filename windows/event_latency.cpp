@@ -0,0 +1,35 @@
+#include "event_latency.h"
+
+namespace app_focus_tracker {
+
+const char* LatencyStageName(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::kDeliver:
+            return "deliver";
+        case LatencyStage::kEncode:
+            return "encode";
+        case LatencyStage::kQueue:
+            return "queue";
+        case LatencyStage::kTotal:
+            return "total";
+    }
+    return "";
+}
+
+void EventLatency::Add(LatencyStage stage, int64_t from_ns, int64_t to_ns) {
+    if (from_ns == 0 || to_ns == 0) return;
+    stages_[static_cast<size_t>(stage)].Record(to_ns - from_ns);
+}
+
+void EventLatency::Record(const LatencyStamps& stamps) {
+    Add(LatencyStage::kDeliver, stamps.detected_ns, stamps.delivered_ns);
+    Add(LatencyStage::kEncode, stamps.delivered_ns, stamps.encoded_ns);
+    Add(LatencyStage::kQueue, stamps.encoded_ns, stamps.dispatched_ns);
+    Add(LatencyStage::kTotal, stamps.detected_ns, stamps.dispatched_ns);
+}
+
+void EventLatency::Reset() {
+    for (LatencyHistogram& stage : stages_) stage.Reset();
+}
+
+}  // namespace app_focus_tracker
@@ -0,0 +1,54 @@
+#ifndef FLUTTER_PLUGIN_EVENT_LATENCY_H_
+#define FLUTTER_PLUGIN_EVENT_LATENCY_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "latency_histogram.h"
+
+namespace app_focus_tracker {
+
+// The legs of a focus event's trip from the OS to the event channel.
+enum class LatencyStage : uint8_t {
+    // Reading the OS until the sampler hands the span to the subscriber:
+    // title lookup, change detection and fan-out.
+    kDeliver,
+    // Encoding the event on the sampling thread.
+    kEncode,
+    // Waiting for the platform thread to pick up the encoded event.
+    kQueue,
+    // The whole trip, up to the send on the platform thread.
+    kTotal,
+};
+constexpr size_t kLatencyStageCount = 4;
+
+const char* LatencyStageName(LatencyStage stage);
+
+// When one event passed each point, in MonotonicNowNs() time; 0 where not
+// yet reached.
+struct LatencyStamps {
+    int64_t detected_ns = 0;
+    int64_t delivered_ns = 0;
+    int64_t encoded_ns = 0;
+    int64_t dispatched_ns = 0;
+};
+
+// A LatencyHistogram per stage. Events are recorded from the sampling and
+// platform threads while any thread reads.
+class EventLatency {
+public:
+    // Adds whichever stages |stamps| covers.
+    void Record(const LatencyStamps& stamps);
+    void Reset();
+
+    const LatencyHistogram& histogram(LatencyStage stage) const { return stages_[static_cast<size_t>(stage)]; }
+
+private:
+    void Add(LatencyStage stage, int64_t from_ns, int64_t to_ns);
+
+    LatencyHistogram stages_[kLatencyStageCount];
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_EVENT_LATENCY_H_
@@ -0,0 +1,78 @@
+#include "file_util.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <system_error>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "pipeline_tracing.h"
+#include "tracker_metrics.h"
+
+namespace app_focus_tracker {
+
+bool ReadFile(const std::string& path, std::string* contents) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+    char buffer[64 * 1024];
+    size_t read = 0;
+    contents->clear();
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        contents->append(buffer, read);
+    }
+    bool ok = std::ferror(file) == 0;
+    std::fclose(file);
+    return ok;
+}
+
+bool WriteFileAtomically(const std::string& path, const std::string& contents) {
+    std::string temp = path + ".tmp";
+    std::FILE* file = std::fopen(temp.c_str(), "wb");
+    if (!file) return false;
+    bool ok = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    // Without this the rename can reach the disk before the data, leaving
+    // an empty or torn file under the new name after a crash.
+    ok = SyncFile(file) && ok;
+    ok = std::fclose(file) == 0 && ok;
+    std::error_code ec;
+    if (ok) {
+        std::filesystem::rename(temp, path, ec);
+    }
+    if (!ok || ec) {
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+    return SyncDirectory(std::filesystem::path(path).parent_path().string());
+}
+
+bool SyncFile(std::FILE* file) {
+    if (std::fflush(file) != 0) return false;
+    TrackerMetrics::Get().Add(Counter::kFsyncs);
+    ScopedTiming timing(Timing::kFsync);
+    TracingScope tracing("fsync");
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+bool SyncDirectory(const std::string& directory) {
+#ifdef _WIN32
+    (void)directory;
+    return true;
+#else
+    int fd = open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return false;
+    bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+#endif
+}
+
+}  // namespace app_focus_tracker
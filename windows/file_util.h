@@ -0,0 +1,24 @@
+#ifndef FLUTTER_PLUGIN_FILE_UTIL_H_
+#define FLUTTER_PLUGIN_FILE_UTIL_H_
+
+#include <cstdio>
+#include <string>
+
+namespace app_focus_tracker {
+
+bool ReadFile(const std::string& path, std::string* contents);
+
+// Writes to a temporary file, syncs it and renames it over |path|, then
+// syncs the directory, so a crash leaves either the old or the new
+// contents and a completed write survives power loss.
+bool WriteFileAtomically(const std::string& path, const std::string& contents);
+
+// Flushes |file| and waits until the OS has it on disk.
+bool SyncFile(std::FILE* file);
+// Makes renames and new entries in |directory| durable. A no-op on
+// Windows, which has no handle to sync a directory through.
+bool SyncDirectory(const std::string& directory);
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_FILE_UTIL_H_
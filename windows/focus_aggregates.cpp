@@ -0,0 +1,160 @@
+#include "focus_aggregates.h"
+
+#include <algorithm>
+
+namespace app_focus_tracker {
+
+namespace {
+
+bool RanksBefore(const FocusAggregates::RankedApp& a, const FocusAggregates::RankedApp& b) {
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+}
+
+}  // namespace
+
+FocusAggregates::FocusAggregates(AggregateOptions options) : options_(options) {}
+
+void FocusAggregates::Apply(const FocusSession& session) {
+    int64_t duration = session.duration_us();
+    AppTotal& total = app_totals_[session.app_id];
+    total.focus_us += duration;
+    total.sessions += 1;
+    total_focus_us_ += duration;
+    session_count_ += 1;
+    UpdateTopK(session.app_id, total.focus_us);
+
+    // Split the session at UTC day boundaries.
+    int64_t start = session.start_us;
+    while (start < session.end_us) {
+        int64_t day = DayIndex(start);
+        int64_t day_end = (day + 1) * kMicrosPerDay;
+        int64_t end = std::min(day_end, session.end_us);
+        AddToDay(day, session.app_id, end - start);
+        start = end;
+    }
+    TrimRollups();
+}
+
+void FocusAggregates::Merge(const FocusAggregates& other) {
+    for (const auto& entry : other.app_totals_) {
+        AppTotal& total = app_totals_[entry.first];
+        total.focus_us += entry.second.focus_us;
+        total.sessions += entry.second.sessions;
+    }
+    for (const auto& day : other.daily_rollups_) {
+        for (const auto& entry : day.second) {
+            AddToDay(day.first, entry.first, entry.second);
+        }
+    }
+    total_focus_us_ += other.total_focus_us_;
+    session_count_ += other.session_count_;
+    TrimRollups();
+    RebuildTopK();
+}
+
+void FocusAggregates::Clear() {
+    app_totals_.clear();
+    top_apps_.clear();
+    daily_rollups_.clear();
+    total_focus_us_ = 0;
+    session_count_ = 0;
+}
+
+void FocusAggregates::AddToDay(int64_t day, uint32_t app_id, int64_t focus_us) {
+    daily_rollups_[day][app_id] += focus_us;
+}
+
+void FocusAggregates::TrimRollups() {
+    while (daily_rollups_.size() > options_.rollup_days) {
+        daily_rollups_.erase(daily_rollups_.begin());
+    }
+}
+
+void FocusAggregates::UpdateTopK(uint32_t app_id, int64_t focus_us) {
+    if (options_.top_k == 0) return;
+    // Totals only grow, so an app can only move up the ranking.
+    auto it = std::find_if(top_apps_.begin(), top_apps_.end(),
+                           [app_id](const RankedApp& ranked) { return ranked.first == app_id; });
+    RankedApp candidate(app_id, focus_us);
+    if (it != top_apps_.end()) {
+        it->second = focus_us;
+    } else if (top_apps_.size() < options_.top_k) {
+        top_apps_.push_back(candidate);
+    } else if (RanksBefore(candidate, top_apps_.back())) {
+        top_apps_.back() = candidate;
+    } else {
+        return;
+    }
+    std::sort(top_apps_.begin(), top_apps_.end(), RanksBefore);
+}
+
+void FocusAggregates::RebuildTopK() {
+    top_apps_.clear();
+    for (const auto& entry : app_totals_) {
+        top_apps_.emplace_back(entry.first, entry.second.focus_us);
+    }
+    size_t keep = std::min(options_.top_k, top_apps_.size());
+    std::partial_sort(top_apps_.begin(), top_apps_.begin() + keep, top_apps_.end(), RanksBefore);
+    top_apps_.resize(keep);
+}
+
+void FocusAggregates::Serialize(std::string* out) const {
+    PutI64(*out, total_focus_us_);
+    PutU64(*out, session_count_);
+    PutU32(*out, static_cast<uint32_t>(app_totals_.size()));
+    for (const auto& entry : app_totals_) {
+        PutU32(*out, entry.first);
+        PutI64(*out, entry.second.focus_us);
+        PutU64(*out, entry.second.sessions);
+    }
+    PutU32(*out, static_cast<uint32_t>(daily_rollups_.size()));
+    for (const auto& day : daily_rollups_) {
+        PutI64(*out, day.first);
+        PutU32(*out, static_cast<uint32_t>(day.second.size()));
+        for (const auto& entry : day.second) {
+            PutU32(*out, entry.first);
+            PutI64(*out, entry.second);
+        }
+    }
+}
+
+bool FocusAggregates::Deserialize(ByteReader& in) {
+    Clear();
+    uint32_t app_count = 0;
+    in.ReadI64(&total_focus_us_);
+    in.ReadU64(&session_count_);
+    in.ReadU32(&app_count);
+    for (uint32_t i = 0; i < app_count && in.ok(); ++i) {
+        uint32_t app_id = 0;
+        AppTotal total;
+        in.ReadU32(&app_id);
+        in.ReadI64(&total.focus_us);
+        in.ReadU64(&total.sessions);
+        app_totals_[app_id] = total;
+    }
+    uint32_t day_count = 0;
+    in.ReadU32(&day_count);
+    for (uint32_t i = 0; i < day_count && in.ok(); ++i) {
+        int64_t day = 0;
+        uint32_t entries = 0;
+        in.ReadI64(&day);
+        in.ReadU32(&entries);
+        DayRollup& rollup = daily_rollups_[day];
+        for (uint32_t j = 0; j < entries && in.ok(); ++j) {
+            uint32_t app_id = 0;
+            int64_t focus_us = 0;
+            in.ReadU32(&app_id);
+            in.ReadI64(&focus_us);
+            rollup[app_id] = focus_us;
+        }
+    }
+    if (!in.ok()) {
+        Clear();
+        return false;
+    }
+    TrimRollups();
+    RebuildTopK();
+    return true;
+}
+
+}  // namespace app_focus_tracker
@@ -0,0 +1,70 @@
+#ifndef FLUTTER_PLUGIN_FOCUS_AGGREGATES_H_
+#define FLUTTER_PLUGIN_FOCUS_AGGREGATES_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "binary_io.h"
+#include "focus_types.h"
+
+namespace app_focus_tracker {
+
+struct AggregateOptions {
+    // Number of apps kept in the top-K ranking.
+    size_t top_k = 10;
+    // Number of most recent days kept in the daily rollups.
+    size_t rollup_days = 90;
+};
+
+struct AppTotal {
+    int64_t focus_us = 0;
+    uint64_t sessions = 0;
+};
+
+// In-memory summary of the journal: all-time per-app counters, a top-K
+// ranking and per-day rollups. Applying sessions in any order, or merging
+// partial aggregates, produces the same result.
+class FocusAggregates {
+public:
+    using DayRollup = std::unordered_map<uint32_t, int64_t>;
+    using RankedApp = std::pair<uint32_t, int64_t>;
+
+    explicit FocusAggregates(AggregateOptions options = AggregateOptions());
+
+    void Apply(const FocusSession& session);
+    void Merge(const FocusAggregates& other);
+    void Clear();
+
+    const AggregateOptions& options() const { return options_; }
+    const std::unordered_map<uint32_t, AppTotal>& app_totals() const { return app_totals_; }
+    // Sorted by focus time, descending; ties broken by app id.
+    const std::vector<RankedApp>& top_apps() const { return top_apps_; }
+    // Day index (see DayIndex) to per-app focus time.
+    const std::map<int64_t, DayRollup>& daily_rollups() const { return daily_rollups_; }
+    int64_t total_focus_us() const { return total_focus_us_; }
+    uint64_t session_count() const { return session_count_; }
+
+    void Serialize(std::string* out) const;
+    bool Deserialize(ByteReader& in);
+
+private:
+    void AddToDay(int64_t day, uint32_t app_id, int64_t focus_us);
+    void TrimRollups();
+    void UpdateTopK(uint32_t app_id, int64_t focus_us);
+    void RebuildTopK();
+
+    AggregateOptions options_;
+    std::unordered_map<uint32_t, AppTotal> app_totals_;
+    std::vector<RankedApp> top_apps_;
+    std::map<int64_t, DayRollup> daily_rollups_;
+    int64_t total_focus_us_ = 0;
+    uint64_t session_count_ = 0;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_FOCUS_AGGREGATES_H_
@@ -0,0 +1,171 @@
+#include "focus_budgets.h"
+
+#include <algorithm>
+#include <cctype>
+#include <utility>
+
+#include "focus_types.h"
+
+namespace app_focus_tracker {
+
+namespace {
+
+std::string Lowercase(const std::string& value) {
+    std::string result(value);
+    for (char& c : result) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return result;
+}
+
+}  // namespace
+
+FocusBudgets::FocusBudgets(TimerWheel* timers, int64_t utc_offset_us)
+    : timers_(timers), utc_offset_us_(utc_offset_us) {}
+
+FocusBudgets::~FocusBudgets() {
+    for (auto& entry : rules_) {
+        timers_->Cancel(entry.second.timer);
+    }
+    timers_->Cancel(rollover_);
+}
+
+uint64_t FocusBudgets::Add(const BudgetRule& rule, AlertCallback callback, int64_t now_us) {
+    if (rollover_ == TimerWheel::kInvalidTimer) {
+        since_us_ = now_us;
+        ScheduleRollover(now_us);
+    }
+    Settle(now_us);
+    uint64_t id = next_id_++;
+    Rule& entry = rules_[id];
+    entry.rule = rule;
+    entry.callback = std::move(callback);
+    for (const std::string& app : rule.apps) {
+        std::vector<uint64_t>& ids = by_app_[Lowercase(app)];
+        if (std::find(ids.begin(), ids.end(), id) == ids.end()) ids.push_back(id);
+    }
+    if (Covers(entry)) Arm(id, entry);
+    return id;
+}
+
+bool FocusBudgets::Remove(uint64_t id) {
+    auto it = rules_.find(id);
+    if (it == rules_.end()) return false;
+    timers_->Cancel(it->second.timer);
+    for (const std::string& app : it->second.rule.apps) {
+        auto apps = by_app_.find(Lowercase(app));
+        if (apps == by_app_.end()) continue;
+        apps->second.erase(std::remove(apps->second.begin(), apps->second.end(), id), apps->second.end());
+        if (apps->second.empty()) by_app_.erase(apps);
+    }
+    rules_.erase(it);
+    return true;
+}
+
+int64_t FocusBudgets::used_us(uint64_t id, int64_t now_us) const {
+    auto it = rules_.find(id);
+    if (it == rules_.end()) return 0;
+    int64_t used = it->second.used_us;
+    if (Covers(it->second) && now_us > since_us_) used += now_us - since_us_;
+    return used;
+}
+
+const std::vector<uint64_t>* FocusBudgets::ActiveRules() const {
+    if (app_key_.empty()) return nullptr;
+    auto it = by_app_.find(app_key_);
+    return it == by_app_.end() ? nullptr : &it->second;
+}
+
+bool FocusBudgets::Covers(const Rule& rule) const {
+    if (app_key_.empty()) return false;
+    return std::any_of(rule.rule.apps.begin(), rule.rule.apps.end(),
+                       [&](const std::string& app) { return Lowercase(app) == app_key_; });
+}
+
+void FocusBudgets::Focus(const std::string& app_name, int64_t now_us) {
+    std::string key = Lowercase(app_name);
+    if (key == app_key_) return;
+    Settle(now_us);
+    if (const auto* ids = ActiveRules()) {
+        for (uint64_t id : *ids) {
+            Rule& rule = rules_[id];
+            timers_->Cancel(rule.timer);
+            rule.timer = TimerWheel::kInvalidTimer;
+        }
+    }
+    app_key_ = std::move(key);
+    app_name_ = app_name;
+    if (const auto* ids = ActiveRules()) {
+        for (uint64_t id : *ids) {
+            Arm(id, rules_[id]);
+        }
+    }
+}
+
+void FocusBudgets::Settle(int64_t now_us) {
+    int64_t elapsed = now_us - since_us_;
+    since_us_ = now_us;
+    if (elapsed <= 0) return;
+    if (const auto* ids = ActiveRules()) {
+        for (uint64_t id : *ids) {
+            rules_[id].used_us += elapsed;
+        }
+    }
+}
+
+void FocusBudgets::Arm(uint64_t id, Rule& rule) {
+    timers_->Cancel(rule.timer);
+    rule.timer = TimerWheel::kInvalidTimer;
+    if (rule.alerted) return;
+    int64_t due_us = since_us_ + std::max<int64_t>(rule.rule.limit_us - rule.used_us, 0);
+    rule.timer = timers_->Schedule(due_us, [this, id](TimerWheel::TimerId, int64_t due) { OnExhausted(id, due); });
+}
+
+void FocusBudgets::OnExhausted(uint64_t id, int64_t due_us) {
+    auto it = rules_.find(id);
+    if (it == rules_.end()) return;
+    Rule& rule = it->second;
+    rule.timer = TimerWheel::kInvalidTimer;
+    rule.alerted = true;
+    BudgetAlert alert;
+    alert.rule_id = id;
+    alert.app_name = app_name_;
+    alert.used_us = rule.used_us + std::max<int64_t>(due_us - since_us_, 0);
+    alert.at_us = due_us;
+    if (rule.callback) rule.callback(alert);
+}
+
+void FocusBudgets::SetUtcOffset(int64_t utc_offset_us, int64_t now_us) {
+    if (utc_offset_us == utc_offset_us_) return;
+    bool next_day = DayIndex(now_us + utc_offset_us) > DayIndex(now_us + utc_offset_us_);
+    utc_offset_us_ = utc_offset_us;
+    // Without rules nothing is scheduled; Add() picks the offset up.
+    if (rollover_ == TimerWheel::kInvalidTimer) return;
+    timers_->Cancel(rollover_);
+    if (next_day) {
+        Rollover(now_us);
+    } else {
+        ScheduleRollover(now_us);
+    }
+}
+
+void FocusBudgets::ScheduleRollover(int64_t now_us) {
+    int64_t next_day_us = (DayIndex(now_us + utc_offset_us_) + 1) * kMicrosPerDay - utc_offset_us_;
+    rollover_ = timers_->Schedule(next_day_us, [this](TimerWheel::TimerId, int64_t due) { Rollover(due); });
+}
+
+void FocusBudgets::Rollover(int64_t due_us) {
+    Settle(due_us);
+    for (auto& entry : rules_) {
+        entry.second.used_us = 0;
+        entry.second.alerted = false;
+    }
+    if (const auto* ids = ActiveRules()) {
+        for (uint64_t id : *ids) {
+            Arm(id, rules_[id]);
+        }
+    }
+    ScheduleRollover(due_us);
+}
+
+}  // namespace app_focus_tracker
@@ -0,0 +1,96 @@
+#ifndef FLUTTER_PLUGIN_FOCUS_BUDGETS_H_
+#define FLUTTER_PLUGIN_FOCUS_BUDGETS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "timer_wheel.h"
+
+namespace app_focus_tracker {
+
+// A daily allowance of focus time shared by a group of apps.
+struct BudgetRule {
+    // Process names, compared without regard to ASCII case.
+    std::vector<std::string> apps;
+    int64_t limit_us = 0;
+};
+
+struct BudgetAlert {
+    uint64_t rule_id = 0;
+    // The app that used up the rest of the budget.
+    std::string app_name;
+    int64_t used_us = 0;
+    // The moment the budget ran out.
+    int64_t at_us = 0;
+};
+
+// Tracks per-day focus time against BudgetRules and raises an alert at the
+// exact moment a rule's total crosses its limit. Instead of checking every
+// rule on every sample, each focus change arms one timer per rule that
+// covers the newly focused app; the wheel then fires it precisely when the
+// remaining allowance runs out. Days start at midnight UTC shifted by
+// |utc_offset_us|, the local time zone's offset, which SetUtcOffset()
+// follows when it changes. Not thread-safe.
+class FocusBudgets {
+public:
+    using AlertCallback = std::function<void(const BudgetAlert& alert)>;
+
+    FocusBudgets(TimerWheel* timers, int64_t utc_offset_us = 0);
+    ~FocusBudgets();
+    FocusBudgets(const FocusBudgets&) = delete;
+    FocusBudgets& operator=(const FocusBudgets&) = delete;
+
+    uint64_t Add(const BudgetRule& rule, AlertCallback callback, int64_t now_us);
+    bool Remove(uint64_t id);
+
+    // Focus moved to |app_name| at |now_us|; an empty name means nothing is
+    // focused or tracking stopped.
+    void Focus(const std::string& app_name, int64_t now_us);
+
+    // Moves the start of the day to midnight in a new time zone. If that
+    // puts |now_us| on a later day than before, today's usage starts over.
+    void SetUtcOffset(int64_t utc_offset_us, int64_t now_us);
+    int64_t utc_offset_us() const { return utc_offset_us_; }
+
+    // Time charged to rule |id| today, as of |now_us|.
+    int64_t used_us(uint64_t id, int64_t now_us) const;
+    size_t size() const { return rules_.size(); }
+
+private:
+    struct Rule {
+        BudgetRule rule;
+        AlertCallback callback;
+        int64_t used_us = 0;
+        bool alerted = false;
+        TimerWheel::TimerId timer = TimerWheel::kInvalidTimer;
+    };
+
+    const std::vector<uint64_t>* ActiveRules() const;
+    bool Covers(const Rule& rule) const;
+    // Charges the time since |since_us_| to the rules covering the focused app.
+    void Settle(int64_t now_us);
+    void Arm(uint64_t id, Rule& rule);
+    void OnExhausted(uint64_t id, int64_t due_us);
+    void ScheduleRollover(int64_t now_us);
+    void Rollover(int64_t due_us);
+
+    TimerWheel* timers_;
+    int64_t utc_offset_us_;
+    uint64_t next_id_ = 1;
+    std::map<uint64_t, Rule> rules_;
+    // Lower-cased app name -> ids of the rules covering it.
+    std::unordered_map<std::string, std::vector<uint64_t>> by_app_;
+    std::string app_key_;
+    std::string app_name_;
+    int64_t since_us_ = 0;
+    TimerWheel::TimerId rollover_ = TimerWheel::kInvalidTimer;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_FOCUS_BUDGETS_H_
@@ -0,0 +1,204 @@
+#include "focus_export.h"
+
+#include <cstdio>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace app_focus_tracker {
+
+namespace {
+
+// Number of segment indexes an export keeps cached while it walks the journal.
+constexpr size_t kExportCachedIndexes = 4;
+
+// Appends |timestamp_us| as an ISO 8601 UTC timestamp with milliseconds.
+void AppendTimestamp(std::string& out, int64_t timestamp_us) {
+    int64_t days = DayIndex(timestamp_us);
+    int64_t micros_of_day = timestamp_us - days * kMicrosPerDay;
+    // Civil-from-days conversion (proleptic Gregorian calendar).
+    int64_t z = days + 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t doe = z - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    int64_t day = doy - (153 * mp + 2) / 5 + 1;
+    int64_t month = mp < 10 ? mp + 3 : mp - 9;
+    int64_t year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+
+    int seconds = static_cast<int>(micros_of_day / kMicrosPerSecond);
+    // Room for the widest values of the argument types: 20 characters for the
+    // year, 11 for each int and 7 separators, so nothing is ever cut off.
+    char buffer[96];
+    std::snprintf(buffer, sizeof(buffer), "%04lld-%02d-%02dT%02d:%02d:%02d.%03dZ",
+                  static_cast<long long>(year), static_cast<int>(month), static_cast<int>(day),
+                  seconds / 3600, seconds / 60 % 60, seconds % 60,
+                  static_cast<int>(micros_of_day % kMicrosPerSecond / 1000));
+    out.append(buffer);
+}
+
+void AppendCsvField(std::string& out, const std::string& value) {
+    if (value.find_first_of(",\"\r\n") == std::string::npos) {
+        out.append(value);
+        return;
+    }
+    out.push_back('"');
+    for (char c : value) {
+        if (c == '"') out.push_back('"');
+        out.push_back(c);
+    }
+    out.push_back('"');
+}
+
+void AppendJsonString(std::string& out, const std::string& value) {
+    out.push_back('"');
+    for (char c : value) {
+        switch (c) {
+            case '"': out.append("\\\""); break;
+            case '\\': out.append("\\\\"); break;
+            case '\n': out.append("\\n"); break;
+            case '\r': out.append("\\r"); break;
+            case '\t': out.append("\\t"); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escape[8];
+                    std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+                    out.append(escape);
+                } else {
+                    out.push_back(c);
+                }
+        }
+    }
+    out.push_back('"');
+}
+
+void AppendRow(std::string& out, ExportFormat format, const FocusSession& session,
+               const std::string& app, const std::string& title) {
+    long long duration_ms = static_cast<long long>(session.duration_us() / 1000);
+    if (format == ExportFormat::kCsv) {
+        AppendTimestamp(out, session.start_us);
+        out.push_back(',');
+        AppendTimestamp(out, session.end_us);
+        out.push_back(',');
+        out.append(std::to_string(duration_ms));
+        out.push_back(',');
+        AppendCsvField(out, app);
+        out.push_back(',');
+        AppendCsvField(out, title);
+        out.append("\r\n");
+    } else {
+        out.append("{\"start\":\"");
+        AppendTimestamp(out, session.start_us);
+        out.append("\",\"end\":\"");
+        AppendTimestamp(out, session.end_us);
+        out.append("\",\"durationMs\":");
+        out.append(std::to_string(duration_ms));
+        out.append(",\"appName\":");
+        AppendJsonString(out, app);
+        out.append(",\"title\":");
+        AppendJsonString(out, title);
+        out.append("}\n");
+    }
+}
+
+}  // namespace
+
+ExportResult ExportSessions(const FocusStore& store, const ExportOptions& options,
+                            const ExportWriter& write) {
+    ExportResult result;
+    std::string buffer;
+    buffer.reserve(options.buffer_bytes);
+    bool write_failed = false;
+
+    auto flush = [&]() {
+        if (!buffer.empty() && !write(buffer.data(), buffer.size())) {
+            write_failed = true;
+            return false;
+        }
+        result.bytes += buffer.size();
+        buffer.clear();
+        return true;
+    };
+    auto report = [&](bool done) {
+        if (!options.progress) return true;
+        ExportProgress progress;
+        progress.sessions = result.sessions;
+        progress.bytes = result.bytes + buffer.size();
+        progress.done = done;
+        return options.progress(progress);
+    };
+
+    if (options.format == ExportFormat::kCsv) {
+        buffer.append("start,end,durationMs,appName,title\r\n");
+    }
+
+    static const std::string kUnknown;
+    std::string row;
+    FocusQueryEngine engine(store.directory(), kExportCachedIndexes);
+    engine.SetTitleIndex(&store.titles(), &store.title_index());
+    bool ok = engine.Query(options.filter, [&](const FocusSession& session) {
+        const std::string* app = store.apps().Lookup(session.app_id);
+        const std::string* title = store.titles().Lookup(session.title_id);
+        row.clear();
+        AppendRow(row, options.format, session, app ? *app : kUnknown, title ? *title : kUnknown);
+        if (buffer.size() + row.size() > options.buffer_bytes && !flush()) return false;
+        if (row.size() > options.buffer_bytes) {
+            if (!write(row.data(), row.size())) {
+                write_failed = true;
+                return false;
+            }
+            result.bytes += row.size();
+        } else {
+            buffer.append(row);
+        }
+        ++result.sessions;
+        if (options.progress_interval > 0 && result.sessions % options.progress_interval == 0 &&
+            !report(false)) {
+            result.cancelled = true;
+            return false;
+        }
+        return true;
+    });
+
+    if (!ok || write_failed || result.cancelled || !flush()) {
+        return result;
+    }
+    result.ok = true;
+    report(true);
+    return result;
+}
+
+ExportResult ExportSessionsToFile(const FocusStore& store, const std::string& path,
+                                  const ExportOptions& options) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return ExportResult();
+    // Our own buffer already batches writes.
+    std::setvbuf(file, nullptr, _IONBF, 0);
+    ExportResult result = ExportSessions(store, options, [file](const char* data, size_t size) {
+        return std::fwrite(data, 1, size, file) == size;
+    });
+    if (std::fclose(file) != 0) result.ok = false;
+    return result;
+}
+
+ExportResult ExportSessionsToFd(const FocusStore& store, int fd, const ExportOptions& options) {
+    return ExportSessions(store, options, [fd](const char* data, size_t size) {
+        while (size > 0) {
+#ifdef _WIN32
+            int written = _write(fd, data, static_cast<unsigned int>(size));
+#else
+            ssize_t written = ::write(fd, data, size);
+#endif
+            if (written <= 0) return false;
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    });
+}
+
+}  // namespace app_focus_tracker
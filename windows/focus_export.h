@@ -0,0 +1,62 @@
+#ifndef FLUTTER_PLUGIN_FOCUS_EXPORT_H_
+#define FLUTTER_PLUGIN_FOCUS_EXPORT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "focus_query.h"
+#include "focus_store.h"
+
+namespace app_focus_tracker {
+
+enum class ExportFormat {
+    kCsv,
+    kJsonLines,
+};
+
+struct ExportProgress {
+    uint64_t sessions = 0;
+    uint64_t bytes = 0;
+    bool done = false;
+};
+
+struct ExportOptions {
+    ExportFormat format = ExportFormat::kCsv;
+    // Time range and app/title filters, evaluated through the segment indexes
+    // and, for title substrings, the store's title index.
+    SessionQuery filter;
+    // Output is staged in a buffer of this size and written when it fills up.
+    size_t buffer_bytes = 64 * 1024;
+    // Called every |progress_interval| sessions and once at the end. Returning
+    // false cancels the export.
+    std::function<bool(const ExportProgress&)> progress;
+    uint64_t progress_interval = 10000;
+};
+
+struct ExportResult {
+    bool ok = false;
+    bool cancelled = false;
+    uint64_t sessions = 0;
+    uint64_t bytes = 0;
+};
+
+// Receives the encoded output in chunks of at most ExportOptions::buffer_bytes
+// (longer single rows are passed through whole). Returns false on failure.
+using ExportWriter = std::function<bool(const char* data, size_t size)>;
+
+// Streams the sessions of |store| matching the options to |write|. Sessions
+// are read segment by segment from the journal, so apart from the store's
+// dictionaries memory use does not depend on the length of the history.
+// Runs on the calling thread; callers keep it off the platform thread.
+ExportResult ExportSessions(const FocusStore& store, const ExportOptions& options,
+                            const ExportWriter& write);
+ExportResult ExportSessionsToFile(const FocusStore& store, const std::string& path,
+                                  const ExportOptions& options);
+// Writes to an already open file descriptor, which is left open.
+ExportResult ExportSessionsToFd(const FocusStore& store, int fd, const ExportOptions& options);
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_FOCUS_EXPORT_H_
@@ -0,0 +1,260 @@
+#include "focus_journal.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+#include "binary_io.h"
+#include "file_util.h"
+#include "pipeline_tracing.h"
+#include "tracker_metrics.h"
+
+namespace app_focus_tracker {
+
+namespace {
+
+constexpr char kSegmentMagic[4] = {'A', 'F', 'T', 'J'};
+constexpr uint32_t kSegmentVersion = 1;
+constexpr uint32_t kMaxRecordSize = 1u << 20;
+constexpr size_t kFrameHeaderSize = 8;
+
+}  // namespace
+
+void EncodeJournalRecord(const JournalRecord& record, std::string* out) {
+    PutU8(*out, static_cast<uint8_t>(record.type));
+    switch (record.type) {
+        case JournalRecordType::kAppName:
+        case JournalRecordType::kTitle:
+            PutU32(*out, record.id);
+            PutString(*out, record.text);
+            break;
+        case JournalRecordType::kSession:
+            PutI64(*out, record.session.start_us);
+            PutI64(*out, record.session.end_us);
+            PutU32(*out, record.session.app_id);
+            PutU32(*out, record.session.title_id);
+            break;
+    }
+}
+
+bool DecodeJournalRecord(const void* data, size_t size, JournalRecord* record) {
+    ByteReader in(data, size);
+    uint8_t type = 0;
+    if (!in.ReadU8(&type)) return false;
+    record->type = static_cast<JournalRecordType>(type);
+    switch (record->type) {
+        case JournalRecordType::kAppName:
+        case JournalRecordType::kTitle:
+            in.ReadU32(&record->id);
+            in.ReadString(&record->text);
+            break;
+        case JournalRecordType::kSession:
+            in.ReadI64(&record->session.start_us);
+            in.ReadI64(&record->session.end_us);
+            in.ReadU32(&record->session.app_id);
+            in.ReadU32(&record->session.title_id);
+            break;
+        default:
+            return false;
+    }
+    return in.ok() && in.remaining() == 0;
+}
+
+JournalSegmentReader::~JournalSegmentReader() {
+    Close();
+}
+
+bool JournalSegmentReader::Open(const std::string& path) {
+    Close();
+    file_ = std::fopen(path.c_str(), "rb");
+    if (!file_) return false;
+    uint8_t header[kJournalSegmentHeaderSize];
+    if (std::fread(header, 1, sizeof(header), file_) != sizeof(header) ||
+        std::memcmp(header, kSegmentMagic, sizeof(kSegmentMagic)) != 0 ||
+        LoadU32(header + 4) != kSegmentVersion) {
+        Close();
+        return false;
+    }
+    offset_ = kJournalSegmentHeaderSize;
+    return true;
+}
+
+bool JournalSegmentReader::Seek(uint64_t offset) {
+    if (!file_ || offset < kJournalSegmentHeaderSize) return false;
+    if (std::fseek(file_, static_cast<long>(offset), SEEK_SET) != 0) return false;
+    offset_ = offset;
+    return true;
+}
+
+bool JournalSegmentReader::Next(JournalRecord* record) {
+    if (!file_) return false;
+    uint8_t frame[kFrameHeaderSize];
+    if (std::fread(frame, 1, sizeof(frame), file_) != sizeof(frame)) return false;
+    uint32_t size = LoadU32(frame);
+    uint32_t crc = LoadU32(frame + 4);
+    if (size == 0 || size > kMaxRecordSize) return false;
+    payload_.resize(size);
+    if (std::fread(&payload_[0], 1, size, file_) != size) return false;
+    if (Crc32(payload_.data(), size) != crc) return false;
+    if (!DecodeJournalRecord(payload_.data(), size, record)) return false;
+    offset_ += kFrameHeaderSize + size;
+    return true;
+}
+
+void JournalSegmentReader::Close() {
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+    offset_ = 0;
+}
+
+FocusJournal::~FocusJournal() {
+    Close();
+}
+
+bool FocusJournal::Open(const std::string& directory, const Options& options) {
+    Close();
+    directory_ = directory;
+    options_ = options;
+    bytes_appended_ = 0;
+    damaged_segment_ = 0;
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+
+    auto segments = ListSegments(directory_);
+    if (segments.empty()) {
+        return OpenSegment(1, true);
+    }
+
+    // Find the end of the last intact record and cut off anything after it.
+    uint32_t last = segments.back();
+    std::string path = SegmentPath(directory_, last);
+    JournalSegmentReader reader;
+    if (!reader.Open(path)) {
+        // Shorter than a header, nothing can follow it, so it is rewritten.
+        // Otherwise records may still sit behind a damaged header: the
+        // segment is left for replay to report and appends go to a new one.
+        uint64_t size = std::filesystem::file_size(path, ec);
+        if (!ec && size < kJournalSegmentHeaderSize) {
+            return OpenSegment(last, true);
+        }
+        damaged_segment_ = last;
+        return OpenSegment(last + 1, true);
+    }
+    JournalRecord record;
+    while (reader.Next(&record)) {
+    }
+    uint64_t valid_end = reader.offset();
+    reader.Close();
+    std::filesystem::resize_file(path, valid_end, ec);
+    if (ec) return false;
+    return OpenSegment(last, false);
+}
+
+void FocusJournal::Close() {
+    if (file_) {
+        std::fflush(file_);
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+bool FocusJournal::Append(const JournalRecord& record) {
+    if (!file_) return false;
+    TracingScope tracing("journalAppend");
+    buffer_.clear();
+    PutU32(buffer_, 0);
+    PutU32(buffer_, 0);
+    EncodeJournalRecord(record, &buffer_);
+    uint32_t size = static_cast<uint32_t>(buffer_.size() - kFrameHeaderSize);
+    if (size > kMaxRecordSize) return false;
+    uint32_t crc = Crc32(buffer_.data() + kFrameHeaderSize, size);
+    for (int i = 0; i < 4; ++i) {
+        buffer_[i] = static_cast<char>((size >> (8 * i)) & 0xff);
+        buffer_[4 + i] = static_cast<char>((crc >> (8 * i)) & 0xff);
+    }
+
+    if (active_offset_ > kJournalSegmentHeaderSize &&
+        active_offset_ + buffer_.size() > options_.segment_bytes) {
+        if (!Roll()) return false;
+    }
+    if (std::fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size()) {
+        return false;
+    }
+    active_offset_ += buffer_.size();
+    bytes_appended_ += buffer_.size();
+    TrackerMetrics::Get().Add(Counter::kJournalBytes, buffer_.size());
+    return true;
+}
+
+bool FocusJournal::Flush() {
+    return file_ && std::fflush(file_) == 0;
+}
+
+bool FocusJournal::Sync() {
+    return file_ && SyncFile(file_);
+}
+
+std::vector<uint32_t> FocusJournal::ListSegments(const std::string& directory) {
+    std::vector<uint32_t> segments;
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(directory, ec), end; !ec && it != end;
+         it.increment(ec)) {
+        std::string name = it->path().filename().string();
+        if (name.size() != 20 || name.compare(0, 8, "journal-") != 0 ||
+            name.compare(16, 4, ".seg") != 0) {
+            continue;
+        }
+        uint32_t index = 0;
+        bool digits = true;
+        for (size_t i = 8; i < 16; ++i) {
+            if (name[i] < '0' || name[i] > '9') digits = false;
+            index = index * 10 + static_cast<uint32_t>(name[i] - '0');
+        }
+        if (digits && index > 0) segments.push_back(index);
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+std::string FocusJournal::SegmentPath(const std::string& directory, uint32_t segment) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "journal-%08u.seg", segment);
+    return (std::filesystem::path(directory) / name).string();
+}
+
+bool FocusJournal::OpenSegment(uint32_t segment, bool create) {
+    std::string path = SegmentPath(directory_, segment);
+    file_ = std::fopen(path.c_str(), create ? "wb" : "ab");
+    if (!file_) return false;
+    active_segment_ = segment;
+    if (create) {
+        std::string header(kSegmentMagic, sizeof(kSegmentMagic));
+        PutU32(header, kSegmentVersion);
+        if (std::fwrite(header.data(), 1, header.size(), file_) != header.size() ||
+            std::fflush(file_) != 0) {
+            Close();
+            return false;
+        }
+        active_offset_ = kJournalSegmentHeaderSize;
+    } else {
+        std::error_code ec;
+        active_offset_ = std::filesystem::file_size(path, ec);
+        if (ec) {
+            Close();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FocusJournal::Roll() {
+    if (!SyncFile(file_)) return false;
+    Close();
+    return OpenSegment(active_segment_ + 1, true);
+}
+
+}  // namespace app_focus_tracker
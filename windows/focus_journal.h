@@ -0,0 +1,126 @@
+#ifndef FLUTTER_PLUGIN_FOCUS_JOURNAL_H_
+#define FLUTTER_PLUGIN_FOCUS_JOURNAL_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "focus_types.h"
+
+namespace app_focus_tracker {
+
+enum class JournalRecordType : uint8_t {
+    kAppName = 1,
+    kTitle = 2,
+    kSession = 3,
+};
+
+// One entry of the journal. String records define a dictionary id; session
+// records refer to previously defined ids.
+struct JournalRecord {
+    JournalRecordType type = JournalRecordType::kSession;
+    uint32_t id = 0;
+    std::string text;
+    FocusSession session;
+};
+
+// A byte offset inside a numbered segment file.
+struct JournalPosition {
+    uint32_t segment = 0;
+    uint64_t offset = 0;
+};
+
+inline bool operator<(const JournalPosition& a, const JournalPosition& b) {
+    return a.segment != b.segment ? a.segment < b.segment : a.offset < b.offset;
+}
+
+inline bool operator==(const JournalPosition& a, const JournalPosition& b) {
+    return a.segment == b.segment && a.offset == b.offset;
+}
+
+// Size of the magic/version header at the start of every segment.
+constexpr uint64_t kJournalSegmentHeaderSize = 8;
+
+void EncodeJournalRecord(const JournalRecord& record, std::string* out);
+bool DecodeJournalRecord(const void* data, size_t size, JournalRecord* record);
+
+// Sequential reader over a single segment file. Reading stops at the first
+// torn or corrupted record, which is how a crash mid-append shows up.
+class JournalSegmentReader {
+public:
+    JournalSegmentReader() = default;
+    ~JournalSegmentReader();
+    JournalSegmentReader(const JournalSegmentReader&) = delete;
+    JournalSegmentReader& operator=(const JournalSegmentReader&) = delete;
+
+    bool Open(const std::string& path);
+    bool Seek(uint64_t offset);
+    bool Next(JournalRecord* record);
+    void Close();
+
+    // Offset just past the last record returned by Next().
+    uint64_t offset() const { return offset_; }
+
+private:
+    std::FILE* file_ = nullptr;
+    uint64_t offset_ = 0;
+    std::string payload_;
+};
+
+// Append-only log of focus records split into numbered segment files.
+// Every segment except the newest is sealed and never written again, so
+// sealed segments can be read concurrently with appends.
+class FocusJournal {
+public:
+    struct Options {
+        uint64_t segment_bytes = 8u << 20;
+    };
+
+    FocusJournal() = default;
+    ~FocusJournal();
+    FocusJournal(const FocusJournal&) = delete;
+    FocusJournal& operator=(const FocusJournal&) = delete;
+
+    // Opens or creates the journal in |directory|, dropping any torn record
+    // at the end of the newest segment. A newest segment whose header is
+    // damaged is never written again; appends start a new segment after it.
+    bool Open(const std::string& directory, const Options& options);
+    void Close();
+    bool is_open() const { return file_ != nullptr; }
+
+    bool Append(const JournalRecord& record);
+    bool Flush();
+    // Flushes and asks the OS to persist the active segment.
+    bool Sync();
+
+    // Position just past the last appended record.
+    JournalPosition end() const { return {active_segment_, active_offset_}; }
+    const std::string& directory() const { return directory_; }
+    uint64_t bytes_appended() const { return bytes_appended_; }
+    // The damaged newest segment Open() left in place, or 0 if there was none.
+    uint32_t damaged_segment() const { return damaged_segment_; }
+
+    // Segments in ascending order; all but the last are sealed.
+    std::vector<uint32_t> Segments() const { return ListSegments(directory_); }
+
+    static std::vector<uint32_t> ListSegments(const std::string& directory);
+    static std::string SegmentPath(const std::string& directory, uint32_t segment);
+
+private:
+    bool OpenSegment(uint32_t segment, bool create);
+    bool Roll();
+
+    std::string directory_;
+    Options options_;
+    std::FILE* file_ = nullptr;
+    uint32_t active_segment_ = 0;
+    uint64_t active_offset_ = 0;
+    uint64_t bytes_appended_ = 0;
+    uint32_t damaged_segment_ = 0;
+    std::string buffer_;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_FOCUS_JOURNAL_H_
@@ -0,0 +1,151 @@
+#include "focus_query.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
+#include <system_error>
+#include <utility>
+
+#include "focus_journal.h"
+
+namespace app_focus_tracker {
+
+namespace {
+
+// |query.title_ids| must be sorted.
+bool Matches(const SessionQuery& query, const FocusSession& session) {
+    return session.start_us < query.to_us && session.end_us > query.from_us &&
+           (!query.filter_app || session.app_id == query.app_id) &&
+           (!query.filter_titles || std::binary_search(query.title_ids.begin(),
+                                                       query.title_ids.end(), session.title_id));
+}
+
+// Union of the posting lists of |title_ids| in one segment, ascending.
+std::vector<uint64_t> TitleRows(const SegmentIndex& index, const std::vector<uint32_t>& title_ids) {
+    std::vector<uint64_t> rows;
+    for (uint32_t title_id : title_ids) {
+        if (!index.ContainsTitle(title_id)) continue;
+        std::vector<uint64_t> more = index.TitleRows(title_id);
+        size_t middle = rows.size();
+        rows.insert(rows.end(), more.begin(), more.end());
+        std::inplace_merge(rows.begin(), rows.begin() + middle, rows.end());
+    }
+    return rows;
+}
+
+}  // namespace
+
+FocusQueryEngine::FocusQueryEngine(std::string directory, size_t max_cached_indexes)
+    : directory_(std::move(directory)), max_cached_indexes_(max_cached_indexes) {}
+
+bool FocusQueryEngine::Query(const SessionQuery& unsorted_query, const Visitor& visit,
+                             QueryStats* stats) {
+    SessionQuery query = unsorted_query;
+    if (query.filter_titles) {
+        std::sort(query.title_ids.begin(), query.title_ids.end());
+        query.title_ids.erase(std::unique(query.title_ids.begin(), query.title_ids.end()),
+                              query.title_ids.end());
+    }
+    if (!query.title_contains.empty()) {
+        if (!titles_ || !title_index_) return false;
+        // Search() returns ascending ids, so the lists intersect in place.
+        std::vector<uint32_t> found = title_index_->Search(*titles_, query.title_contains);
+        if (query.filter_titles) {
+            std::vector<uint32_t> both;
+            std::set_intersection(found.begin(), found.end(), query.title_ids.begin(),
+                                  query.title_ids.end(), std::back_inserter(both));
+            found = std::move(both);
+        }
+        query.filter_titles = true;
+        query.title_ids = std::move(found);
+    }
+    QueryStats local;
+    if (!stats) stats = &local;
+    *stats = QueryStats();
+
+    auto segments = FocusJournal::ListSegments(directory_);
+    JournalSegmentReader reader;
+    JournalRecord record;
+    for (size_t i = 0; i < segments.size(); ++i) {
+        const SegmentIndex* index = IndexFor(segments[i], i + 1 < segments.size());
+        if (!index) {
+            stats->damaged_segments.push_back(segments[i]);
+            continue;
+        }
+        bool has_title = !query.filter_titles;
+        for (size_t t = 0; !has_title && t < query.title_ids.size(); ++t) {
+            has_title = index->ContainsTitle(query.title_ids[t]);
+        }
+        if (!index->Overlaps(query.from_us, query.to_us) || !has_title ||
+            (query.filter_app && !index->ContainsApp(query.app_id))) {
+            ++stats->segments_skipped;
+            continue;
+        }
+        ++stats->segments_scanned;
+        if (!reader.Open(FocusJournal::SegmentPath(directory_, segments[i]))) {
+            stats->damaged_segments.push_back(segments[i]);
+            continue;
+        }
+
+        auto emit = [&]() {
+            ++stats->rows_read;
+            if (record.type != JournalRecordType::kSession || !Matches(query, record.session)) {
+                return true;
+            }
+            ++stats->matches;
+            return visit(record.session);
+        };
+
+        if (query.filter_app || query.filter_titles) {
+            std::vector<uint64_t> rows = query.filter_app ? index->AppRows(query.app_id)
+                                                          : TitleRows(*index, query.title_ids);
+            for (uint64_t row : rows) {
+                // The segment changed under its index; what was read stands.
+                if (!reader.Seek(row) || !reader.Next(&record)) {
+                    stats->damaged_segments.push_back(segments[i]);
+                    break;
+                }
+                if (!emit()) return true;
+            }
+        } else {
+            while (reader.offset() < index->segment_size() && reader.Next(&record)) {
+                if (!emit()) return true;
+            }
+        }
+    }
+    return true;
+}
+
+const SegmentIndex* FocusQueryEngine::IndexFor(uint32_t segment, bool sealed) {
+    std::error_code ec;
+    uint64_t size = std::filesystem::file_size(FocusJournal::SegmentPath(directory_, segment), ec);
+    if (ec) return nullptr;
+    auto it = indexes_.find(segment);
+    if (it != indexes_.end() && it->second.segment_size() == size) {
+        return &it->second;
+    }
+
+    if (it != indexes_.end()) {
+        indexes_.erase(it);
+    }
+    // Keeps memory flat during long scans such as exports.
+    if (max_cached_indexes_ > 0 && indexes_.size() >= max_cached_indexes_) {
+        indexes_.erase(indexes_.begin());
+    }
+    SegmentIndex& index = indexes_[segment];
+    if (sealed && index.Load(directory_, segment)) {
+        return &index;
+    }
+    if (!index.Build(directory_, segment)) {
+        indexes_.erase(segment);
+        return nullptr;
+    }
+    // The active segment keeps growing; its index lives in memory only and
+    // is rebuilt when the segment size changes.
+    if (sealed) {
+        index.Save(directory_);
+    }
+    return &index;
+}
+
+}  // namespace app_focus_tracker
@@ -0,0 +1,82 @@
+#ifndef FLUTTER_PLUGIN_FOCUS_QUERY_H_
+#define FLUTTER_PLUGIN_FOCUS_QUERY_H_
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "focus_types.h"
+#include "segment_index.h"
+#include "string_dictionary.h"
+#include "title_index.h"
+
+namespace app_focus_tracker {
+
+struct SessionQuery {
+    // Sessions overlapping [from_us, to_us) are returned.
+    int64_t from_us = std::numeric_limits<int64_t>::min();
+    int64_t to_us = std::numeric_limits<int64_t>::max();
+    bool filter_app = false;
+    uint32_t app_id = 0;
+    // Restricts results to sessions whose title id is in the list.
+    bool filter_titles = false;
+    std::vector<uint32_t> title_ids;
+    // Restricts results to sessions whose title contains this, folding ASCII
+    // case. Resolved to title ids through the index passed to
+    // FocusQueryEngine::SetTitleIndex(); combines with |title_ids|.
+    std::string title_contains;
+};
+
+struct QueryStats {
+    uint32_t segments_scanned = 0;
+    uint32_t segments_skipped = 0;
+    uint64_t rows_read = 0;
+    uint64_t matches = 0;
+    // Segments that could not be opened, indexed or read; the query skips
+    // past them like journal replay does.
+    std::vector<uint32_t> damaged_segments;
+};
+
+// Answers history queries straight from the journal. Segments outside the
+// requested time range are skipped using their index, and app- or
+// title-filtered queries read only the rows listed in the matching posting
+// lists, so their cost scales with the number of matching sessions.
+class FocusQueryEngine {
+public:
+    // Return false to stop the query early.
+    using Visitor = std::function<bool(const FocusSession&)>;
+
+    // |max_cached_indexes| bounds the number of segment indexes kept in
+    // memory between queries; 0 keeps all of them.
+    explicit FocusQueryEngine(std::string directory, size_t max_cached_indexes = 0);
+
+    // Returns false only if the query searches titles and no title index
+    // was set; unreadable segments are skipped and reported in |stats|.
+    bool Query(const SessionQuery& query, const Visitor& visit, QueryStats* stats = nullptr);
+
+    // Titles and their index for SessionQuery::title_contains, e.g. those of
+    // the FocusStore writing |directory|. Both must outlive the engine.
+    void SetTitleIndex(const StringDictionary* titles, const TitleTrigramIndex* index) {
+        titles_ = titles;
+        title_index_ = index;
+    }
+
+    // Drops cached indexes, e.g. after the journal was rewritten.
+    void Invalidate() { indexes_.clear(); }
+
+private:
+    const SegmentIndex* IndexFor(uint32_t segment, bool sealed);
+
+    std::string directory_;
+    size_t max_cached_indexes_;
+    std::map<uint32_t, SegmentIndex> indexes_;
+    const StringDictionary* titles_ = nullptr;
+    const TitleTrigramIndex* title_index_ = nullptr;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_FOCUS_QUERY_H_
@@ -0,0 +1,371 @@
+#include "focus_sampler.h"
+
+#include <algorithm>
+#include <cctype>
+#include <utility>
+
+#include "pipeline_tracing.h"
+#include "tracker_metrics.h"
+
+namespace app_focus_tracker {
+
+namespace {
+
+bool EqualsIgnoreCase(const std::string& a, const std::string& b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](unsigned char x, unsigned char y) {
+               return std::tolower(x) == std::tolower(y);
+           });
+}
+
+bool ContainsName(const std::vector<std::string>& names, const std::string& name) {
+    return std::any_of(names.begin(), names.end(),
+                       [&](const std::string& candidate) { return EqualsIgnoreCase(candidate, name); });
+}
+
+// Counts what the filter rejects as dropped.
+bool Passes(const SpanFilter& filter, const FocusSpan& span) {
+    if (filter.Matches(span)) return true;
+    TrackerMetrics::Get().Add(Counter::kEventsDropped);
+    return false;
+}
+
+std::mutex& InstanceMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::weak_ptr<FocusSampler>& Instance() {
+    static std::weak_ptr<FocusSampler> instance;
+    return instance;
+}
+
+}  // namespace
+
+bool SpanFilter::Matches(const FocusSpan& span) const {
+    if (span.duration_us() < min_duration_us) return false;
+    if (!apps.empty() && !ContainsName(apps, span.app_name)) return false;
+    return !ContainsName(exclude_apps, span.app_name);
+}
+
+std::shared_ptr<FocusSampler> FocusSampler::Acquire(const SourceFactory& factory,
+                                                    std::chrono::milliseconds interval) {
+    return Acquire(factory, ScheduleOptions::Fixed(interval));
+}
+
+std::shared_ptr<FocusSampler> FocusSampler::Acquire(const SourceFactory& factory,
+                                                    const ScheduleOptions& schedule,
+                                                    const IdleSourceFactory& idle_factory) {
+    std::lock_guard<std::mutex> lock(InstanceMutex());
+    std::weak_ptr<FocusSampler>& instance = Instance();
+    std::shared_ptr<FocusSampler> sampler = instance.lock();
+    if (!sampler) {
+        sampler = std::make_shared<FocusSampler>(factory(), schedule,
+                                                 idle_factory ? idle_factory() : nullptr);
+        instance = sampler;
+    }
+    return sampler;
+}
+
+std::shared_ptr<FocusSampler> FocusSampler::Current() {
+    std::lock_guard<std::mutex> lock(InstanceMutex());
+    return Instance().lock();
+}
+
+FocusSampler::FocusSampler(std::unique_ptr<FocusSource> source, std::chrono::milliseconds interval)
+    : FocusSampler(std::move(source), ScheduleOptions::Fixed(interval)) {}
+
+FocusSampler::FocusSampler(std::unique_ptr<FocusSource> source, const ScheduleOptions& schedule,
+                           std::unique_ptr<IdleSource> idle)
+    : clock_(schedule.clock ? schedule.clock : Clock::System()),
+      timers_(10000, clock_->WallNowUs()),
+      budgets_(&timers_),
+      tracker_(std::move(source), [this](const FocusSample& sample) { OnSample(sample); }, schedule,
+               std::move(idle)) {
+    tracker_.set_timers(this);
+}
+
+FocusSampler::~FocusSampler() {
+    tracker_.Stop();
+}
+
+uint64_t FocusSampler::AddBudget(const BudgetRule& rule, FocusBudgets::AlertCallback callback) {
+    uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = budgets_.Add(rule, std::move(callback), clock_->WallNowUs());
+    }
+    tracker_.Wake();
+    return id;
+}
+
+bool FocusSampler::RemoveBudget(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return budgets_.Remove(id);
+}
+
+void FocusSampler::SetUtcOffset(int64_t utc_offset_us) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        budgets_.SetUtcOffset(utc_offset_us, clock_->WallNowUs());
+    }
+    tracker_.Wake();
+}
+
+TimerWheel::TimerId FocusSampler::AddTimer(int64_t due_us, int64_t period_us, TimerWheel::Callback callback) {
+    TimerWheel::TimerId id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = timers_.Schedule(due_us, std::move(callback), period_us);
+    }
+    tracker_.Wake();
+    return id;
+}
+
+bool FocusSampler::CancelTimer(TimerWheel::TimerId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return timers_.Cancel(id);
+}
+
+bool FocusSampler::StartCapture(const std::string& path) {
+    auto writer = std::make_unique<FocusTraceWriter>();
+    if (!writer->Open(path)) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    capture_ = std::move(writer);
+    return true;
+}
+
+int64_t FocusSampler::StopCapture() {
+    std::unique_ptr<FocusTraceWriter> writer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writer = std::move(capture_);
+    }
+    if (!writer) return -1;
+    return writer->Close() ? static_cast<int64_t>(writer->samples()) : -1;
+}
+
+bool FocusSampler::StartRecording(const std::string& directory) {
+    // Opening replays the journal, so it happens before taking the lock.
+    auto store = std::make_unique<FocusStore>();
+    if (!store->Open(directory, FocusStore::Options())) return false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        recording_.swap(store);
+    }
+    return true;
+}
+
+bool FocusSampler::StopRecording() {
+    std::unique_ptr<FocusStore> store;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        store = std::move(recording_);
+    }
+    if (!store) return false;
+    store->Close();
+    return true;
+}
+
+int64_t FocusSampler::NextDue() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return timers_.NextDue();
+}
+
+void FocusSampler::RunDue(int64_t now_us) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    timers_.Advance(now_us);
+}
+
+FocusSampler::SubscriptionId FocusSampler::Subscribe(const SubscriptionOptions& options,
+                                                     Callback callback) {
+    std::lock_guard<std::mutex> lifecycle(lifecycle_mutex_);
+    SubscriptionId id;
+    bool first = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = next_id_++;
+        Subscriber& subscriber = subscribers_[id];
+        subscriber.options = options;
+        subscriber.callback = std::move(callback);
+        first = subscribers_.size() == 1;
+    }
+    if (first) {
+        tracker_.Start();
+        if (locked_) tracker_.Pause();
+    }
+    return id;
+}
+
+void FocusSampler::Unsubscribe(SubscriptionId id) {
+    std::lock_guard<std::mutex> lifecycle(lifecycle_mutex_);
+    Subscriber removed;
+    bool last = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = subscribers_.find(id);
+        if (it == subscribers_.end()) return;
+        removed = std::move(it->second);
+        subscribers_.erase(it);
+        timers_.Cancel(removed.flush_timer);
+        last = subscribers_.empty();
+    }
+    if (!removed.batch.empty() && removed.callback) {
+        removed.callback(removed.batch.data(), removed.batch.size());
+    }
+    if (last) {
+        // Joining happens outside |mutex_|, which the sampling thread takes.
+        tracker_.Stop();
+        std::lock_guard<std::mutex> lock(mutex_);
+        sessionizer_.Reset();
+        current_.Clear();
+        budgets_.Focus(std::string(), clock_->WallNowUs());
+    }
+}
+
+void FocusSampler::SetSessionLocked(bool locked) {
+    std::lock_guard<std::mutex> lifecycle(lifecycle_mutex_);
+    if (locked == locked_) return;
+    locked_ = locked;
+    if (locked) {
+        PostSuspend(clock_->WallNowUs(), true);
+    } else {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            // If the sampling thread has not got to the lock yet, it never
+            // will; otherwise it is paused and resumes below.
+            timers_.Cancel(lock_timer_);
+            lock_timer_ = TimerWheel::kInvalidTimer;
+            suspended_ = false;
+        }
+        tracker_.Resume();
+    }
+}
+
+void FocusSampler::NotifySuspended(int64_t at_us) {
+    PostSuspend(at_us, false);
+}
+
+void FocusSampler::PostSuspend(int64_t at_us, bool pause) {
+    FocusSample sample;
+    sample.kind = SampleKind::kSuspended;
+    sample.timestamp_us = at_us;
+    sample.detected_ns = MonotonicNowNs();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // A timer due at |at_us| fires before any sample taken after it.
+        TimerWheel::TimerId id = timers_.Schedule(at_us, [this, sample, pause](TimerWheel::TimerId, int64_t) {
+            Suspend(sample);
+            if (!pause) return;
+            suspended_ = true;
+            lock_timer_ = TimerWheel::kInvalidTimer;
+            tracker_.Pause();
+        });
+        if (pause) lock_timer_ = id;
+    }
+    tracker_.Wake();
+}
+
+void FocusSampler::Suspend(const FocusSample& sample) {
+    if (capture_) capture_->Append(sample);
+    CloseSpan(sample);
+    // Nothing is sampled until the machine wakes or the session unlocks,
+    // so whatever is waiting in a batch goes out now.
+    for (auto& entry : subscribers_) {
+        if (entry.second.callback) FlushBatch(entry.second);
+    }
+}
+
+size_t FocusSampler::subscriber_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return subscribers_.size();
+}
+
+void FocusSampler::OnSample(const FocusSample& sample) {
+    TracingScope tracing("onSample");
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capture_) capture_->Append(sample);
+    // Timers due before this sample still see the focus it replaces.
+    timers_.Advance(sample.timestamp_us);
+    if (suspended_ && sample.kind == SampleKind::kFocus) return;
+    if (sample.kind != SampleKind::kFocus) {
+        CloseSpan(sample);
+        return;
+    }
+
+    FocusSpan closed;
+    budgets_.Focus(sample.app_name, sample.timestamp_us);
+    bool has_closed = sessionizer_.Push(sample, &closed);
+    current_.Publish(*sessionizer_.current(), sample.timestamp_us);
+
+    FocusSpan raw;
+    raw.start_us = sample.timestamp_us;
+    raw.end_us = sample.timestamp_us + sample.interval_us;
+    raw.window_id = sample.window_id;
+    raw.process_id = sample.process_id;
+    raw.app_name = sample.app_name;
+    raw.title = sample.title;
+    raw.detected_ns = sample.detected_ns;
+    Deliver(&raw, has_closed ? &closed : nullptr, sample.timestamp_us);
+}
+
+void FocusSampler::CloseSpan(const FocusSample& sample) {
+    // Accounting stops when input stopped or the machine went to sleep, not
+    // when we noticed.
+    FocusSpan closed;
+    budgets_.Focus(std::string(), sample.timestamp_us);
+    bool has_closed = sessionizer_.Close(sample.timestamp_us, &closed);
+    closed.detected_ns = sample.detected_ns;
+    current_.Clear();
+    Deliver(nullptr, has_closed ? &closed : nullptr, sample.timestamp_us);
+}
+
+void FocusSampler::Deliver(const FocusSpan* raw, const FocusSpan* closed, int64_t now_us) {
+    TracingScope tracing("deliver");
+    if (closed && recording_) {
+        // Spans are seconds apart, so each one is handed to the OS at once;
+        // the store syncs at its snapshots.
+        recording_->Append(closed->app_name, closed->title, closed->start_us, closed->end_us);
+        recording_->journal().Flush();
+    }
+    for (auto& entry : subscribers_) {
+        SubscriptionId id = entry.first;
+        Subscriber& subscriber = entry.second;
+        if (!subscriber.callback) continue;
+        const SpanFilter& filter = subscriber.options.filter;
+        switch (subscriber.options.granularity) {
+            case Granularity::kRaw:
+                if (raw && Passes(filter, *raw)) subscriber.callback(raw, 1);
+                break;
+            case Granularity::kSpans:
+                if (closed && Passes(filter, *closed)) subscriber.callback(closed, 1);
+                break;
+            case Granularity::kBatched: {
+                if (!closed || !Passes(filter, *closed)) break;
+                if (subscriber.batch.empty()) {
+                    int64_t due_us = now_us + std::chrono::duration_cast<std::chrono::microseconds>(
+                                                  subscriber.options.batch_interval).count();
+                    // Timers fire under |mutex_|, like the fan-out.
+                    subscriber.flush_timer = timers_.Schedule(due_us, [this, id](TimerWheel::TimerId, int64_t) {
+                        auto it = subscribers_.find(id);
+                        if (it != subscribers_.end()) FlushBatch(it->second);
+                    });
+                }
+                subscriber.batch.push_back(*closed);
+                if (subscriber.batch.size() >= subscriber.options.max_batch) FlushBatch(subscriber);
+                break;
+            }
+        }
+    }
+}
+
+void FocusSampler::FlushBatch(Subscriber& subscriber) {
+    timers_.Cancel(subscriber.flush_timer);
+    subscriber.flush_timer = TimerWheel::kInvalidTimer;
+    if (subscriber.batch.empty()) return;
+    TracingScope tracing("flushBatch");
+    subscriber.callback(subscriber.batch.data(), subscriber.batch.size());
+    subscriber.batch.clear();
+}
+
+}  // namespace app_focus_tracker
@@ -0,0 +1,192 @@
+#ifndef FLUTTER_PLUGIN_FOCUS_SAMPLER_H_
+#define FLUTTER_PLUGIN_FOCUS_SAMPLER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "current_focus.h"
+#include "focus_budgets.h"
+#include "focus_source.h"
+#include "focus_store.h"
+#include "focus_trace.h"
+#include "focus_tracker.h"
+#include "sessionizer.h"
+#include "timer_wheel.h"
+
+namespace app_focus_tracker {
+
+enum class Granularity : uint8_t {
+    // One span per sample, covering the time until the next sample.
+    kRaw,
+    // One span each time focus moves away.
+    kSpans,
+    // Closed spans, delivered in groups.
+    kBatched,
+};
+
+// Spans a subscriber is not interested in are dropped before its callback
+// runs, so they are never encoded or sent anywhere.
+struct SpanFilter {
+    // When non-empty, only spans of these apps pass. Names compare without
+    // regard to ASCII case, since Windows process names are case-insensitive.
+    std::vector<std::string> apps;
+    std::vector<std::string> exclude_apps;
+    int64_t min_duration_us = 0;
+
+    bool empty() const { return apps.empty() && exclude_apps.empty() && min_duration_us <= 0; }
+    bool Matches(const FocusSpan& span) const;
+};
+
+struct SubscriptionOptions {
+    Granularity granularity = Granularity::kRaw;
+    SpanFilter filter;
+    // Batched subscribers receive their spans once this much time has passed
+    // since the first undelivered one, or once |max_batch| have piled up.
+    // The deadline is a timer of its own, so it holds while no samples
+    // arrive, e.g. while the user is idle.
+    std::chrono::milliseconds batch_interval = std::chrono::seconds(10);
+    size_t max_batch = 100;
+};
+
+// Process-wide sampling service. A single FocusTracker thread samples the
+// OS and fans every observation out to any number of subscribers, each at
+// its own granularity, so extra engines or listeners cost a callback rather
+// than another thread and another set of OS calls. The thread only runs
+// while at least one subscription exists. While the user is idle, the
+// machine sleeps or the session is locked, the open span is closed at the
+// moment that began and nothing is delivered or charged.
+class FocusSampler : private TrackerTimers {
+public:
+    using SourceFactory = std::function<std::unique_ptr<FocusSource>()>;
+    using IdleSourceFactory = std::function<std::unique_ptr<IdleSource>()>;
+    // Receives |count| spans. Runs on the sampling thread with the
+    // subscriber list locked, so it must be quick and must not call back
+    // into Subscribe() or Unsubscribe(). An empty callback keeps the sampler
+    // running without receiving anything, e.g. for readers of current().
+    using Callback = std::function<void(const FocusSpan* spans, size_t count)>;
+    using SubscriptionId = uint64_t;
+
+    // Returns the sampler shared by the whole process, creating it from
+    // |factory| if no other owner currently holds it.
+    static std::shared_ptr<FocusSampler> Acquire(
+        const SourceFactory& factory,
+        std::chrono::milliseconds interval = std::chrono::seconds(1));
+    static std::shared_ptr<FocusSampler> Acquire(const SourceFactory& factory,
+                                                 const ScheduleOptions& schedule,
+                                                 const IdleSourceFactory& idle_factory = nullptr);
+    // The shared sampler if one is alive, without creating it.
+    static std::shared_ptr<FocusSampler> Current();
+
+    explicit FocusSampler(std::unique_ptr<FocusSource> source,
+                          std::chrono::milliseconds interval = std::chrono::seconds(1));
+    FocusSampler(std::unique_ptr<FocusSource> source, const ScheduleOptions& schedule,
+                 std::unique_ptr<IdleSource> idle = nullptr);
+    ~FocusSampler() override;
+    FocusSampler(const FocusSampler&) = delete;
+    FocusSampler& operator=(const FocusSampler&) = delete;
+
+    SubscriptionId Subscribe(const SubscriptionOptions& options, Callback callback);
+    // Once this returns the callback is never invoked again. Spans still
+    // waiting in a batch are delivered first.
+    void Unsubscribe(SubscriptionId id);
+
+    // While locked the sampling thread is paused outright. Locking hands it
+    // a task that closes the open span at the moment of locking and flushes
+    // pending batches before it pauses; this returns without waiting.
+    void SetSessionLocked(bool locked);
+    // Has the sampling thread close the open span at |at_us| and flush
+    // pending batches, e.g. from a power notification that the machine is
+    // about to sleep. Returns without waiting; sampling resumes on its own.
+    void NotifySuspended(int64_t at_us);
+
+    size_t subscriber_count() const;
+    TrackerState state() const { return tracker_.state(); }
+    // Latest focus, updated on every sample while the sampler runs.
+    const CurrentFocusSlot& current() const { return current_; }
+
+    // Daily focus budgets, charged while the sampler runs. Alerts are raised
+    // on the sampling thread under the same rules as subscription callbacks.
+    uint64_t AddBudget(const BudgetRule& rule, FocusBudgets::AlertCallback callback);
+    bool RemoveBudget(uint64_t id);
+    // Budget days start at local midnight; the platform layer passes the
+    // local time zone's offset from UTC, again whenever it changes.
+    void SetUtcOffset(int64_t utc_offset_us);
+    // Runs |callback| on the sampling thread at |due_us| and then every
+    // |period_us| if positive, e.g. for periodic flushes.
+    TimerWheel::TimerId AddTimer(int64_t due_us, int64_t period_us, TimerWheel::Callback callback);
+    bool CancelTimer(TimerWheel::TimerId id);
+
+    // Records every sample, as the tracker produced it, to a trace at
+    // |path| (see FocusTraceWriter), replacing any capture in progress.
+    bool StartCapture(const std::string& path);
+    // Returns the number of samples captured, or -1 if nothing was being
+    // captured or the trace could not be written.
+    int64_t StopCapture();
+
+    // Appends every closed span to a FocusStore in |directory|, the history
+    // AppFocusTrackerExportHistory reads, replacing any recording in
+    // progress. Returns false if the store cannot be opened.
+    bool StartRecording(const std::string& directory);
+    // Closes the store, writing its final snapshot. Returns false if
+    // nothing was being recorded.
+    bool StopRecording();
+
+private:
+    struct Subscriber {
+        SubscriptionOptions options;
+        Callback callback;
+        std::vector<FocusSpan> batch;
+        // Flushes |batch| at its deadline; armed while it is not empty.
+        TimerWheel::TimerId flush_timer = TimerWheel::kInvalidTimer;
+    };
+
+    void OnSample(const FocusSample& sample);
+    // Closes the open span at a non-focus sample's time.
+    void CloseSpan(const FocusSample& sample);
+    // Schedules Suspend() on the sampling thread, pausing it afterwards if
+    // |pause|.
+    void PostSuspend(int64_t at_us, bool pause);
+    // Runs from a timer: closes the open span and flushes every batch.
+    void Suspend(const FocusSample& sample);
+    // Fans a sample's raw span and any span it closed out to subscribers.
+    void Deliver(const FocusSpan* raw, const FocusSpan* closed, int64_t now_us);
+    // Hands |subscriber|'s batch to its callback and disarms the deadline.
+    void FlushBatch(Subscriber& subscriber);
+    // TrackerTimers
+    int64_t NextDue() override;
+    void RunDue(int64_t now_us) override;
+
+    // Serializes Subscribe/Unsubscribe/SetSessionLocked, which start, stop
+    // and pause the tracker.
+    std::mutex lifecycle_mutex_;
+    bool locked_ = false;
+    // Guards the subscriber list and the sessionizer against the fan-out.
+    mutable std::mutex mutex_;
+    std::map<SubscriptionId, Subscriber> subscribers_;
+    // Set once the sampling thread has handled a lock; focus samples still
+    // in flight are dropped.
+    bool suspended_ = false;
+    // The pending task a lock posted, until the sampling thread runs it.
+    TimerWheel::TimerId lock_timer_ = TimerWheel::kInvalidTimer;
+    SubscriptionId next_id_ = 1;
+    // Same clock as |tracker_|'s, which timers and budgets run on.
+    Clock* clock_;
+    Sessionizer sessionizer_;
+    CurrentFocusSlot current_;
+    std::unique_ptr<FocusTraceWriter> capture_;
+    std::unique_ptr<FocusStore> recording_;
+    TimerWheel timers_;
+    FocusBudgets budgets_;
+    FocusTracker tracker_;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_FOCUS_SAMPLER_H_
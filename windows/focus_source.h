@@ -0,0 +1,54 @@
+#ifndef FLUTTER_PLUGIN_FOCUS_SOURCE_H_
+#define FLUTTER_PLUGIN_FOCUS_SOURCE_H_
+
+#include <cstdint>
+#include <string>
+
+namespace app_focus_tracker {
+
+enum class SampleKind : uint8_t {
+    // A window had (or nothing had) focus.
+    kFocus,
+    // The user stopped giving input at |timestamp_us|.
+    kIdle,
+    // The machine slept, or the session was locked, from |timestamp_us|.
+    kSuspended,
+};
+
+// One observation of the foreground window.
+struct FocusSample {
+    int64_t timestamp_us = 0;
+    // Time until the tracker samples again.
+    int64_t interval_us = 0;
+    // Anything but kFocus is set by the tracker, with only |timestamp_us|
+    // filled in.
+    SampleKind kind = SampleKind::kFocus;
+    // MonotonicNowNs() when the tracker read the OS, for latency stamps.
+    int64_t detected_ns = 0;
+    uint64_t window_id = 0;
+    uint32_t process_id = 0;
+    std::string app_name;
+    std::string title;
+};
+
+// Platform hook that reports which window currently has focus.
+class FocusSource {
+public:
+    virtual ~FocusSource() = default;
+
+    // Fills everything but |timestamp_us|, |interval_us| and |kind|.
+    // Returns false if no window is focused or it could not be inspected.
+    // Sources with slow_titles() leave |title| empty.
+    virtual bool Sample(FocusSample* sample) = 0;
+
+    // True if looking up a title can block, e.g. on a hung window. The
+    // tracker then calls FetchTitle() on a helper thread with a deadline.
+    virtual bool slow_titles() const { return false; }
+    // Looks up the title of the window in |sample|. Only one call runs at
+    // a time, but it may overlap Sample().
+    virtual bool FetchTitle(const FocusSample& /*sample*/, std::string* /*title*/) { return false; }
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_FOCUS_SOURCE_H_
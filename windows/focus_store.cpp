@@ -0,0 +1,176 @@
+#include "focus_store.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+#include "binary_io.h"
+#include "file_util.h"
+#include "journal_replay.h"
+
+namespace app_focus_tracker {
+
+namespace {
+
+constexpr char kSnapshotMagic[4] = {'A', 'F', 'T', 'S'};
+// Version 2 lists the dictionaries' placeholder ids.
+constexpr uint32_t kSnapshotVersion = 2;
+
+bool PositionExists(const std::string& directory, const JournalPosition& position) {
+    std::error_code ec;
+    uint64_t size = std::filesystem::file_size(FocusJournal::SegmentPath(directory, position.segment), ec);
+    return !ec && position.offset >= kJournalSegmentHeaderSize && position.offset <= size;
+}
+
+}  // namespace
+
+FocusStore::~FocusStore() {
+    Close();
+}
+
+bool FocusStore::Open(const std::string& directory, const Options& options) {
+    Close();
+    auto started = std::chrono::steady_clock::now();
+    directory_ = directory;
+    options_ = options;
+    apps_.Clear();
+    titles_.Clear();
+    title_index_.Clear();
+    aggregates_ = FocusAggregates(options.aggregates);
+    open_stats_ = OpenStats();
+
+    if (!options.read_only && !journal_.Open(directory, options.journal)) return false;
+
+    JournalPosition from;
+    if (LoadSnapshot(&from)) {
+        open_stats_.snapshot_loaded = true;
+        open_stats_.snapshot_position = from;
+    } else {
+        apps_.Clear();
+        titles_.Clear();
+        aggregates_ = FocusAggregates(options.aggregates);
+        auto segments = FocusJournal::ListSegments(directory);
+        from = {segments.empty() ? 1 : segments.front(), kJournalSegmentHeaderSize};
+    }
+    if (!Replay(from)) {
+        journal_.Close();
+        return false;
+    }
+    title_index_.Update(titles_);
+    bytes_at_last_snapshot_ = journal_.bytes_appended();
+    open_ = true;
+    open_stats_.elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started).count();
+    return true;
+}
+
+void FocusStore::Close() {
+    open_ = false;
+    if (!journal_.is_open()) return;
+    WriteSnapshot();
+    journal_.Close();
+}
+
+bool FocusStore::Append(const std::string& app_name, const std::string& title,
+                        int64_t start_us, int64_t end_us) {
+    if (!journal_.is_open()) return false;
+    JournalRecord record;
+    bool inserted = false;
+
+    uint32_t app_id = apps_.Intern(app_name, &inserted);
+    if (inserted) {
+        record.type = JournalRecordType::kAppName;
+        record.id = app_id;
+        record.text = app_name;
+        if (!journal_.Append(record)) return false;
+    }
+    uint32_t title_id = titles_.Intern(title, &inserted);
+    if (inserted) {
+        title_index_.Update(titles_);
+        record.type = JournalRecordType::kTitle;
+        record.id = title_id;
+        record.text = title;
+        if (!journal_.Append(record)) return false;
+    }
+
+    record.type = JournalRecordType::kSession;
+    record.text.clear();
+    record.session = FocusSession{start_us, end_us, app_id, title_id};
+    if (!journal_.Append(record)) return false;
+    aggregates_.Apply(record.session);
+
+    if (options_.snapshot_interval_bytes > 0 &&
+        journal_.bytes_appended() - bytes_at_last_snapshot_ >= options_.snapshot_interval_bytes) {
+        WriteSnapshot();
+    }
+    return true;
+}
+
+bool FocusStore::WriteSnapshot() {
+    if (!journal_.is_open()) return false;
+    // The snapshot must never claim records that are not on disk yet.
+    if (!journal_.Sync()) return false;
+    JournalPosition position = journal_.end();
+
+    std::string data(kSnapshotMagic, sizeof(kSnapshotMagic));
+    PutU32(data, kSnapshotVersion);
+    PutU32(data, position.segment);
+    PutU64(data, position.offset);
+    apps_.Serialize(&data);
+    titles_.Serialize(&data);
+    aggregates_.Serialize(&data);
+    PutU32(data, Crc32(data.data(), data.size()));
+
+    if (!WriteFileAtomically(SnapshotPath(directory_), data)) return false;
+    bytes_at_last_snapshot_ = journal_.bytes_appended();
+    return true;
+}
+
+std::string FocusStore::SnapshotPath(const std::string& directory) {
+    return (std::filesystem::path(directory) / "aggregates.snap").string();
+}
+
+bool FocusStore::LoadSnapshot(JournalPosition* position) {
+    std::string data;
+    if (!ReadFile(SnapshotPath(directory_), &data) || data.size() < 12) return false;
+    size_t body = data.size() - 4;
+    if (Crc32(data.data(), body) != LoadU32(reinterpret_cast<const uint8_t*>(data.data() + body)) ||
+        std::memcmp(data.data(), kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) {
+        return false;
+    }
+
+    ByteReader in(data.data() + sizeof(kSnapshotMagic), body - sizeof(kSnapshotMagic));
+    uint32_t version = 0;
+    if (!in.ReadU32(&version) || version != kSnapshotVersion) return false;
+    in.ReadU32(&position->segment);
+    in.ReadU64(&position->offset);
+    if (!in.ok() || !PositionExists(directory_, *position)) return false;
+    return apps_.Deserialize(in) && titles_.Deserialize(in) && aggregates_.Deserialize(in);
+}
+
+bool FocusStore::Replay(JournalPosition from) {
+    ReplayOptions options;
+    options.aggregates = options_.aggregates;
+    ReplayResult result = ReplayJournal(directory_, from, options);
+    // Damaged or missing segments are skipped past rather than failing the
+    // open; whatever was recoverable is still applied. Dictionary ids defined
+    // in what was lost become empty placeholders, so the ids after them still
+    // line up and new strings never take an id old sessions refer to.
+    open_stats_.damaged_segments = result.damaged_segments.size();
+    for (const auto& entry : result.app_names) {
+        open_stats_.missing_names += apps_.PadTo(entry.first);
+        if (!apps_.Assign(entry.first, entry.second)) return false;
+    }
+    for (const auto& entry : result.titles) {
+        open_stats_.missing_names += titles_.PadTo(entry.first);
+        if (!titles_.Assign(entry.first, entry.second)) return false;
+    }
+    open_stats_.missing_names += apps_.PadTo(result.app_id_end);
+    open_stats_.missing_names += titles_.PadTo(result.title_id_end);
+    aggregates_.Merge(result.aggregates);
+    open_stats_.replayed_records = result.records;
+    return true;
+}
+
+}  // namespace app_focus_tracker
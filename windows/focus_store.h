@@ -0,0 +1,87 @@
+#ifndef FLUTTER_PLUGIN_FOCUS_STORE_H_
+#define FLUTTER_PLUGIN_FOCUS_STORE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "focus_aggregates.h"
+#include "focus_journal.h"
+#include "string_dictionary.h"
+#include "title_index.h"
+
+namespace app_focus_tracker {
+
+// Durable focus history: the journal plus the in-memory dictionaries and
+// aggregates derived from it. The derived state is checkpointed to a
+// snapshot together with the journal position it covers, so opening the
+// store only replays records written after the last checkpoint.
+//
+// Not thread-safe; callers serialize access.
+class FocusStore {
+public:
+    struct Options {
+        FocusJournal::Options journal;
+        AggregateOptions aggregates;
+        // Journal bytes appended between automatic snapshots; 0 disables them.
+        uint64_t snapshot_interval_bytes = 1u << 20;
+        // Loads the current state without opening the journal for appends,
+        // e.g. to read history that another store instance is writing.
+        bool read_only = false;
+    };
+
+    struct OpenStats {
+        bool snapshot_loaded = false;
+        JournalPosition snapshot_position;
+        uint64_t replayed_records = 0;
+        size_t damaged_segments = 0;
+        // Dictionary entries whose definitions were lost with a damaged or
+        // missing segment; they read back as empty strings.
+        size_t missing_names = 0;
+        int64_t elapsed_us = 0;
+    };
+
+    FocusStore() = default;
+    ~FocusStore();
+    FocusStore(const FocusStore&) = delete;
+    FocusStore& operator=(const FocusStore&) = delete;
+
+    bool Open(const std::string& directory, const Options& options);
+    // Writes a final snapshot and closes the journal.
+    void Close();
+    bool is_open() const { return open_; }
+
+    // Records a closed session, interning |app_name| and |title|.
+    bool Append(const std::string& app_name, const std::string& title,
+                int64_t start_us, int64_t end_us);
+    bool WriteSnapshot();
+
+    const FocusAggregates& aggregates() const { return aggregates_; }
+    const StringDictionary& apps() const { return apps_; }
+    const StringDictionary& titles() const { return titles_; }
+    // Covers every title in titles(), including ones appended since Open().
+    const TitleTrigramIndex& title_index() const { return title_index_; }
+    const OpenStats& open_stats() const { return open_stats_; }
+    FocusJournal& journal() { return journal_; }
+    const std::string& directory() const { return directory_; }
+
+    static std::string SnapshotPath(const std::string& directory);
+
+private:
+    bool LoadSnapshot(JournalPosition* position);
+    bool Replay(JournalPosition from);
+
+    std::string directory_;
+    Options options_;
+    FocusJournal journal_;
+    StringDictionary apps_;
+    StringDictionary titles_;
+    TitleTrigramIndex title_index_;
+    FocusAggregates aggregates_;
+    OpenStats open_stats_;
+    uint64_t bytes_at_last_snapshot_ = 0;
+    bool open_ = false;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_FOCUS_STORE_H_
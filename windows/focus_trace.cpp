@@ -0,0 +1,206 @@
+#include "focus_trace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "binary_io.h"
+#include "file_util.h"
+
+namespace app_focus_tracker {
+
+namespace {
+
+constexpr char kTraceMagic[4] = {'A', 'F', 'T', 'T'};
+constexpr uint32_t kTraceVersion = 1;
+constexpr size_t kTraceHeaderSize = 8;
+constexpr size_t kFlushBytes = 64 * 1024;
+
+enum TraceRecord : uint8_t {
+    kFocusRecord = 0,
+    kIdleRecord = 1,
+    kSuspendedRecord = 2,
+    kAppNameRecord = 3,
+    kTitleRecord = 4,
+};
+
+uint64_t ZigZag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t UnZigZag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+bool ReadVarU32(ByteReader& in, uint32_t* value) {
+    uint64_t wide = 0;
+    if (!in.ReadVarU64(&wide) || wide > UINT32_MAX) return false;
+    *value = static_cast<uint32_t>(wide);
+    return true;
+}
+
+}  // namespace
+
+FocusTraceWriter::~FocusTraceWriter() {
+    Close();
+}
+
+bool FocusTraceWriter::Open(const std::string& path) {
+    Close();
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) return false;
+    failed_ = false;
+    buffer_.assign(kTraceMagic, sizeof(kTraceMagic));
+    PutU32(buffer_, kTraceVersion);
+    last_timestamp_us_ = 0;
+    app_ids_.clear();
+    title_ids_.clear();
+    samples_ = 0;
+    bytes_ = 0;
+    return Flush();
+}
+
+uint32_t FocusTraceWriter::Define(std::unordered_map<std::string, uint32_t>& ids, uint8_t kind,
+                                  const std::string& text) {
+    auto it = ids.find(text);
+    if (it != ids.end()) return it->second;
+    uint32_t id = static_cast<uint32_t>(ids.size());
+    ids.emplace(text, id);
+    PutU8(buffer_, kind);
+    PutString(buffer_, text);
+    return id;
+}
+
+bool FocusTraceWriter::Append(const FocusSample& sample) {
+    if (!file_) return false;
+    if (sample.kind == SampleKind::kFocus) {
+        uint32_t app_id = Define(app_ids_, kAppNameRecord, sample.app_name);
+        uint32_t title_id = Define(title_ids_, kTitleRecord, sample.title);
+        PutU8(buffer_, kFocusRecord);
+        PutVarU64(buffer_, ZigZag(sample.timestamp_us - last_timestamp_us_));
+        PutVarU64(buffer_, static_cast<uint64_t>(std::max<int64_t>(sample.interval_us, 0)));
+        PutVarU64(buffer_, sample.window_id);
+        PutVarU64(buffer_, sample.process_id);
+        PutVarU64(buffer_, app_id);
+        PutVarU64(buffer_, title_id);
+    } else {
+        PutU8(buffer_, sample.kind == SampleKind::kIdle ? kIdleRecord : kSuspendedRecord);
+        PutVarU64(buffer_, ZigZag(sample.timestamp_us - last_timestamp_us_));
+    }
+    last_timestamp_us_ = sample.timestamp_us;
+    ++samples_;
+    return buffer_.size() < kFlushBytes || Flush();
+}
+
+bool FocusTraceWriter::Flush() {
+    if (!buffer_.empty()) {
+        if (std::fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size()) failed_ = true;
+        bytes_ += buffer_.size();
+        buffer_.clear();
+    }
+    return !failed_;
+}
+
+bool FocusTraceWriter::Close() {
+    if (!file_) return !failed_;
+    Flush();
+    if (std::fclose(file_) != 0) failed_ = true;
+    file_ = nullptr;
+    return !failed_;
+}
+
+bool ReadFocusTrace(const std::string& path, std::vector<FocusSample>* samples) {
+    std::string contents;
+    if (!ReadFile(path, &contents)) return false;
+    if (contents.size() < kTraceHeaderSize || std::memcmp(contents.data(), kTraceMagic, sizeof(kTraceMagic)) != 0 ||
+        LoadU32(reinterpret_cast<const uint8_t*>(contents.data()) + 4) != kTraceVersion) {
+        return false;
+    }
+
+    ByteReader in(contents.data() + kTraceHeaderSize, contents.size() - kTraceHeaderSize);
+    std::vector<std::string> apps;
+    std::vector<std::string> titles;
+    int64_t timestamp_us = 0;
+    samples->clear();
+    while (in.remaining() > 0) {
+        uint8_t kind = 0;
+        in.ReadU8(&kind);
+        FocusSample sample;
+        uint64_t delta = 0;
+        switch (kind) {
+            case kAppNameRecord:
+            case kTitleRecord: {
+                std::string text;
+                if (!in.ReadString(&text)) return true;
+                (kind == kAppNameRecord ? apps : titles).push_back(std::move(text));
+                continue;
+            }
+            case kFocusRecord: {
+                uint64_t interval = 0;
+                uint32_t app_id = 0;
+                uint32_t title_id = 0;
+                if (!in.ReadVarU64(&delta) || !in.ReadVarU64(&interval) || !in.ReadVarU64(&sample.window_id) ||
+                    !ReadVarU32(in, &sample.process_id) || !ReadVarU32(in, &app_id) ||
+                    !ReadVarU32(in, &title_id) || app_id >= apps.size() || title_id >= titles.size()) {
+                    return true;
+                }
+                sample.interval_us = static_cast<int64_t>(interval);
+                sample.app_name = apps[app_id];
+                sample.title = titles[title_id];
+                break;
+            }
+            case kIdleRecord:
+            case kSuspendedRecord:
+                if (!in.ReadVarU64(&delta)) return true;
+                sample.kind = kind == kIdleRecord ? SampleKind::kIdle : SampleKind::kSuspended;
+                break;
+            default:
+                // A torn or foreign tail; keep what was intact.
+                return true;
+        }
+        timestamp_us += UnZigZag(delta);
+        sample.timestamp_us = timestamp_us;
+        samples->push_back(std::move(sample));
+    }
+    return true;
+}
+
+TraceReplaySource::TraceReplaySource(std::vector<FocusSample> trace, Speed speed, Clock* clock)
+    : speed_(speed), clock_(clock ? clock : Clock::System()) {
+    for (FocusSample& sample : trace) {
+        if (sample.kind == SampleKind::kFocus) trace_.push_back(std::move(sample));
+    }
+    finished_ = trace_.empty();
+}
+
+bool TraceReplaySource::Sample(FocusSample* sample) {
+    if (finished_) return false;
+    size_t index = next_;
+    if (speed_ == Speed::kOriginal) {
+        auto now = clock_->SteadyNow();
+        if (!started_) {
+            start_ = now;
+            started_ = true;
+        }
+        // The latest recorded sample at this offset into the recording.
+        int64_t offset_us = std::chrono::duration_cast<std::chrono::microseconds>(now - start_).count();
+        int64_t target_us = trace_.front().timestamp_us + offset_us;
+        while (next_ + 1 < trace_.size() && trace_[next_ + 1].timestamp_us <= target_us) ++next_;
+        index = next_;
+        const FocusSample& last = trace_.back();
+        finished_ = target_us >= last.timestamp_us + std::max<int64_t>(last.interval_us, 1);
+        if (finished_) return false;
+    } else {
+        ++next_;
+        finished_ = next_ >= trace_.size();
+    }
+    const FocusSample& recorded = trace_[index];
+    sample->window_id = recorded.window_id;
+    sample->process_id = recorded.process_id;
+    sample->app_name = recorded.app_name;
+    sample->title = recorded.title;
+    ++replayed_;
+    return true;
+}
+
+}  // namespace app_focus_tracker
@@ -0,0 +1,97 @@
+#ifndef FLUTTER_PLUGIN_FOCUS_TRACE_H_
+#define FLUTTER_PLUGIN_FOCUS_TRACE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "clock.h"
+#include "focus_source.h"
+
+namespace app_focus_tracker {
+
+// Raw samples exactly as the tracker produced them, for reproducing
+// workloads in tests, benchmarks and bug reports. After an 8-byte header a
+// trace is a sequence of records:
+//
+//   kind u8 = 0 (focus): varint zigzag(timestamp delta), varint interval,
+//       varint window id, varint pid, varint app id, varint title id
+//   kind u8 = 1 (idle) or 2 (suspended): varint zigzag(timestamp delta)
+//   kind u8 = 3 (app name) or 4 (title): string defining the next id
+//
+// Timestamps are deltas from the previous record and names are sent once,
+// so a steady sample costs about fifteen bytes. A torn final record is ignored.
+class FocusTraceWriter {
+public:
+    FocusTraceWriter() = default;
+    ~FocusTraceWriter();
+    FocusTraceWriter(const FocusTraceWriter&) = delete;
+    FocusTraceWriter& operator=(const FocusTraceWriter&) = delete;
+
+    // Creates or truncates |path|.
+    bool Open(const std::string& path);
+    bool Append(const FocusSample& sample);
+    // Flushes and closes; returns false if any write failed.
+    bool Close();
+    bool is_open() const { return file_ != nullptr; }
+
+    uint64_t samples() const { return samples_; }
+    uint64_t bytes() const { return bytes_; }
+
+private:
+    uint32_t Define(std::unordered_map<std::string, uint32_t>& ids, uint8_t kind, const std::string& text);
+    bool Flush();
+
+    std::FILE* file_ = nullptr;
+    bool failed_ = false;
+    std::string buffer_;
+    int64_t last_timestamp_us_ = 0;
+    std::unordered_map<std::string, uint32_t> app_ids_;
+    std::unordered_map<std::string, uint32_t> title_ids_;
+    uint64_t samples_ = 0;
+    uint64_t bytes_ = 0;
+};
+
+// Reads every intact sample of the trace at |path|. Returns false if the
+// file cannot be read or is not a trace.
+bool ReadFocusTrace(const std::string& path, std::vector<FocusSample>* samples);
+
+// Feeds a recorded trace back into a tracker. Only focus samples are
+// replayed: idle and suspend come from the tracker's own IdleSource and
+// clock. Sample() fails once the trace is exhausted.
+class TraceReplaySource : public FocusSource {
+public:
+    enum class Speed {
+        // Each Sample() returns the next recorded sample, whatever the time.
+        kAsFastAsPossible,
+        // Sample() returns the sample that was current at the same offset
+        // from the start of the recording, measured on |clock|.
+        kOriginal,
+    };
+
+    TraceReplaySource(std::vector<FocusSample> trace, Speed speed, Clock* clock = nullptr);
+
+    bool Sample(FocusSample* sample) override;
+
+    // True once the last sample has been replayed (kAsFastAsPossible) or
+    // its time has passed (kOriginal).
+    bool finished() const { return finished_; }
+    size_t replayed() const { return replayed_; }
+
+private:
+    std::vector<FocusSample> trace_;
+    Speed speed_;
+    Clock* clock_;
+    size_t next_ = 0;
+    size_t replayed_ = 0;
+    bool finished_ = false;
+    bool started_ = false;
+    Clock::SteadyTime start_;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_FOCUS_TRACE_H_
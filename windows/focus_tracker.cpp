@@ -0,0 +1,237 @@
+#include "focus_tracker.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "pipeline_tracing.h"
+#include "tracker_metrics.h"
+
+namespace app_focus_tracker {
+
+FocusTracker::FocusTracker(std::unique_ptr<FocusSource> source, SampleCallback callback,
+                           std::chrono::milliseconds interval)
+    : FocusTracker(std::move(source), std::move(callback), ScheduleOptions::Fixed(interval)) {}
+
+FocusTracker::FocusTracker(std::unique_ptr<FocusSource> source, SampleCallback callback,
+                           const ScheduleOptions& schedule, std::unique_ptr<IdleSource> idle)
+    : clock_(schedule.clock ? schedule.clock : Clock::System()),
+      source_(std::move(source)),
+      idle_(std::move(idle)),
+      callback_(std::move(callback)),
+      scheduler_(schedule),
+      idle_threshold_(schedule.idle_threshold),
+      idle_interval_(schedule.idle_interval),
+      suspend_threshold_(schedule.suspend_threshold),
+      qos_(schedule.qos) {
+    if (source_->slow_titles()) {
+        titles_ = std::make_unique<TitleFetcher>(source_, schedule.title_timeout, schedule.qos);
+    }
+}
+
+FocusTracker::~FocusTracker() {
+    Stop();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool FocusTracker::Start() {
+    if (std::this_thread::get_id() == worker_id_.load()) return false;
+    std::lock_guard<std::mutex> lifecycle(lifecycle_mutex_);
+    TrackerState state = state_.load();
+    if (state != TrackerState::kIdle && state != TrackerState::kStopping) return false;
+    // A thread told to stop from its own callback has not been joined yet.
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    state_.store(TrackerState::kRunning, std::memory_order_release);
+    clock_->ThreadStarting();
+    thread_ = std::thread(&FocusTracker::Run, this);
+    return true;
+}
+
+bool FocusTracker::Pause() {
+    return Transition(TrackerState::kRunning, TrackerState::kPaused);
+}
+
+bool FocusTracker::Resume() {
+    return Transition(TrackerState::kPaused, TrackerState::kRunning);
+}
+
+void FocusTracker::Stop() {
+    bool on_worker = std::this_thread::get_id() == worker_id_.load();
+    std::unique_lock<std::mutex> lifecycle(lifecycle_mutex_, std::defer_lock);
+    if (!on_worker) {
+        lifecycle.lock();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state_.load() != TrackerState::kIdle) {
+            state_.store(TrackerState::kStopping, std::memory_order_release);
+        }
+    }
+    wake_.notify_all();
+    if (on_worker) return;
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    state_.store(TrackerState::kIdle, std::memory_order_release);
+}
+
+void FocusTracker::Wake() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        timers_changed_ = true;
+    }
+    wake_.notify_all();
+}
+
+bool FocusTracker::Transition(TrackerState from, TrackerState to) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!state_.compare_exchange_strong(from, to, std::memory_order_acq_rel)) return false;
+    }
+    wake_.notify_all();
+    return true;
+}
+
+void FocusTracker::Run() {
+    worker_id_.store(std::this_thread::get_id());
+    ApplyThreadQos(qos_);
+    PipelineTracing::SetThreadName("focus sampler");
+    scheduler_.Reset();
+    FocusSample previous;
+    bool has_previous = false;
+    bool was_idle = false;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        TrackerState state = state_.load(std::memory_order_acquire);
+        if (state == TrackerState::kStopping) break;
+        TrackerMetrics::Get().Add(Counter::kWakeups);
+        if (state == TrackerState::kPaused) {
+            clock_->WaitUntil(lock, wake_, Clock::SteadyTime::max(),
+                              [this] { return state_.load() != TrackerState::kPaused; });
+            scheduler_.Reset();
+            continue;
+        }
+
+        lock.unlock();
+        int64_t idle_us = 0;
+        if (idle_ && idle_->IdleTime(&idle_us) &&
+            idle_us >= std::chrono::duration_cast<std::chrono::microseconds>(idle_threshold_).count()) {
+            auto now = clock_->SteadyNow();
+            if (!was_idle) {
+                FocusSample sample;
+                sample.kind = SampleKind::kIdle;
+                sample.timestamp_us = clock_->WallNowUs() - idle_us;
+                sample.detected_ns = MonotonicNowNs();
+                callback_(sample);
+                was_idle = true;
+                has_previous = false;
+            }
+            scheduler_.Reset();
+            lock.lock();
+            WaitForSample(lock, now + idle_interval_);
+            continue;
+        }
+        was_idle = false;
+
+        FocusSample sample;
+        bool sampled;
+        {
+            TracingScope tracing("sample");
+            sampled = source_->Sample(&sample);
+            TrackerMetrics::Get().Add(Counter::kSamples);
+            if (sampled && titles_) {
+                sample.title = titles_->Fetch(sample);
+            }
+        }
+        sample.detected_ns = MonotonicNowNs();
+        auto now = clock_->SteadyNow();
+        auto wall_now = clock_->WallNow();
+        // Losing or regaining a window counts as a change; two failed
+        // samples in a row do not.
+        bool changed = sampled != has_previous ||
+                       (sampled && (sample.window_id != previous.window_id ||
+                                    sample.app_name != previous.app_name || sample.title != previous.title));
+        auto deadline = scheduler_.Next(changed, now, wall_now);
+        if (sampled) {
+            sample.timestamp_us =
+                std::chrono::duration_cast<std::chrono::microseconds>(wall_now.time_since_epoch()).count();
+            sample.interval_us = std::chrono::duration_cast<std::chrono::microseconds>(deadline - now).count();
+            callback_(sample);
+            previous = std::move(sample);
+        }
+        has_previous = sampled;
+        lock.lock();
+
+        if (WaitForSample(lock, deadline)) {
+            scheduler_.Reset();
+            has_previous = false;
+        }
+    }
+    worker_id_.store(std::thread::id());
+    lock.unlock();
+    clock_->ThreadExited();
+}
+
+bool FocusTracker::WaitForSample(std::unique_lock<std::mutex>& lock,
+                                 std::chrono::steady_clock::time_point deadline) {
+    while (state_.load() == TrackerState::kRunning) {
+        auto wake_at = deadline;
+        bool timer_first = false;
+        timers_changed_ = false;
+        if (timers_) {
+            // The timers take their owner's lock, so ask without holding ours.
+            lock.unlock();
+            int64_t due_us = timers_->NextDue();
+            auto now = clock_->SteadyNow();
+            int64_t wall_us = clock_->WallNowUs();
+            lock.lock();
+            if (due_us != std::numeric_limits<int64_t>::max()) {
+                auto timer_at = now + std::chrono::microseconds(std::max<int64_t>(due_us - wall_us, 0));
+                if (timer_at < deadline) {
+                    wake_at = timer_at;
+                    timer_first = true;
+                }
+            }
+        }
+        auto slept = clock_->SteadyNow();
+        int64_t slept_wall_us = clock_->WallNowUs();
+        clock_->WaitUntil(lock, wake_, wake_at, [this] {
+            return state_.load() != TrackerState::kRunning || timers_changed_;
+        });
+        if (state_.load() != TrackerState::kRunning) return false;
+
+        // Where the steady clock stops during suspend, the wall clock runs
+        // ahead of it. Waking late says nothing on its own: a background
+        // thread on a busy machine can oversleep by far more than the
+        // threshold. Where the steady clock keeps going, suspends are only
+        // known from the OS's power notifications.
+        auto woke = clock_->SteadyNow();
+        int64_t woke_wall_us = clock_->WallNowUs();
+        int64_t steady_us = std::chrono::duration_cast<std::chrono::microseconds>(woke - slept).count();
+        if (woke_wall_us - slept_wall_us - steady_us > suspend_threshold_.count()) {
+            lock.unlock();
+            FocusSample sample;
+            sample.kind = SampleKind::kSuspended;
+            sample.timestamp_us = slept_wall_us;
+            sample.detected_ns = MonotonicNowNs();
+            callback_(sample);
+            lock.lock();
+            return true;
+        }
+
+        if (timers_changed_) continue;
+        if (!timer_first) return false;
+
+        lock.unlock();
+        timers_->RunDue(woke_wall_us);
+        lock.lock();
+    }
+    return false;
+}
+
+}  // namespace app_focus_tracker
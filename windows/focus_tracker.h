@@ -0,0 +1,114 @@
+#ifndef FLUTTER_PLUGIN_FOCUS_TRACKER_H_
+#define FLUTTER_PLUGIN_FOCUS_TRACKER_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "clock.h"
+#include "focus_source.h"
+#include "idle_source.h"
+#include "sample_scheduler.h"
+#include "title_fetcher.h"
+
+namespace app_focus_tracker {
+
+enum class TrackerState : uint8_t {
+    kIdle,
+    kRunning,
+    kPaused,
+    kStopping,
+};
+
+// Timers that run on the sampling thread between samples.
+class TrackerTimers {
+public:
+    virtual ~TrackerTimers() = default;
+    // Earliest wall-clock time, in microseconds, that anything may be due;
+    // INT64_MAX when nothing is scheduled.
+    virtual int64_t NextDue() = 0;
+    virtual void RunDue(int64_t now_us) = 0;
+};
+
+// Owns the sampling thread. Lifecycle calls are safe from any thread and
+// never wait for a sampling period to elapse: the thread sleeps until the
+// scheduler's next absolute deadline on a condition variable that every
+// state change signals.
+class FocusTracker {
+public:
+    using SampleCallback = std::function<void(const FocusSample&)>;
+
+    FocusTracker(std::unique_ptr<FocusSource> source, SampleCallback callback,
+                 std::chrono::milliseconds interval = std::chrono::seconds(1));
+    // With |idle|, the tracker stops sampling while the user is idle: it
+    // reports one idle sample and then polls only |idle| until input resumes.
+    // Suspends are detected from the wall clock jumping ahead of the steady
+    // clock across a wait and reported as a kSuspended sample stamped with
+    // the time the thread went to sleep.
+    FocusTracker(std::unique_ptr<FocusSource> source, SampleCallback callback,
+                 const ScheduleOptions& schedule, std::unique_ptr<IdleSource> idle = nullptr);
+    ~FocusTracker();
+    FocusTracker(const FocusTracker&) = delete;
+    FocusTracker& operator=(const FocusTracker&) = delete;
+
+    // Idle -> running. Returns false if the tracker was not idle.
+    bool Start();
+    // Running -> paused. A sample already being delivered still completes.
+    bool Pause();
+    // Paused -> running.
+    bool Resume();
+    // Any state -> idle; joins the thread. When called from the sampling
+    // callback itself the thread is only told to exit and is joined by the
+    // next Start() or the destructor.
+    void Stop();
+
+    TrackerState state() const { return state_.load(std::memory_order_acquire); }
+
+    // Must be set before Start(); |timers| must outlive the tracker.
+    void set_timers(TrackerTimers* timers) { timers_ = timers; }
+    // Tells a sleeping thread the timers changed, so it re-reads NextDue().
+    void Wake();
+
+    Clock* clock() const { return clock_; }
+
+private:
+    void Run();
+    // Sleeps until |deadline|, running timers that fall due before it.
+    // Returns true if the machine was suspended meanwhile.
+    bool WaitForSample(std::unique_lock<std::mutex>& lock, std::chrono::steady_clock::time_point deadline);
+    bool Transition(TrackerState from, TrackerState to);
+
+    Clock* clock_;
+    // Shared with |titles_|, whose helper may outlive the tracker.
+    std::shared_ptr<FocusSource> source_;
+    std::unique_ptr<IdleSource> idle_;
+    // Set when |source_| has slow titles.
+    std::unique_ptr<TitleFetcher> titles_;
+    SampleCallback callback_;
+    // Only touched by the sampling thread.
+    SampleScheduler scheduler_;
+    std::chrono::milliseconds idle_threshold_;
+    std::chrono::milliseconds idle_interval_;
+    std::chrono::microseconds suspend_threshold_;
+    ThreadQos qos_;
+    TrackerTimers* timers_ = nullptr;
+
+    // Serializes Start/Stop so two callers never race on |thread_|.
+    std::mutex lifecycle_mutex_;
+    // Guards state changes against the thread's wait.
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool timers_changed_ = false;
+    std::atomic<TrackerState> state_{TrackerState::kIdle};
+    std::atomic<std::thread::id> worker_id_{};
+    std::thread thread_;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_FOCUS_TRACKER_H_
@@ -0,0 +1,31 @@
+#ifndef FLUTTER_PLUGIN_FOCUS_TYPES_H_
+#define FLUTTER_PLUGIN_FOCUS_TYPES_H_
+
+#include <cstdint>
+
+namespace app_focus_tracker {
+
+constexpr int64_t kMicrosPerSecond = 1000000;
+constexpr int64_t kMicrosPerDay = 86400 * kMicrosPerSecond;
+
+// A closed span of focus on one app/title pair. Timestamps are microseconds
+// since the Unix epoch; ids index the store's app and title dictionaries.
+struct FocusSession {
+    int64_t start_us = 0;
+    int64_t end_us = 0;
+    uint32_t app_id = 0;
+    uint32_t title_id = 0;
+
+    int64_t duration_us() const { return end_us > start_us ? end_us - start_us : 0; }
+};
+
+// Days since the Unix epoch (UTC), rounding towards negative infinity.
+inline int64_t DayIndex(int64_t timestamp_us) {
+    int64_t day = timestamp_us / kMicrosPerDay;
+    if (timestamp_us % kMicrosPerDay < 0) --day;
+    return day;
+}
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_FOCUS_TYPES_H_
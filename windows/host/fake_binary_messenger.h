@@ -0,0 +1,105 @@
+#ifndef FLUTTER_PLUGIN_HOST_FAKE_BINARY_MESSENGER_H_
+#define FLUTTER_PLUGIN_HOST_FAKE_BINARY_MESSENGER_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+#include <flutter/method_call.h>
+#include <flutter/standard_method_codec.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace app_focus_tracker {
+
+// Plays the Dart side of the engine: delivers calls to the handlers the
+// plugin registers and records everything the plugin sends, with the time
+// it was sent.
+class FakeBinaryMessenger : public flutter::BinaryMessenger {
+public:
+    struct Message {
+        std::string channel;
+        std::vector<uint8_t> bytes;
+        std::chrono::steady_clock::time_point sent;
+    };
+
+    void Send(const std::string& channel, const uint8_t* message, size_t message_size,
+              flutter::BinaryReply /*reply*/) const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        messages_.push_back({channel, std::vector<uint8_t>(message, message + message_size),
+                             std::chrono::steady_clock::now()});
+    }
+
+    void SetMessageHandler(const std::string& channel, flutter::BinaryMessageHandler handler) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (handler) {
+            handlers_[channel] = std::move(handler);
+        } else {
+            handlers_.erase(channel);
+        }
+    }
+
+    bool has_handler(const std::string& channel) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return handlers_.count(channel) != 0;
+    }
+
+    // Sends a method call to |channel|'s handler and returns the encoded
+    // reply, which is empty if nothing answered.
+    std::vector<uint8_t> Call(const std::string& channel, const std::string& method,
+                              flutter::EncodableValue arguments = flutter::EncodableValue()) {
+        const auto& codec = flutter::StandardMethodCodec::GetInstance();
+        auto message = codec.EncodeMethodCall(
+            flutter::MethodCall<flutter::EncodableValue>(method, std::make_unique<flutter::EncodableValue>(
+                                                                     std::move(arguments))));
+        flutter::BinaryMessageHandler handler;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = handlers_.find(channel);
+            if (it == handlers_.end()) return {};
+            handler = it->second;
+        }
+        std::vector<uint8_t> reply;
+        handler(message->data(), message->size(), [&reply](const uint8_t* data, size_t size) {
+            reply.assign(data, data + size);
+        });
+        return reply;
+    }
+
+    // Everything sent so far, oldest first, leaving the record empty.
+    std::vector<Message> Take() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<Message> messages;
+        messages.swap(messages_);
+        return messages;
+    }
+
+    size_t sent_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return messages_.size();
+    }
+
+    // Decodes a success envelope such as an event or a method reply. Returns
+    // false for errors and malformed input.
+    static bool DecodeSuccess(const std::vector<uint8_t>& envelope, flutter::EncodableValue* value) {
+        if (envelope.empty() || envelope[0] != 0) return false;
+        size_t pos = 1;
+        return flutter::StandardCodecSerializer::GetInstance().ReadValue(envelope.data(), envelope.size(), &pos,
+                                                                         value);
+    }
+
+private:
+    mutable std::mutex mutex_;
+    mutable std::vector<Message> messages_;
+    std::map<std::string, flutter::BinaryMessageHandler> handlers_;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_HOST_FAKE_BINARY_MESSENGER_H_
@@ -0,0 +1,55 @@
+// Host stand-in for the Flutter client wrapper's encodable_value.h, so code
+// that builds messages can be compiled and measured without the Windows
+// embedder. Mirrors the parts of the real API the plugin uses; custom and
+// float-list values are not supported.
+
+#ifndef FLUTTER_PLUGIN_HOST_FLUTTER_ENCODABLE_VALUE_H_
+#define FLUTTER_PLUGIN_HOST_FLUTTER_ENCODABLE_VALUE_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace flutter {
+
+class EncodableValue;
+
+using EncodableList = std::vector<EncodableValue>;
+using EncodableMap = std::map<EncodableValue, EncodableValue>;
+
+namespace internal {
+using EncodableValueVariant =
+    std::variant<std::monostate, bool, int32_t, int64_t, double, std::string, std::vector<uint8_t>,
+                 std::vector<int32_t>, std::vector<int64_t>, std::vector<double>, EncodableList, EncodableMap>;
+}  // namespace internal
+
+class EncodableValue : public internal::EncodableValueVariant {
+public:
+    using super = internal::EncodableValueVariant;
+    using super::super;
+    using super::operator=;
+
+    EncodableValue() = default;
+    explicit EncodableValue(const char* string) : super(std::string(string)) {}
+    EncodableValue& operator=(const char* other) {
+        *this = std::string(other);
+        return *this;
+    }
+
+    bool IsNull() const { return std::holds_alternative<std::monostate>(*this); }
+
+    int64_t LongValue() const {
+        if (std::holds_alternative<int32_t>(*this)) return std::get<int32_t>(*this);
+        return std::get<int64_t>(*this);
+    }
+
+    friend bool operator<(const EncodableValue& lhs, const EncodableValue& rhs) {
+        return static_cast<const super&>(lhs) < static_cast<const super&>(rhs);
+    }
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_PLUGIN_HOST_FLUTTER_ENCODABLE_VALUE_H_
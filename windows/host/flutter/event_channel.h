@@ -0,0 +1,97 @@
+// Host stand-in for the Flutter client wrapper's event_channel.h. Handles
+// "listen"/"cancel" calls and sends events through the messenger the same
+// way the real channel does.
+
+#ifndef FLUTTER_PLUGIN_HOST_FLUTTER_EVENT_CHANNEL_H_
+#define FLUTTER_PLUGIN_HOST_FLUTTER_EVENT_CHANNEL_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "binary_messenger.h"
+#include "event_sink.h"
+#include "event_stream_handler.h"
+#include "method_codec.h"
+
+namespace flutter {
+
+template <typename T>
+class EventChannel {
+public:
+    EventChannel(BinaryMessenger* messenger, const std::string& name, const MethodCodec<T>* codec)
+        : messenger_(messenger), name_(name), codec_(codec) {}
+    ~EventChannel() = default;
+    EventChannel(const EventChannel&) = delete;
+    EventChannel& operator=(const EventChannel&) = delete;
+
+    void SetStreamHandler(std::unique_ptr<StreamHandler<T>> handler) {
+        if (!handler) {
+            messenger_->SetMessageHandler(name_, nullptr);
+            return;
+        }
+        // The handler is shared with the message handler so it outlives a
+        // call that replaces it.
+        std::shared_ptr<StreamHandler<T>> shared_handler(std::move(handler));
+        BinaryMessenger* messenger = messenger_;
+        std::string name = name_;
+        const MethodCodec<T>* codec = codec_;
+        messenger_->SetMessageHandler(name_, [shared_handler, messenger, name, codec](
+                                                 const uint8_t* message, size_t message_size, BinaryReply reply) {
+            auto call = codec->DecodeMethodCall(message, message_size);
+            if (!call) {
+                reply(nullptr, 0);
+                return;
+            }
+            std::unique_ptr<std::vector<uint8_t>> response;
+            if (call->method_name() == "listen") {
+                auto sink = std::make_unique<Sink>(messenger, name, codec);
+                auto error = shared_handler->OnListen(call->arguments(), std::move(sink));
+                response = error ? codec->EncodeErrorEnvelope(error->error_code, error->error_message,
+                                                              error->error_details.get())
+                                 : codec->EncodeSuccessEnvelope();
+            } else if (call->method_name() == "cancel") {
+                auto error = shared_handler->OnCancel(call->arguments());
+                response = error ? codec->EncodeErrorEnvelope(error->error_code, error->error_message,
+                                                              error->error_details.get())
+                                 : codec->EncodeSuccessEnvelope();
+            } else {
+                reply(nullptr, 0);
+                return;
+            }
+            reply(response->data(), response->size());
+        });
+    }
+
+private:
+    class Sink : public EventSink<T> {
+    public:
+        Sink(BinaryMessenger* messenger, const std::string& name, const MethodCodec<T>* codec)
+            : messenger_(messenger), name_(name), codec_(codec) {}
+
+    protected:
+        void SuccessInternal(const T* event) override {
+            auto message = codec_->EncodeSuccessEnvelope(event);
+            messenger_->Send(name_, message->data(), message->size());
+        }
+        void ErrorInternal(const std::string& error_code, const std::string& error_message,
+                           const T* error_details) override {
+            auto message = codec_->EncodeErrorEnvelope(error_code, error_message, error_details);
+            messenger_->Send(name_, message->data(), message->size());
+        }
+        void EndOfStreamInternal() override { messenger_->Send(name_, nullptr, 0); }
+
+    private:
+        BinaryMessenger* messenger_;
+        std::string name_;
+        const MethodCodec<T>* codec_;
+    };
+
+    BinaryMessenger* messenger_;
+    std::string name_;
+    const MethodCodec<T>* codec_;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_PLUGIN_HOST_FLUTTER_EVENT_CHANNEL_H_
@@ -0,0 +1,46 @@
+// Host stand-in for the Flutter client wrapper's
+// event_stream_handler_functions.h.
+
+#ifndef FLUTTER_PLUGIN_HOST_FLUTTER_EVENT_STREAM_HANDLER_FUNCTIONS_H_
+#define FLUTTER_PLUGIN_HOST_FLUTTER_EVENT_STREAM_HANDLER_FUNCTIONS_H_
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "event_sink.h"
+#include "event_stream_handler.h"
+
+namespace flutter {
+
+template <typename T>
+using StreamHandlerListen =
+    std::function<std::unique_ptr<StreamHandlerError<T>>(const T* arguments, std::unique_ptr<EventSink<T>>&& events)>;
+template <typename T>
+using StreamHandlerCancel = std::function<std::unique_ptr<StreamHandlerError<T>>(const T* arguments)>;
+
+template <typename T>
+class StreamHandlerFunctions : public StreamHandler<T> {
+public:
+    StreamHandlerFunctions(StreamHandlerListen<T> on_listen, StreamHandlerCancel<T> on_cancel)
+        : on_listen_(std::move(on_listen)), on_cancel_(std::move(on_cancel)) {}
+
+protected:
+    std::unique_ptr<StreamHandlerError<T>> OnListenInternal(const T* arguments,
+                                                            std::unique_ptr<EventSink<T>>&& events) override {
+        if (on_listen_) return on_listen_(arguments, std::move(events));
+        return std::make_unique<StreamHandlerError<T>>("error", "No OnListen handler set", nullptr);
+    }
+    std::unique_ptr<StreamHandlerError<T>> OnCancelInternal(const T* arguments) override {
+        if (on_cancel_) return on_cancel_(arguments);
+        return std::make_unique<StreamHandlerError<T>>("error", "No OnCancel handler set", nullptr);
+    }
+
+private:
+    StreamHandlerListen<T> on_listen_;
+    StreamHandlerCancel<T> on_cancel_;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_PLUGIN_HOST_FLUTTER_EVENT_STREAM_HANDLER_FUNCTIONS_H_
@@ -0,0 +1,30 @@
+// Host stand-in for the Flutter client wrapper's method_call.h.
+
+#ifndef FLUTTER_PLUGIN_HOST_FLUTTER_METHOD_CALL_H_
+#define FLUTTER_PLUGIN_HOST_FLUTTER_METHOD_CALL_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace flutter {
+
+template <typename T>
+class MethodCall {
+public:
+    MethodCall(const std::string& method_name, std::unique_ptr<T> arguments)
+        : method_name_(method_name), arguments_(std::move(arguments)) {}
+    MethodCall(const MethodCall&) = delete;
+    MethodCall& operator=(const MethodCall&) = delete;
+
+    const std::string& method_name() const { return method_name_; }
+    const T* arguments() const { return arguments_.get(); }
+
+private:
+    std::string method_name_;
+    std::unique_ptr<T> arguments_;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_PLUGIN_HOST_FLUTTER_METHOD_CALL_H_
@@ -0,0 +1,98 @@
+// Host stand-in for the Flutter client wrapper's method_channel.h.
+
+#ifndef FLUTTER_PLUGIN_HOST_FLUTTER_METHOD_CHANNEL_H_
+#define FLUTTER_PLUGIN_HOST_FLUTTER_METHOD_CHANNEL_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binary_messenger.h"
+#include "method_call.h"
+#include "method_codec.h"
+#include "method_result.h"
+
+namespace flutter {
+
+template <typename T>
+using MethodCallHandler = std::function<void(const MethodCall<T>& call, std::unique_ptr<MethodResult<T>> result)>;
+
+template <typename T>
+class MethodChannel {
+public:
+    MethodChannel(BinaryMessenger* messenger, const std::string& name, const MethodCodec<T>* codec)
+        : messenger_(messenger), name_(name), codec_(codec) {}
+    ~MethodChannel() = default;
+    MethodChannel(const MethodChannel&) = delete;
+    MethodChannel& operator=(const MethodChannel&) = delete;
+
+    void InvokeMethod(const std::string& method, std::unique_ptr<T> arguments,
+                      std::unique_ptr<MethodResult<T>> result = nullptr) {
+        MethodCall<T> call(method, std::move(arguments));
+        auto message = codec_->EncodeMethodCall(call);
+        if (!result) {
+            messenger_->Send(name_, message->data(), message->size());
+            return;
+        }
+        std::shared_ptr<MethodResult<T>> shared_result(std::move(result));
+        const MethodCodec<T>* codec = codec_;
+        messenger_->Send(name_, message->data(), message->size(),
+                         [shared_result, codec](const uint8_t* reply, size_t reply_size) {
+                             codec->DecodeAndProcessResponseEnvelope(reply, reply_size, shared_result.get());
+                         });
+    }
+
+    void SetMethodCallHandler(MethodCallHandler<T> handler) const {
+        if (!handler) {
+            messenger_->SetMessageHandler(name_, nullptr);
+            return;
+        }
+        const MethodCodec<T>* codec = codec_;
+        messenger_->SetMessageHandler(
+            name_, [handler, codec](const uint8_t* message, size_t message_size, BinaryReply reply) {
+                auto call = codec->DecodeMethodCall(message, message_size);
+                if (!call) {
+                    reply(nullptr, 0);
+                    return;
+                }
+                handler(*call, std::make_unique<Result>(std::move(reply), codec));
+            });
+    }
+
+private:
+    // Encodes the handler's answer into a reply envelope.
+    class Result : public MethodResult<T> {
+    public:
+        Result(BinaryReply reply, const MethodCodec<T>* codec) : reply_(std::move(reply)), codec_(codec) {}
+
+    protected:
+        void SuccessInternal(const T* result) override { Reply(codec_->EncodeSuccessEnvelope(result)); }
+        void ErrorInternal(const std::string& error_code, const std::string& error_message,
+                           const T* error_details) override {
+            Reply(codec_->EncodeErrorEnvelope(error_code, error_message, error_details));
+        }
+        void NotImplementedInternal() override {
+            if (reply_) reply_(nullptr, 0);
+            reply_ = nullptr;
+        }
+
+    private:
+        void Reply(std::unique_ptr<std::vector<uint8_t>> message) {
+            if (reply_) reply_(message->data(), message->size());
+            reply_ = nullptr;
+        }
+
+        BinaryReply reply_;
+        const MethodCodec<T>* codec_;
+    };
+
+    BinaryMessenger* messenger_;
+    std::string name_;
+    const MethodCodec<T>* codec_;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_PLUGIN_HOST_FLUTTER_METHOD_CHANNEL_H_
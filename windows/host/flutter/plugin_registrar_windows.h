@@ -0,0 +1,18 @@
+// Host stand-in for the Flutter client wrapper's plugin_registrar_windows.h.
+// Only flutter::Plugin is usable; registration itself needs the embedder.
+
+#ifndef FLUTTER_PLUGIN_HOST_FLUTTER_PLUGIN_REGISTRAR_WINDOWS_H_
+#define FLUTTER_PLUGIN_HOST_FLUTTER_PLUGIN_REGISTRAR_WINDOWS_H_
+
+namespace flutter {
+
+class Plugin {
+public:
+    virtual ~Plugin() = default;
+};
+
+class PluginRegistrarWindows;
+
+}  // namespace flutter
+
+#endif  // FLUTTER_PLUGIN_HOST_FLUTTER_PLUGIN_REGISTRAR_WINDOWS_H_
@@ -0,0 +1,336 @@
+// Host stand-in for the Flutter client wrapper's standard_method_codec.h.
+// Produces the same bytes as the real StandardMethodCodec, so encoding
+// costs measured on the host are representative.
+
+#ifndef FLUTTER_PLUGIN_HOST_FLUTTER_STANDARD_METHOD_CODEC_H_
+#define FLUTTER_PLUGIN_HOST_FLUTTER_STANDARD_METHOD_CODEC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "encodable_value.h"
+#include "method_call.h"
+#include "method_codec.h"
+#include "method_result.h"
+
+namespace flutter {
+
+// The standard message codec's wire format.
+class StandardCodecSerializer {
+public:
+    static const StandardCodecSerializer& GetInstance() {
+        static StandardCodecSerializer instance;
+        return instance;
+    }
+
+    void WriteValue(const EncodableValue& value, std::vector<uint8_t>* out) const {
+        switch (value.index()) {
+            case 0:
+                out->push_back(kNull);
+                break;
+            case 1:
+                out->push_back(std::get<bool>(value) ? kTrue : kFalse);
+                break;
+            case 2:
+                out->push_back(kInt32);
+                WriteRaw(std::get<int32_t>(value), out);
+                break;
+            case 3:
+                out->push_back(kInt64);
+                WriteRaw(std::get<int64_t>(value), out);
+                break;
+            case 4:
+                out->push_back(kFloat64);
+                Align(8, out);
+                WriteRaw(std::get<double>(value), out);
+                break;
+            case 5: {
+                const auto& text = std::get<std::string>(value);
+                out->push_back(kString);
+                WriteSize(text.size(), out);
+                out->insert(out->end(), text.begin(), text.end());
+                break;
+            }
+            case 6:
+                out->push_back(kUint8List);
+                WriteList(std::get<std::vector<uint8_t>>(value), 1, out);
+                break;
+            case 7:
+                out->push_back(kInt32List);
+                WriteList(std::get<std::vector<int32_t>>(value), 4, out);
+                break;
+            case 8:
+                out->push_back(kInt64List);
+                WriteList(std::get<std::vector<int64_t>>(value), 8, out);
+                break;
+            case 9:
+                out->push_back(kFloat64List);
+                WriteList(std::get<std::vector<double>>(value), 8, out);
+                break;
+            case 10: {
+                const auto& list = std::get<EncodableList>(value);
+                out->push_back(kList);
+                WriteSize(list.size(), out);
+                for (const auto& item : list) WriteValue(item, out);
+                break;
+            }
+            case 11: {
+                const auto& map = std::get<EncodableMap>(value);
+                out->push_back(kMap);
+                WriteSize(map.size(), out);
+                for (const auto& entry : map) {
+                    WriteValue(entry.first, out);
+                    WriteValue(entry.second, out);
+                }
+                break;
+            }
+        }
+    }
+
+    // Returns false on truncated or unknown input.
+    bool ReadValue(const uint8_t* data, size_t size, size_t* pos, EncodableValue* value) const {
+        if (*pos >= size) return false;
+        uint8_t type = data[(*pos)++];
+        switch (type) {
+            case kNull:
+                *value = EncodableValue();
+                return true;
+            case kTrue:
+            case kFalse:
+                *value = EncodableValue(type == kTrue);
+                return true;
+            case kInt32:
+                return ReadScalar<int32_t>(data, size, pos, 1, value);
+            case kInt64:
+                return ReadScalar<int64_t>(data, size, pos, 1, value);
+            case kFloat64:
+                return ReadScalar<double>(data, size, pos, 8, value);
+            case kString: {
+                size_t length = 0;
+                if (!ReadSize(data, size, pos, &length) || size - *pos < length) return false;
+                *value = EncodableValue(std::string(reinterpret_cast<const char*>(data + *pos), length));
+                *pos += length;
+                return true;
+            }
+            case kUint8List:
+                return ReadList<uint8_t>(data, size, pos, 1, value);
+            case kInt32List:
+                return ReadList<int32_t>(data, size, pos, 4, value);
+            case kInt64List:
+                return ReadList<int64_t>(data, size, pos, 8, value);
+            case kFloat64List:
+                return ReadList<double>(data, size, pos, 8, value);
+            case kList: {
+                size_t count = 0;
+                if (!ReadSize(data, size, pos, &count)) return false;
+                EncodableList list(count);
+                for (auto& item : list) {
+                    if (!ReadValue(data, size, pos, &item)) return false;
+                }
+                *value = EncodableValue(std::move(list));
+                return true;
+            }
+            case kMap: {
+                size_t count = 0;
+                if (!ReadSize(data, size, pos, &count)) return false;
+                EncodableMap map;
+                for (size_t i = 0; i < count; ++i) {
+                    EncodableValue key;
+                    EncodableValue item;
+                    if (!ReadValue(data, size, pos, &key) || !ReadValue(data, size, pos, &item)) return false;
+                    map[std::move(key)] = std::move(item);
+                }
+                *value = EncodableValue(std::move(map));
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    enum Type : uint8_t {
+        kNull = 0,
+        kTrue = 1,
+        kFalse = 2,
+        kInt32 = 3,
+        kInt64 = 4,
+        kFloat64 = 6,
+        kString = 7,
+        kUint8List = 8,
+        kInt32List = 9,
+        kInt64List = 10,
+        kFloat64List = 11,
+        kList = 12,
+        kMap = 13,
+    };
+
+    template <typename V>
+    static void WriteRaw(V v, std::vector<uint8_t>* out) {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&v);
+        out->insert(out->end(), bytes, bytes + sizeof(V));
+    }
+
+    static void Align(size_t alignment, std::vector<uint8_t>* out) {
+        while (out->size() % alignment != 0) out->push_back(0);
+    }
+
+    static void WriteSize(size_t size, std::vector<uint8_t>* out) {
+        if (size < 254) {
+            out->push_back(static_cast<uint8_t>(size));
+        } else if (size <= 0xffff) {
+            out->push_back(254);
+            WriteRaw(static_cast<uint16_t>(size), out);
+        } else {
+            out->push_back(255);
+            WriteRaw(static_cast<uint32_t>(size), out);
+        }
+    }
+
+    template <typename V>
+    static void WriteList(const std::vector<V>& list, size_t alignment, std::vector<uint8_t>* out) {
+        WriteSize(list.size(), out);
+        Align(alignment, out);
+        const auto* bytes = reinterpret_cast<const uint8_t*>(list.data());
+        out->insert(out->end(), bytes, bytes + list.size() * sizeof(V));
+    }
+
+    static bool ReadSize(const uint8_t* data, size_t size, size_t* pos, size_t* result) {
+        if (*pos >= size) return false;
+        uint8_t first = data[(*pos)++];
+        if (first < 254) {
+            *result = first;
+            return true;
+        }
+        size_t width = first == 254 ? 2 : 4;
+        if (size - *pos < width) return false;
+        if (width == 2) {
+            uint16_t v;
+            std::memcpy(&v, data + *pos, 2);
+            *result = v;
+        } else {
+            uint32_t v;
+            std::memcpy(&v, data + *pos, 4);
+            *result = v;
+        }
+        *pos += width;
+        return true;
+    }
+
+    static bool Skip(size_t size, size_t* pos, size_t alignment) {
+        while (*pos % alignment != 0) {
+            if (*pos >= size) return false;
+            ++*pos;
+        }
+        return true;
+    }
+
+    template <typename V>
+    static bool ReadScalar(const uint8_t* data, size_t size, size_t* pos, size_t alignment, EncodableValue* value) {
+        if (!Skip(size, pos, alignment) || size - *pos < sizeof(V)) return false;
+        V v;
+        std::memcpy(&v, data + *pos, sizeof(V));
+        *pos += sizeof(V);
+        *value = EncodableValue(v);
+        return true;
+    }
+
+    template <typename V>
+    static bool ReadList(const uint8_t* data, size_t size, size_t* pos, size_t alignment, EncodableValue* value) {
+        size_t count = 0;
+        if (!ReadSize(data, size, pos, &count) || !Skip(size, pos, alignment)) return false;
+        if ((size - *pos) / sizeof(V) < count) return false;
+        std::vector<V> list(count);
+        if (count) std::memcpy(list.data(), data + *pos, count * sizeof(V));
+        *pos += count * sizeof(V);
+        *value = EncodableValue(std::move(list));
+        return true;
+    }
+};
+
+class StandardMethodCodec : public MethodCodec<EncodableValue> {
+public:
+    static const StandardMethodCodec& GetInstance(const StandardCodecSerializer* serializer = nullptr) {
+        static StandardMethodCodec instance;
+        (void)serializer;
+        return instance;
+    }
+
+protected:
+    std::unique_ptr<MethodCall<EncodableValue>> DecodeMethodCallInternal(const uint8_t* message,
+                                                                         size_t message_size) const override {
+        size_t pos = 0;
+        EncodableValue name;
+        auto arguments = std::make_unique<EncodableValue>();
+        if (!Serializer().ReadValue(message, message_size, &pos, &name) ||
+            !std::holds_alternative<std::string>(name) ||
+            !Serializer().ReadValue(message, message_size, &pos, arguments.get())) {
+            return nullptr;
+        }
+        return std::make_unique<MethodCall<EncodableValue>>(std::get<std::string>(name), std::move(arguments));
+    }
+
+    std::unique_ptr<std::vector<uint8_t>> EncodeMethodCallInternal(
+        const MethodCall<EncodableValue>& method_call) const override {
+        auto out = std::make_unique<std::vector<uint8_t>>();
+        Serializer().WriteValue(EncodableValue(method_call.method_name()), out.get());
+        Serializer().WriteValue(method_call.arguments() ? *method_call.arguments() : EncodableValue(), out.get());
+        return out;
+    }
+
+    std::unique_ptr<std::vector<uint8_t>> EncodeSuccessEnvelopeInternal(const EncodableValue* result) const override {
+        auto out = std::make_unique<std::vector<uint8_t>>();
+        out->push_back(0);
+        Serializer().WriteValue(result ? *result : EncodableValue(), out.get());
+        return out;
+    }
+
+    std::unique_ptr<std::vector<uint8_t>> EncodeErrorEnvelopeInternal(const std::string& error_code,
+                                                                      const std::string& error_message,
+                                                                      const EncodableValue* error_details) const override {
+        auto out = std::make_unique<std::vector<uint8_t>>();
+        out->push_back(1);
+        Serializer().WriteValue(EncodableValue(error_code), out.get());
+        Serializer().WriteValue(error_message.empty() ? EncodableValue() : EncodableValue(error_message), out.get());
+        Serializer().WriteValue(error_details ? *error_details : EncodableValue(), out.get());
+        return out;
+    }
+
+    bool DecodeAndProcessResponseEnvelopeInternal(const uint8_t* response, size_t response_size,
+                                                  MethodResult<EncodableValue>* result) const override {
+        if (response_size == 0) {
+            result->NotImplemented();
+            return true;
+        }
+        size_t pos = 1;
+        if (response[0] == 0) {
+            EncodableValue value;
+            if (!Serializer().ReadValue(response, response_size, &pos, &value)) return false;
+            value.IsNull() ? result->Success() : result->Success(value);
+            return true;
+        }
+        EncodableValue code;
+        EncodableValue message;
+        EncodableValue details;
+        if (!Serializer().ReadValue(response, response_size, &pos, &code) ||
+            !Serializer().ReadValue(response, response_size, &pos, &message) ||
+            !Serializer().ReadValue(response, response_size, &pos, &details) ||
+            !std::holds_alternative<std::string>(code)) {
+            return false;
+        }
+        const auto* text = std::get_if<std::string>(&message);
+        result->Error(std::get<std::string>(code), text ? *text : std::string(), details);
+        return true;
+    }
+
+private:
+    static const StandardCodecSerializer& Serializer() { return StandardCodecSerializer::GetInstance(); }
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_PLUGIN_HOST_FLUTTER_STANDARD_METHOD_CODEC_H_
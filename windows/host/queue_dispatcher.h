@@ -0,0 +1,56 @@
+#ifndef FLUTTER_PLUGIN_HOST_QUEUE_DISPATCHER_H_
+#define FLUTTER_PLUGIN_HOST_QUEUE_DISPATCHER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+#include "platform_dispatcher.h"
+
+namespace app_focus_tracker {
+
+// Stands in for the platform thread's message loop: tasks queue up until
+// whichever thread plays the platform thread pumps them.
+class QueueDispatcher : public PlatformDispatcher {
+public:
+    void Post(std::function<void()> task) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        cv_.notify_one();
+    }
+
+    // Runs everything queued so far; returns how many tasks ran.
+    size_t RunPending() {
+        std::deque<std::function<void()>> tasks;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks.swap(tasks_);
+        }
+        for (auto& task : tasks) task();
+        return tasks.size();
+    }
+
+    // Waits up to |timeout| for a task, then runs whatever is queued.
+    size_t WaitAndRun(std::chrono::milliseconds timeout) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait_for(lock, timeout, [this] { return !tasks_.empty(); });
+        }
+        return RunPending();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> tasks_;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_HOST_QUEUE_DISPATCHER_H_
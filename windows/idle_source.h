@@ -0,0 +1,20 @@
+#ifndef FLUTTER_PLUGIN_IDLE_SOURCE_H_
+#define FLUTTER_PLUGIN_IDLE_SOURCE_H_
+
+#include <cstdint>
+
+namespace app_focus_tracker {
+
+// Platform hook that reports how long the user has been away.
+class IdleSource {
+public:
+    virtual ~IdleSource() = default;
+
+    // Time since the last keyboard or mouse input. Returns false if it
+    // cannot be determined, in which case the user is treated as active.
+    virtual bool IdleTime(int64_t* idle_us) = 0;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_IDLE_SOURCE_H_
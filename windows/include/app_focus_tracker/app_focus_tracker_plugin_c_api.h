@@ -2,14 +2,85 @@
 #define FLUTTER_PLUGIN_APP_FOCUS_TRACKER_PLUGIN_C_API_H_
 
 #include <flutter_plugin_registrar.h>
+#include <stdint.h>
+
+#ifdef FLUTTER_PLUGIN_IMPL
+#define FLUTTER_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define FLUTTER_PLUGIN_EXPORT __declspec(dllimport)
+#endif
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-void AppFocusTrackerPluginCApiRegisterWithRegistrar(
+FLUTTER_PLUGIN_EXPORT void AppFocusTrackerPluginCApiRegisterWithRegistrar(
     FlutterDesktopPluginRegistrarRef registrar);
 
+// Export formats accepted by AppFocusTrackerExportHistory.
+#define APP_FOCUS_TRACKER_EXPORT_CSV 0
+#define APP_FOCUS_TRACKER_EXPORT_JSON_LINES 1
+
+// Called periodically during an export. Return 0 to cancel it.
+typedef int (*AppFocusTrackerExportProgressCallback)(uint64_t sessions,
+                                                     uint64_t bytes,
+                                                     void* user_data);
+
+// Streams the focus history recorded in |directory| (see startRecording on
+// the Dart side) to |output_path|, or to |output_fd| when |output_path| is
+// NULL. Only sessions overlapping [from_us, to_us) are exported; |app_name|
+// may be NULL to export all apps.
+// Blocks until done, so call it from a background isolate or thread.
+// Returns the number of exported sessions, -1 on error or -2 if cancelled.
+FLUTTER_PLUGIN_EXPORT int64_t AppFocusTrackerExportHistory(
+    const char* directory, const char* output_path, int output_fd,
+    int format, int64_t from_us, int64_t to_us, const char* app_name,
+    AppFocusTrackerExportProgressCallback progress, void* user_data);
+
+// Snapshot of the focused window. Names are NUL-terminated UTF-8 and are
+// truncated to fit.
+typedef struct {
+    int64_t since_us;
+    int64_t updated_us;
+    uint64_t window_id;
+    uint32_t process_id;
+    char app_name[256];
+    char title[1024];
+} AppFocusTrackerCurrentFocus;
+
+// Fills |focus| with what the running sampler saw last, without waiting
+// for it. Returns 1 on success, or 0 when nothing is being tracked (no
+// stream is listening and getCurrentFocus has not been called).
+FLUTTER_PLUGIN_EXPORT int AppFocusTrackerGetCurrentFocus(
+    AppFocusTrackerCurrentFocus* focus);
+
+// Operational counters since the process started; see getMetrics on the
+// method channel for what each one counts.
+typedef struct {
+    uint64_t samples;
+    uint64_t os_calls;
+    uint64_t title_fetches;
+    uint64_t title_timeouts;
+    uint64_t samples_merged;
+    uint64_t events_emitted;
+    uint64_t event_bytes;
+    uint64_t events_dropped;
+    uint64_t journal_bytes;
+    uint64_t fsyncs;
+    uint64_t wakeups;
+    int64_t queue_depth;
+    int64_t title_fetch_p50_ns;
+    int64_t title_fetch_p99_ns;
+    int64_t title_fetch_max_ns;
+    int64_t fsync_p50_ns;
+    int64_t fsync_p99_ns;
+    int64_t fsync_max_ns;
+} AppFocusTrackerMetrics;
+
+// Fills |metrics|. Safe to call from any thread at any time.
+FLUTTER_PLUGIN_EXPORT void AppFocusTrackerGetMetrics(
+    AppFocusTrackerMetrics* metrics);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
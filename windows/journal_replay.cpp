@@ -0,0 +1,111 @@
+#include "journal_replay.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iterator>
+#include <system_error>
+#include <thread>
+
+namespace app_focus_tracker {
+
+SegmentReplayResult ReplaySegment(const std::string& directory, uint32_t segment,
+                                  uint64_t offset, const ReplayOptions& options) {
+    SegmentReplayResult result;
+    result.segment = segment;
+    result.aggregates = FocusAggregates(options.aggregates);
+
+    std::string path = FocusJournal::SegmentPath(directory, segment);
+    JournalSegmentReader reader;
+    if (!reader.Open(path) || (offset > kJournalSegmentHeaderSize && !reader.Seek(offset))) {
+        result.intact = false;
+        return result;
+    }
+    uint64_t start = reader.offset();
+    JournalRecord record;
+    while (reader.Next(&record)) {
+        ++result.records;
+        if (options.verify_only) continue;
+        switch (record.type) {
+            case JournalRecordType::kAppName:
+                result.app_names.emplace_back(record.id, std::move(record.text));
+                break;
+            case JournalRecordType::kTitle:
+                result.titles.emplace_back(record.id, std::move(record.text));
+                break;
+            case JournalRecordType::kSession:
+                result.app_id_end = std::max(result.app_id_end, record.session.app_id + 1);
+                result.title_id_end = std::max(result.title_id_end, record.session.title_id + 1);
+                result.aggregates.Apply(record.session);
+                break;
+        }
+    }
+    result.bytes = reader.offset() - start;
+
+    std::error_code ec;
+    uint64_t size = std::filesystem::file_size(path, ec);
+    result.intact = !ec && reader.offset() == size;
+    return result;
+}
+
+ReplayResult ReplayJournal(const std::string& directory, JournalPosition from,
+                           const ReplayOptions& options) {
+    auto started = std::chrono::steady_clock::now();
+    ReplayResult result;
+    result.aggregates = FocusAggregates(options.aggregates);
+
+    std::vector<uint32_t> segments;
+    for (uint32_t segment : FocusJournal::ListSegments(directory)) {
+        if (segment >= from.segment) segments.push_back(segment);
+    }
+
+    size_t threads = options.threads;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::max<size_t>(1, std::min(threads, segments.size()));
+    result.threads = threads;
+
+    std::vector<SegmentReplayResult> partials(segments.size());
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next.fetch_add(1); i < segments.size(); i = next.fetch_add(1)) {
+            uint64_t offset = segments[i] == from.segment ? from.offset : 0;
+            partials[i] = ReplaySegment(directory, segments[i], offset, options);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    // Dictionary ids are assigned globally in append order, so definitions
+    // are concatenated in segment order.
+    for (size_t i = 0; i < partials.size(); ++i) {
+        SegmentReplayResult& partial = partials[i];
+        result.records += partial.records;
+        result.bytes += partial.bytes;
+        // Only the newest segment may legitimately end early (still being written).
+        if (!partial.intact && i + 1 < partials.size()) {
+            result.damaged_segments.push_back(partial.segment);
+        }
+        std::move(partial.app_names.begin(), partial.app_names.end(),
+                  std::back_inserter(result.app_names));
+        std::move(partial.titles.begin(), partial.titles.end(), std::back_inserter(result.titles));
+        result.app_id_end = std::max(result.app_id_end, partial.app_id_end);
+        result.title_id_end = std::max(result.title_id_end, partial.title_id_end);
+        result.aggregates.Merge(partial.aggregates);
+    }
+    result.ok = result.damaged_segments.empty();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return result;
+}
+
+ReplayResult ReplayJournal(const std::string& directory, const ReplayOptions& options) {
+    return ReplayJournal(directory, JournalPosition{0, 0}, options);
+}
+
+}  // namespace app_focus_tracker
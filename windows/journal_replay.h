@@ -0,0 +1,70 @@
+#ifndef FLUTTER_PLUGIN_JOURNAL_REPLAY_H_
+#define FLUTTER_PLUGIN_JOURNAL_REPLAY_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "focus_aggregates.h"
+#include "focus_journal.h"
+
+namespace app_focus_tracker {
+
+struct ReplayOptions {
+    // Worker threads; 0 uses std::thread::hardware_concurrency().
+    size_t threads = 0;
+    // Only check framing and checksums, skipping aggregation.
+    bool verify_only = false;
+    AggregateOptions aggregates;
+};
+
+struct SegmentReplayResult {
+    uint32_t segment = 0;
+    uint64_t records = 0;
+    uint64_t bytes = 0;
+    // False if the segment ends in a torn or corrupted record.
+    bool intact = true;
+    std::vector<std::pair<uint32_t, std::string>> app_names;
+    std::vector<std::pair<uint32_t, std::string>> titles;
+    // One past the largest app and title ids any session referred to.
+    uint32_t app_id_end = 0;
+    uint32_t title_id_end = 0;
+    FocusAggregates aggregates;
+};
+
+struct ReplayResult {
+    bool ok = false;
+    uint64_t records = 0;
+    uint64_t bytes = 0;
+    size_t threads = 0;
+    double seconds = 0;
+    std::vector<uint32_t> damaged_segments;
+    // Dictionary definitions in append order, to be assigned on top of
+    // whatever state the replay started from.
+    std::vector<std::pair<uint32_t, std::string>> app_names;
+    std::vector<std::pair<uint32_t, std::string>> titles;
+    uint32_t app_id_end = 0;
+    uint32_t title_id_end = 0;
+    FocusAggregates aggregates;
+
+    double records_per_second() const { return seconds > 0 ? records / seconds : 0; }
+};
+
+// Replays every segment from |from| onwards. Segments are independent, so
+// each one is decoded into partial aggregates on a worker thread and the
+// partials are merged in segment order afterwards. Callers must not append
+// to the journal while a replay is running.
+ReplayResult ReplayJournal(const std::string& directory, JournalPosition from,
+                           const ReplayOptions& options);
+
+// Replays the whole journal in |directory|.
+ReplayResult ReplayJournal(const std::string& directory, const ReplayOptions& options);
+
+// Replays a single segment starting at |offset|.
+SegmentReplayResult ReplaySegment(const std::string& directory, uint32_t segment,
+                                  uint64_t offset, const ReplayOptions& options);
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_JOURNAL_REPLAY_H_
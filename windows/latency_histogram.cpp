@@ -0,0 +1,84 @@
+#include "latency_histogram.h"
+
+namespace app_focus_tracker {
+
+namespace {
+
+int FloorLog2(uint64_t value) {
+    int log = 0;
+    for (int shift = 32; shift > 0; shift /= 2) {
+        if (value >> shift) {
+            value >>= shift;
+            log += shift;
+        }
+    }
+    return log;
+}
+
+}  // namespace
+
+LatencyHistogram::LatencyHistogram() {
+    Reset();
+}
+
+void LatencyHistogram::Reset() {
+    for (auto& bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+size_t LatencyHistogram::BucketOf(uint64_t ns) {
+    constexpr uint64_t kSubBuckets = uint64_t{1} << kSubBucketBits;
+    if (ns < kSubBuckets) return static_cast<size_t>(ns);
+    int exponent = FloorLog2(ns);
+    if (exponent > kMaxExponent) return kBucketCount - 1;
+    size_t sub = static_cast<size_t>(ns >> (exponent - kSubBucketBits)) & (kSubBuckets - 1);
+    return (static_cast<size_t>(exponent - kSubBucketBits + 1) << kSubBucketBits) + sub;
+}
+
+int64_t LatencyHistogram::BucketMidpoint(size_t bucket) {
+    constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+    if (bucket < kSubBuckets) return static_cast<int64_t>(bucket);
+    int exponent = static_cast<int>(bucket >> kSubBucketBits) + kSubBucketBits - 1;
+    uint64_t width = uint64_t{1} << (exponent - kSubBucketBits);
+    uint64_t low = (kSubBuckets + (bucket & (kSubBuckets - 1))) * width;
+    return static_cast<int64_t>(low + width / 2);
+}
+
+void LatencyHistogram::Record(int64_t ns) {
+    if (ns < 0) ns = 0;
+    buckets_[BucketOf(static_cast<uint64_t>(ns))].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(ns, std::memory_order_relaxed);
+    int64_t seen = max_.load(std::memory_order_relaxed);
+    while (ns > seen && !max_.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+    }
+}
+
+int64_t LatencyHistogram::mean() const {
+    uint64_t n = count();
+    return n ? sum_.load(std::memory_order_relaxed) / static_cast<int64_t>(n) : 0;
+}
+
+int64_t LatencyHistogram::Percentile(double percentile) const {
+    uint64_t total = 0;
+    for (const auto& bucket : buckets_) total += bucket.load(std::memory_order_relaxed);
+    if (total == 0) return 0;
+    // The rank of the recording we are after, 1-based.
+    uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(total) + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank >= total) return max();
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            int64_t value = BucketMidpoint(i);
+            int64_t largest = max();
+            return value < largest ? value : largest;
+        }
+    }
+    return max();
+}
+
+}  // namespace app_focus_tracker
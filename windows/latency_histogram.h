@@ -0,0 +1,47 @@
+#ifndef FLUTTER_PLUGIN_LATENCY_HISTOGRAM_H_
+#define FLUTTER_PLUGIN_LATENCY_HISTOGRAM_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace app_focus_tracker {
+
+// Distribution of durations in nanoseconds with about 6% resolution: 16
+// linear buckets per power of two, up to about 18 minutes. Record() is a
+// couple of relaxed atomic adds, so one thread can record while others read
+// percentiles; readers see a consistent-enough snapshot, not an exact one.
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void Record(int64_t ns);
+    void Reset();
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    int64_t max() const { return max_.load(std::memory_order_relaxed); }
+    int64_t mean() const;
+    // The value below which |percentile| (0 to 100) of recordings fall,
+    // reported as the midpoint of its bucket; 100 gives max(). 0 when
+    // empty.
+    int64_t Percentile(double percentile) const;
+
+private:
+    static constexpr int kSubBucketBits = 4;
+    static constexpr int kMaxExponent = 40;
+    static constexpr size_t kBucketCount = (kMaxExponent - kSubBucketBits + 2) << kSubBucketBits;
+
+    static size_t BucketOf(uint64_t ns);
+    static int64_t BucketMidpoint(size_t bucket);
+
+    std::atomic<uint64_t> buckets_[kBucketCount];
+    std::atomic<uint64_t> count_{0};
+    std::atomic<int64_t> sum_{0};
+    std::atomic<int64_t> max_{0};
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_LATENCY_HISTOGRAM_H_
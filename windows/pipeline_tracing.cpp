@@ -0,0 +1,271 @@
+#include "pipeline_tracing.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "binary_io.h"
+
+namespace app_focus_tracker {
+
+std::atomic<bool> PipelineTracing::enabled_{false};
+
+namespace {
+
+struct TraceSpan {
+    const char* name;
+    int64_t start_ns;
+    int64_t end_ns;
+};
+
+// Written only by its thread; read by dumps up to |count|.
+struct ThreadBuffer {
+    uint32_t tid = 0;
+    std::atomic<const char*> name{nullptr};
+    // The Start() the spans belong to. The owning thread empties the buffer
+    // when it sees a newer one, so Start() never touches another thread's
+    // buffer.
+    std::atomic<uint32_t> run{0};
+    std::atomic<size_t> count{0};
+    std::atomic<uint64_t> dropped{0};
+    std::unique_ptr<TraceSpan[]> spans{new TraceSpan[PipelineTracing::kThreadCapacity]};
+};
+
+struct Registry {
+    std::mutex mutex;
+    // Shared with the owning thread, so spans outlive it until the next Start().
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    uint32_t next_tid = 1;
+};
+
+Registry& GetRegistry() {
+    static Registry registry;
+    return registry;
+}
+
+std::atomic<uint32_t> g_run{0};
+thread_local const char* t_name = nullptr;
+thread_local std::shared_ptr<ThreadBuffer> t_buffer;
+
+ThreadBuffer* CurrentBuffer() {
+    if (!t_buffer) {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        buffer->name.store(t_name, std::memory_order_relaxed);
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        buffer->tid = registry.next_tid++;
+        registry.buffers.push_back(buffer);
+        t_buffer = std::move(buffer);
+    }
+    return t_buffer.get();
+}
+
+struct ThreadSpans {
+    uint32_t tid;
+    const char* name;
+    std::vector<TraceSpan> spans;
+};
+
+// Each thread's spans from the current run, outer spans before the spans
+// they enclose.
+std::vector<ThreadSpans> Collect() {
+    uint32_t run = g_run.load(std::memory_order_acquire);
+    std::vector<ThreadSpans> threads;
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto& buffer : registry.buffers) {
+        if (buffer->run.load(std::memory_order_acquire) != run) continue;
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        ThreadSpans thread{buffer->tid, buffer->name.load(std::memory_order_relaxed),
+                           std::vector<TraceSpan>(buffer->spans.get(), buffer->spans.get() + count)};
+        std::sort(thread.spans.begin(), thread.spans.end(), [](const TraceSpan& a, const TraceSpan& b) {
+            return a.start_ns != b.start_ns ? a.start_ns < b.start_ns : a.end_ns > b.end_ns;
+        });
+        threads.push_back(std::move(thread));
+    }
+    return threads;
+}
+
+uint32_t ProcessId() {
+#if defined(_WIN32)
+    return static_cast<uint32_t>(GetCurrentProcessId());
+#else
+    return static_cast<uint32_t>(getpid());
+#endif
+}
+
+// Chrome trace timestamps are microseconds; keep the nanoseconds as decimals.
+std::string Micros(int64_t ns) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%lld.%03lld", static_cast<long long>(ns / 1000),
+                  static_cast<long long>(ns % 1000));
+    return buffer;
+}
+
+// Protobuf wire format: varints are wire type 0, strings and messages 2.
+void PutVarField(std::string& out, uint32_t field, uint64_t value) {
+    PutVarU64(out, static_cast<uint64_t>(field) << 3);
+    PutVarU64(out, value);
+}
+
+void PutBytesField(std::string& out, uint32_t field, const std::string& bytes) {
+    PutVarU64(out, (static_cast<uint64_t>(field) << 3) | 2);
+    PutVarU64(out, bytes.size());
+    out.append(bytes);
+}
+
+// Field numbers from perfetto/trace/trace_packet.proto and friends.
+constexpr uint32_t kTracePacket = 1;
+constexpr uint32_t kPacketTimestamp = 8;
+constexpr uint32_t kPacketSequenceId = 10;
+constexpr uint32_t kPacketTrackEvent = 11;
+constexpr uint32_t kPacketSequenceFlags = 13;
+constexpr uint32_t kPacketTrackDescriptor = 60;
+constexpr uint32_t kTrackUuid = 1;
+constexpr uint32_t kTrackThread = 4;
+constexpr uint32_t kThreadPid = 1;
+constexpr uint32_t kThreadTid = 2;
+constexpr uint32_t kThreadName = 5;
+constexpr uint32_t kEventType = 9;
+constexpr uint32_t kEventTrackUuid = 11;
+constexpr uint32_t kEventName = 23;
+constexpr uint64_t kSliceBegin = 1;
+constexpr uint64_t kSliceEnd = 2;
+constexpr uint64_t kIncrementalStateCleared = 1;
+
+void PutSliceEdge(std::string& out, uint32_t tid, int64_t at_ns, const char* name) {
+    std::string event;
+    PutVarField(event, kEventType, name ? kSliceBegin : kSliceEnd);
+    PutVarField(event, kEventTrackUuid, tid);
+    if (name) PutBytesField(event, kEventName, name);
+    std::string packet;
+    PutVarField(packet, kPacketTimestamp, static_cast<uint64_t>(at_ns));
+    PutVarField(packet, kPacketSequenceId, tid);
+    PutBytesField(packet, kPacketTrackEvent, event);
+    PutBytesField(out, kTracePacket, packet);
+}
+
+}  // namespace
+
+void PipelineTracing::Start() {
+    {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        // Buffers only the registry still holds belong to exited threads.
+        registry.buffers.erase(std::remove_if(registry.buffers.begin(), registry.buffers.end(),
+                                              [](const auto& buffer) { return buffer.use_count() == 1; }),
+                               registry.buffers.end());
+    }
+    g_run.fetch_add(1, std::memory_order_acq_rel);
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void PipelineTracing::Stop() {
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+void PipelineTracing::SetThreadName(const char* name) {
+    t_name = name;
+    if (t_buffer) t_buffer->name.store(name, std::memory_order_relaxed);
+}
+
+void PipelineTracing::Record(const char* name, int64_t start_ns, int64_t end_ns) {
+    ThreadBuffer* buffer = CurrentBuffer();
+    uint32_t run = g_run.load(std::memory_order_acquire);
+    if (buffer->run.load(std::memory_order_relaxed) != run) {
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+        buffer->run.store(run, std::memory_order_release);
+    }
+    size_t count = buffer->count.load(std::memory_order_relaxed);
+    if (count == kThreadCapacity) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->spans[count] = {name, start_ns, end_ns};
+    buffer->count.store(count + 1, std::memory_order_release);
+}
+
+uint64_t PipelineTracing::dropped() {
+    uint32_t run = g_run.load(std::memory_order_acquire);
+    uint64_t dropped = 0;
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto& buffer : registry.buffers) {
+        if (buffer->run.load(std::memory_order_acquire) == run) {
+            dropped += buffer->dropped.load(std::memory_order_relaxed);
+        }
+    }
+    return dropped;
+}
+
+std::string PipelineTracing::ChromeJson() {
+    std::string pid = std::to_string(ProcessId());
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    auto begin_event = [&](const char* phase, const char* name, uint32_t tid) {
+        if (!first) out.push_back(',');
+        first = false;
+        out.append("{\"ph\":\"").append(phase).append("\",\"name\":\"").append(name);
+        out.append("\",\"pid\":").append(pid).append(",\"tid\":").append(std::to_string(tid));
+    };
+    for (const ThreadSpans& thread : Collect()) {
+        if (thread.name) {
+            begin_event("M", "thread_name", thread.tid);
+            out.append(",\"args\":{\"name\":\"").append(thread.name).append("\"}}");
+        }
+        for (const TraceSpan& span : thread.spans) {
+            begin_event("X", span.name, thread.tid);
+            out.append(",\"ts\":").append(Micros(span.start_ns));
+            out.append(",\"dur\":").append(Micros(span.end_ns - span.start_ns)).append("}");
+        }
+    }
+    out.append("]}");
+    return out;
+}
+
+std::string PipelineTracing::PerfettoProto() {
+    uint32_t pid = ProcessId();
+    std::string out;
+    for (const ThreadSpans& thread : Collect()) {
+        std::string descriptor;
+        PutVarField(descriptor, kThreadPid, pid);
+        PutVarField(descriptor, kThreadTid, thread.tid);
+        if (thread.name) PutBytesField(descriptor, kThreadName, thread.name);
+        std::string track;
+        PutVarField(track, kTrackUuid, thread.tid);
+        PutBytesField(track, kTrackThread, descriptor);
+        std::string packet;
+        PutVarField(packet, kPacketSequenceId, thread.tid);
+        PutVarField(packet, kPacketSequenceFlags, kIncrementalStateCleared);
+        PutBytesField(packet, kPacketTrackDescriptor, track);
+        PutBytesField(out, kTracePacket, packet);
+
+        // Slices on a track must nest, so close each one before the next
+        // span that starts after it ends.
+        std::vector<int64_t> open_ends;
+        for (const TraceSpan& span : thread.spans) {
+            while (!open_ends.empty() && open_ends.back() <= span.start_ns) {
+                PutSliceEdge(out, thread.tid, open_ends.back(), nullptr);
+                open_ends.pop_back();
+            }
+            PutSliceEdge(out, thread.tid, span.start_ns, span.name);
+            open_ends.push_back(span.end_ns);
+        }
+        while (!open_ends.empty()) {
+            PutSliceEdge(out, thread.tid, open_ends.back(), nullptr);
+            open_ends.pop_back();
+        }
+    }
+    return out;
+}
+
+}  // namespace app_focus_tracker
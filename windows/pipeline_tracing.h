@@ -0,0 +1,66 @@
+#ifndef FLUTTER_PLUGIN_PIPELINE_TRACING_H_
+#define FLUTTER_PLUGIN_PIPELINE_TRACING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "clock.h"
+
+namespace app_focus_tracker {
+
+// Opt-in timeline of what the engine's threads are doing, for
+// chrome://tracing or ui.perfetto.dev. Each thread records spans into its
+// own fixed buffer, so recording takes no lock and publishes with a single
+// release store; a thread whose buffer fills stops recording until the
+// next Start(). While tracing is off a TracingScope costs one relaxed load.
+class PipelineTracing {
+public:
+    // Spans kept per thread.
+    static constexpr size_t kThreadCapacity = 16384;
+
+    // Discards spans from earlier runs and starts recording.
+    static void Start();
+    static void Stop();
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Labels the calling thread in dumps. |name| must be a string literal.
+    static void SetThreadName(const char* name);
+
+    // Spans recorded since the last Start(), from every thread, including
+    // threads that have since exited. Safe to call while recording, but
+    // not concurrently with Start().
+    static std::string ChromeJson();
+    // The same as a Perfetto protobuf trace.
+    static std::string PerfettoProto();
+    // Spans lost to full buffers since the last Start().
+    static uint64_t dropped();
+
+    // Adds a finished span for the calling thread. |name| must be a string
+    // literal.
+    static void Record(const char* name, int64_t start_ns, int64_t end_ns);
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+// Records its lifetime as a span named |name|, a string literal.
+class TracingScope {
+public:
+    explicit TracingScope(const char* name)
+        : name_(name), start_ns_(PipelineTracing::enabled() ? MonotonicNowNs() : 0) {}
+    ~TracingScope() {
+        if (start_ns_ != 0) PipelineTracing::Record(name_, start_ns_, MonotonicNowNs());
+    }
+    TracingScope(const TracingScope&) = delete;
+    TracingScope& operator=(const TracingScope&) = delete;
+
+private:
+    const char* name_;
+    int64_t start_ns_;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_PIPELINE_TRACING_H_
@@ -0,0 +1,21 @@
+#ifndef FLUTTER_PLUGIN_PLATFORM_DISPATCHER_H_
+#define FLUTTER_PLUGIN_PLATFORM_DISPATCHER_H_
+
+#include <functional>
+
+namespace app_focus_tracker {
+
+// Hands work to the engine's platform thread, the only thread allowed to
+// talk to an EventSink.
+class PlatformDispatcher {
+public:
+    virtual ~PlatformDispatcher() = default;
+
+    // Safe to call from any thread. Tasks still queued when the dispatcher
+    // is destroyed are dropped.
+    virtual void Post(std::function<void()> task) = 0;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_PLATFORM_DISPATCHER_H_
@@ -0,0 +1,81 @@
+#include "process_memory.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__linux__)
+#include <sys/resource.h>
+
+#include <cstdio>
+#include <cstring>
+#endif
+
+namespace app_focus_tracker {
+
+#if defined(_WIN32)
+
+bool QueryProcessMemory(ProcessMemory* memory) {
+    PROCESS_MEMORY_COUNTERS counters = {};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return false;
+    memory->resident_bytes = counters.WorkingSetSize;
+    memory->peak_resident_bytes = counters.PeakWorkingSetSize;
+    return true;
+}
+
+bool QueryProcessCpu(ProcessCpu* cpu) {
+    FILETIME created, exited, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user)) return false;
+    auto ticks = [](const FILETIME& time) {
+        return (static_cast<int64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    };
+    // FILETIME counts 100ns ticks.
+    cpu->cpu_ns = (ticks(kernel) + ticks(user)) * 100;
+    return true;
+}
+
+#elif defined(__linux__)
+
+bool QueryProcessMemory(ProcessMemory* memory) {
+    std::FILE* status = std::fopen("/proc/self/status", "r");
+    if (!status) return false;
+    char line[256];
+    int found = 0;
+    while (std::fgets(line, sizeof(line), status)) {
+        unsigned long long kb = 0;
+        if (std::strncmp(line, "VmRSS:", 6) == 0 && std::sscanf(line + 6, "%llu", &kb) == 1) {
+            memory->resident_bytes = kb * 1024;
+            ++found;
+        } else if (std::strncmp(line, "VmHWM:", 6) == 0 && std::sscanf(line + 6, "%llu", &kb) == 1) {
+            memory->peak_resident_bytes = kb * 1024;
+            ++found;
+        }
+    }
+    std::fclose(status);
+    return found == 2;
+}
+
+bool QueryProcessCpu(ProcessCpu* cpu) {
+    rusage usage = {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return false;
+    auto ns = [](const timeval& time) {
+        return static_cast<int64_t>(time.tv_sec) * 1000000000 + static_cast<int64_t>(time.tv_usec) * 1000;
+    };
+    cpu->cpu_ns = ns(usage.ru_utime) + ns(usage.ru_stime);
+    cpu->voluntary_switches = static_cast<uint64_t>(usage.ru_nvcsw);
+    cpu->involuntary_switches = static_cast<uint64_t>(usage.ru_nivcsw);
+    return true;
+}
+
+#else
+
+bool QueryProcessMemory(ProcessMemory*) {
+    return false;
+}
+
+bool QueryProcessCpu(ProcessCpu*) {
+    return false;
+}
+
+#endif
+
+}  // namespace app_focus_tracker
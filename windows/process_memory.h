@@ -0,0 +1,34 @@
+#ifndef FLUTTER_PLUGIN_PROCESS_MEMORY_H_
+#define FLUTTER_PLUGIN_PROCESS_MEMORY_H_
+
+#include <cstdint>
+
+namespace app_focus_tracker {
+
+struct ProcessMemory {
+    // Working set on Windows, VmRSS on Linux.
+    uint64_t resident_bytes = 0;
+    // The largest |resident_bytes| has been since the process started.
+    uint64_t peak_resident_bytes = 0;
+};
+
+// Memory of the calling process, for stress and soak reports. Returns false
+// where the platform offers no cheap way to ask.
+bool QueryProcessMemory(ProcessMemory* memory);
+
+struct ProcessCpu {
+    // User plus kernel time of all threads so far.
+    int64_t cpu_ns = 0;
+    // Context switches so far: waits that gave up the CPU, and preemptions.
+    // Windows does not count them per process, so both stay 0 there.
+    uint64_t voluntary_switches = 0;
+    uint64_t involuntary_switches = 0;
+};
+
+// CPU use of the calling process, for resource budgets. Returns false where
+// the platform offers no cheap way to ask.
+bool QueryProcessCpu(ProcessCpu* cpu);
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_PROCESS_MEMORY_H_
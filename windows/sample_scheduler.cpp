@@ -0,0 +1,47 @@
+#include "sample_scheduler.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace app_focus_tracker {
+
+SampleScheduler::SampleScheduler(const ScheduleOptions& options)
+    : options_(options), interval_(options.min_interval) {
+    if (options_.min_interval.count() < 1) options_.min_interval = std::chrono::milliseconds(1);
+    options_.max_interval = std::max(options_.max_interval, options_.min_interval);
+    if (options_.backoff < 1.0) options_.backoff = 1.0;
+    interval_ = options_.min_interval;
+}
+
+void SampleScheduler::Reset() {
+    has_deadline_ = false;
+    interval_ = options_.min_interval;
+}
+
+SampleScheduler::Clock::time_point SampleScheduler::Next(bool focus_changed, Clock::time_point now,
+                                                         std::chrono::system_clock::time_point wall_now) {
+    if (focus_changed) {
+        interval_ = options_.min_interval;
+    } else if (has_deadline_) {
+        auto grown = std::chrono::milliseconds(static_cast<int64_t>(interval_.count() * options_.backoff));
+        interval_ = std::min(std::max(grown, interval_), options_.max_interval);
+    }
+
+    if (options_.align_to_wall_clock) {
+        int64_t wall_us =
+            std::chrono::duration_cast<std::chrono::microseconds>(wall_now.time_since_epoch()).count();
+        int64_t step_us = std::chrono::duration_cast<std::chrono::microseconds>(interval_).count();
+        int64_t boundary_us = (wall_us / step_us + 1) * step_us;
+        // A boundary only a sliver away would sample the same state twice.
+        if (boundary_us - wall_us < step_us / 2) boundary_us += step_us;
+        deadline_ = now + std::chrono::microseconds(boundary_us - wall_us);
+    } else {
+        deadline_ = has_deadline_ ? deadline_ + interval_ : now + interval_;
+        // After an overrun, skip the missed ticks instead of sampling in a burst.
+        if (deadline_ <= now) deadline_ = now + interval_;
+    }
+    has_deadline_ = true;
+    return deadline_;
+}
+
+}  // namespace app_focus_tracker
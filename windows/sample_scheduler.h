@@ -0,0 +1,73 @@
+#ifndef FLUTTER_PLUGIN_SAMPLE_SCHEDULER_H_
+#define FLUTTER_PLUGIN_SAMPLE_SCHEDULER_H_
+
+#include <chrono>
+
+#include "clock.h"
+#include "thread_qos.h"
+
+namespace app_focus_tracker {
+
+struct ScheduleOptions {
+    // The interval drops to |min_interval| whenever focus moves and grows
+    // by |backoff| with every sample that finds it unchanged, up to
+    // |max_interval|. Equal bounds give a fixed rate.
+    std::chrono::milliseconds min_interval = std::chrono::seconds(1);
+    std::chrono::milliseconds max_interval = std::chrono::seconds(1);
+    double backoff = 2.0;
+    // Wake on wall-clock multiples of the interval, so the OS can coalesce
+    // our timer with others firing on the same boundary.
+    bool align_to_wall_clock = false;
+    // With an IdleSource, no input for |idle_threshold| counts as idle, and
+    // the tracker then only checks for input every |idle_interval|.
+    std::chrono::milliseconds idle_threshold = std::chrono::minutes(5);
+    std::chrono::milliseconds idle_interval = std::chrono::seconds(5);
+    // A wall clock that moved this much further than the steady clock while
+    // waiting means the machine was suspended. Waking up late does not.
+    std::chrono::milliseconds suspend_threshold = std::chrono::seconds(15);
+    // How long a sample waits for a FocusSource with slow_titles().
+    std::chrono::milliseconds title_timeout = std::chrono::milliseconds(200);
+    // Applied to the sampling thread and its title helper when they start.
+    ThreadQos qos;
+    // Time source for sampling, idle polling and timers; null means the
+    // system clock. Must outlive the tracker.
+    Clock* clock = nullptr;
+
+    static ScheduleOptions Fixed(std::chrono::milliseconds interval) {
+        ScheduleOptions options;
+        options.min_interval = interval;
+        options.max_interval = interval;
+        return options;
+    }
+};
+
+// Computes absolute sampling deadlines. Each deadline is derived from the
+// previous one (or from a wall-clock boundary), never from the time the
+// last sample finished, so time spent sampling does not accumulate as
+// drift.
+class SampleScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit SampleScheduler(const ScheduleOptions& options = ScheduleOptions());
+
+    // Deadline for the sample after one taken at |now|; |wall_now| is the
+    // same instant on the system clock.
+    Clock::time_point Next(bool focus_changed, Clock::time_point now,
+                           std::chrono::system_clock::time_point wall_now);
+    // Forgets the previous deadline, e.g. after a pause.
+    void Reset();
+
+    std::chrono::milliseconds interval() const { return interval_; }
+    const ScheduleOptions& options() const { return options_; }
+
+private:
+    ScheduleOptions options_;
+    std::chrono::milliseconds interval_;
+    Clock::time_point deadline_;
+    bool has_deadline_ = false;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_SAMPLE_SCHEDULER_H_
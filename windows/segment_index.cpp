@@ -0,0 +1,140 @@
+#include "segment_index.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <system_error>
+
+#include "binary_io.h"
+#include "file_util.h"
+#include "focus_journal.h"
+
+namespace app_focus_tracker {
+
+namespace {
+
+constexpr char kIndexMagic[4] = {'A', 'F', 'T', 'I'};
+constexpr uint32_t kIndexVersion = 2;
+
+}  // namespace
+
+bool SegmentIndex::Build(const std::string& directory, uint32_t segment) {
+    *this = SegmentIndex();
+    segment_ = segment;
+    min_start_us_ = std::numeric_limits<int64_t>::max();
+    max_end_us_ = std::numeric_limits<int64_t>::min();
+
+    JournalSegmentReader reader;
+    if (!reader.Open(FocusJournal::SegmentPath(directory, segment))) return false;
+    JournalRecord record;
+    uint64_t offset = reader.offset();
+    while (reader.Next(&record)) {
+        if (record.type == JournalRecordType::kSession) {
+            Add(apps_, record.session.app_id, offset);
+            Add(titles_, record.session.title_id, offset);
+            min_start_us_ = std::min(min_start_us_, record.session.start_us);
+            max_end_us_ = std::max(max_end_us_, record.session.end_us);
+            ++session_count_;
+        }
+        offset = reader.offset();
+    }
+    segment_size_ = offset;
+    if (session_count_ == 0) {
+        min_start_us_ = max_end_us_ = 0;
+    }
+    return true;
+}
+
+void SegmentIndex::Add(Postings& postings, uint32_t id, uint64_t offset) {
+    Posting& posting = postings[id];
+    PutVarU64(posting.deltas, offset - posting.last);
+    posting.last = offset;
+    ++posting.count;
+}
+
+std::vector<uint64_t> SegmentIndex::Rows(const Postings& postings, uint32_t id) {
+    std::vector<uint64_t> rows;
+    auto it = postings.find(id);
+    if (it == postings.end()) return rows;
+    rows.reserve(it->second.count);
+    ByteReader in(it->second.deltas.data(), it->second.deltas.size());
+    uint64_t offset = 0;
+    uint64_t delta = 0;
+    while (in.remaining() > 0 && in.ReadVarU64(&delta)) {
+        offset += delta;
+        rows.push_back(offset);
+    }
+    return rows;
+}
+
+bool SegmentIndex::Save(const std::string& directory) const {
+    std::string data(kIndexMagic, sizeof(kIndexMagic));
+    PutU32(data, kIndexVersion);
+    PutU32(data, segment_);
+    PutU64(data, segment_size_);
+    PutU64(data, session_count_);
+    PutI64(data, min_start_us_);
+    PutI64(data, max_end_us_);
+    for (const Postings* postings : {&apps_, &titles_}) {
+        PutU32(data, static_cast<uint32_t>(postings->size()));
+        for (const auto& entry : *postings) {
+            PutU32(data, entry.first);
+            PutU32(data, entry.second.count);
+            PutU64(data, entry.second.last);
+            PutString(data, entry.second.deltas);
+        }
+    }
+    PutU32(data, Crc32(data.data(), data.size()));
+    return WriteFileAtomically(PathFor(directory, segment_), data);
+}
+
+bool SegmentIndex::Load(const std::string& directory, uint32_t segment) {
+    *this = SegmentIndex();
+    std::string data;
+    if (!ReadFile(PathFor(directory, segment), &data) || data.size() < 12) return false;
+    size_t body = data.size() - 4;
+    if (Crc32(data.data(), body) != LoadU32(reinterpret_cast<const uint8_t*>(data.data() + body)) ||
+        std::memcmp(data.data(), kIndexMagic, sizeof(kIndexMagic)) != 0) {
+        return false;
+    }
+
+    ByteReader in(data.data() + sizeof(kIndexMagic), body - sizeof(kIndexMagic));
+    uint32_t version = 0;
+    in.ReadU32(&version);
+    in.ReadU32(&segment_);
+    in.ReadU64(&segment_size_);
+    in.ReadU64(&session_count_);
+    in.ReadI64(&min_start_us_);
+    in.ReadI64(&max_end_us_);
+    for (Postings* postings : {&apps_, &titles_}) {
+        uint32_t count = 0;
+        in.ReadU32(&count);
+        for (uint32_t i = 0; i < count && in.ok(); ++i) {
+            uint32_t id = 0;
+            Posting posting;
+            in.ReadU32(&id);
+            in.ReadU32(&posting.count);
+            in.ReadU64(&posting.last);
+            in.ReadString(&posting.deltas);
+            (*postings)[id] = std::move(posting);
+        }
+    }
+
+    std::error_code ec;
+    uint64_t size = std::filesystem::file_size(FocusJournal::SegmentPath(directory, segment), ec);
+    if (!in.ok() || version != kIndexVersion || segment_ != segment || ec || size != segment_size_) {
+        *this = SegmentIndex();
+        return false;
+    }
+    return true;
+}
+
+std::string SegmentIndex::PathFor(const std::string& directory, uint32_t segment) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "journal-%08u.idx", segment);
+    return (std::filesystem::path(directory) / name).string();
+}
+
+}  // namespace app_focus_tracker
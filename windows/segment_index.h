@@ -0,0 +1,66 @@
+#ifndef FLUTTER_PLUGIN_SEGMENT_INDEX_H_
+#define FLUTTER_PLUGIN_SEGMENT_INDEX_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace app_focus_tracker {
+
+// Secondary index over one journal segment: for every app id and title id,
+// the sorted byte offsets of its session records, stored delta+varint
+// compressed. Also keeps the time bounds of the segment so range queries
+// can skip it.
+class SegmentIndex {
+public:
+    // Scans |segment| and indexes every session record in it.
+    bool Build(const std::string& directory, uint32_t segment);
+
+    // Sidecar file next to the segment. Only sealed segments are persisted.
+    bool Save(const std::string& directory) const;
+    // Fails if the file is missing, corrupt or describes a segment of a
+    // different size than the one on disk.
+    bool Load(const std::string& directory, uint32_t segment);
+
+    // Decode the row offsets of one app or title in ascending order.
+    std::vector<uint64_t> AppRows(uint32_t app_id) const { return Rows(apps_, app_id); }
+    std::vector<uint64_t> TitleRows(uint32_t title_id) const { return Rows(titles_, title_id); }
+    bool ContainsApp(uint32_t app_id) const { return apps_.count(app_id) != 0; }
+    bool ContainsTitle(uint32_t title_id) const { return titles_.count(title_id) != 0; }
+
+    uint32_t segment() const { return segment_; }
+    uint64_t segment_size() const { return segment_size_; }
+    uint64_t session_count() const { return session_count_; }
+    int64_t min_start_us() const { return min_start_us_; }
+    int64_t max_end_us() const { return max_end_us_; }
+    bool Overlaps(int64_t from_us, int64_t to_us) const {
+        return session_count_ > 0 && min_start_us_ < to_us && max_end_us_ > from_us;
+    }
+
+    static std::string PathFor(const std::string& directory, uint32_t segment);
+
+private:
+    struct Posting {
+        uint32_t count = 0;
+        uint64_t last = 0;
+        std::string deltas;
+    };
+
+    using Postings = std::unordered_map<uint32_t, Posting>;
+
+    static void Add(Postings& postings, uint32_t id, uint64_t offset);
+    static std::vector<uint64_t> Rows(const Postings& postings, uint32_t id);
+
+    uint32_t segment_ = 0;
+    uint64_t segment_size_ = 0;
+    uint64_t session_count_ = 0;
+    int64_t min_start_us_ = 0;
+    int64_t max_end_us_ = 0;
+    Postings apps_;
+    Postings titles_;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_SEGMENT_INDEX_H_
@@ -0,0 +1,65 @@
+#ifndef FLUTTER_PLUGIN_SEQLOCK_H_
+#define FLUTTER_PLUGIN_SEQLOCK_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace app_focus_tracker {
+
+// Sequence lock for a small trivially copyable value. One writer at a time
+// (callers serialize writers themselves); any number of readers, which
+// retry instead of blocking the writer. The payload lives in relaxed
+// atomic words, so a torn read is detected rather than undefined.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock needs a trivially copyable type");
+
+public:
+    SeqLock() { Store(T()); }
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    void Store(const T& value) {
+        uint64_t words[kWords] = {};
+        std::memcpy(words, &value, sizeof(T));
+        uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    T Load() const {
+        uint64_t words[kWords];
+        for (;;) {
+            uint64_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            for (size_t i = 0; i < kWords; ++i) {
+                words[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before) break;
+        }
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    // Even while no write is in progress; bumps by two per Store().
+    uint64_t sequence() const { return sequence_.load(std::memory_order_acquire); }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> sequence_{0};
+    std::atomic<uint64_t> words_[kWords];
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_SEQLOCK_H_
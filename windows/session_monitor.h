@@ -0,0 +1,29 @@
+#ifndef FLUTTER_PLUGIN_SESSION_MONITOR_H_
+#define FLUTTER_PLUGIN_SESSION_MONITOR_H_
+
+#include <functional>
+
+namespace app_focus_tracker {
+
+enum class SessionEvent {
+    kLocked,
+    kUnlocked,
+    kSuspending,
+    kResumed,
+    // The system clock or time zone changed, including daylight saving
+    // transitions.
+    kTimeChanged,
+};
+
+// Reports session lock/unlock, power suspend/resume and time changes for
+// as long as it lives. Events arrive on the platform thread.
+class SessionMonitor {
+public:
+    using Callback = std::function<void(SessionEvent event)>;
+
+    virtual ~SessionMonitor() = default;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_SESSION_MONITOR_H_
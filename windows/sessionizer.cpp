@@ -0,0 +1,38 @@
+#include "sessionizer.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "tracker_metrics.h"
+
+namespace app_focus_tracker {
+
+bool Sessionizer::Push(const FocusSample& sample, FocusSpan* closed) {
+    if (open_ && current_.window_id == sample.window_id && current_.app_name == sample.app_name &&
+        current_.title == sample.title) {
+        current_.end_us = std::max(current_.end_us, sample.timestamp_us);
+        TrackerMetrics::Get().Add(Counter::kSamplesMerged);
+        return false;
+    }
+    bool ended = Close(sample.timestamp_us, closed);
+    if (ended) closed->detected_ns = sample.detected_ns;
+    current_.start_us = sample.timestamp_us;
+    current_.end_us = sample.timestamp_us;
+    current_.window_id = sample.window_id;
+    current_.process_id = sample.process_id;
+    current_.app_name = sample.app_name;
+    current_.title = sample.title;
+    open_ = true;
+    return ended;
+}
+
+bool Sessionizer::Close(int64_t end_us, FocusSpan* closed) {
+    if (!open_) return false;
+    open_ = false;
+    current_.end_us = std::max(current_.start_us, end_us);
+    *closed = std::move(current_);
+    current_ = FocusSpan();
+    return true;
+}
+
+}  // namespace app_focus_tracker
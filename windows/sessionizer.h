@@ -0,0 +1,47 @@
+#ifndef FLUTTER_PLUGIN_SESSIONIZER_H_
+#define FLUTTER_PLUGIN_SESSIONIZER_H_
+
+#include <cstdint>
+#include <string>
+
+#include "focus_source.h"
+
+namespace app_focus_tracker {
+
+// A stretch of continuous focus on one window with one title.
+struct FocusSpan {
+    int64_t start_us = 0;
+    int64_t end_us = 0;
+    uint64_t window_id = 0;
+    uint32_t process_id = 0;
+    std::string app_name;
+    std::string title;
+    // MonotonicNowNs() when the sample that produced this span, or that
+    // closed it, was taken.
+    int64_t detected_ns = 0;
+
+    int64_t duration_us() const { return end_us > start_us ? end_us - start_us : 0; }
+};
+
+// Folds a stream of samples into spans. A span ends when a sample reports a
+// different window, app or title; the time of that sample is taken as the
+// moment focus moved.
+class Sessionizer {
+public:
+    // Returns true and fills |closed| when |sample| ends the open span.
+    bool Push(const FocusSample& sample, FocusSpan* closed);
+    // Closes the open span at |end_us|, which may be earlier than its last
+    // sample (e.g. when input stopped). Returns false if none was open.
+    bool Close(int64_t end_us, FocusSpan* closed);
+
+    const FocusSpan* current() const { return open_ ? &current_ : nullptr; }
+    void Reset() { open_ = false; }
+
+private:
+    FocusSpan current_;
+    bool open_ = false;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_SESSIONIZER_H_
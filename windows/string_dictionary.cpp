@@ -0,0 +1,96 @@
+#include "string_dictionary.h"
+
+#include <utility>
+
+namespace app_focus_tracker {
+
+uint32_t StringDictionary::Intern(const std::string& value, bool* inserted) {
+    auto it = ids_.find(value);
+    if (it != ids_.end()) {
+        if (inserted) *inserted = false;
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(values_.size());
+    values_.push_back(value);
+    ids_.emplace(value, id);
+    if (inserted) *inserted = true;
+    return id;
+}
+
+bool StringDictionary::Assign(uint32_t id, const std::string& value) {
+    if (id < values_.size()) {
+        return values_[id] == value;
+    }
+    if (id != values_.size()) {
+        return false;
+    }
+    values_.push_back(value);
+    ids_.emplace(value, id);
+    return true;
+}
+
+size_t StringDictionary::PadTo(uint32_t end) {
+    size_t added = 0;
+    while (values_.size() < end) {
+        placeholders_.push_back(static_cast<uint32_t>(values_.size()));
+        values_.emplace_back();
+        ++added;
+    }
+    return added;
+}
+
+uint32_t StringDictionary::Find(const std::string& value) const {
+    auto it = ids_.find(value);
+    return it == ids_.end() ? kNotFound : it->second;
+}
+
+const std::string* StringDictionary::Lookup(uint32_t id) const {
+    return id < values_.size() ? &values_[id] : nullptr;
+}
+
+void StringDictionary::Clear() {
+    values_.clear();
+    ids_.clear();
+    placeholders_.clear();
+}
+
+void StringDictionary::Serialize(std::string* out) const {
+    PutU32(*out, static_cast<uint32_t>(values_.size()));
+    for (const auto& value : values_) {
+        PutString(*out, value);
+    }
+    PutU32(*out, static_cast<uint32_t>(placeholders_.size()));
+    for (uint32_t id : placeholders_) {
+        PutU32(*out, id);
+    }
+}
+
+bool StringDictionary::Deserialize(ByteReader& in) {
+    Clear();
+    uint32_t count = 0;
+    if (!in.ReadU32(&count)) return false;
+    std::vector<std::string> values;
+    std::string value;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!in.ReadString(&value)) return false;
+        values.push_back(std::move(value));
+    }
+    uint32_t placeholders = 0;
+    if (!in.ReadU32(&placeholders) || placeholders > count) return false;
+    std::vector<uint32_t> padded(placeholders);
+    for (uint32_t i = 0; i < placeholders; ++i) {
+        if (!in.ReadU32(&padded[i]) || padded[i] >= count || (i > 0 && padded[i] <= padded[i - 1])) return false;
+    }
+    size_t next = 0;
+    for (uint32_t id = 0; id < count; ++id) {
+        if (next < padded.size() && padded[next] == id) {
+            PadTo(id + 1);
+            ++next;
+        } else if (!Assign(id, values[id])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace app_focus_tracker
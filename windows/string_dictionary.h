@@ -0,0 +1,52 @@
+#ifndef FLUTTER_PLUGIN_STRING_DICTIONARY_H_
+#define FLUTTER_PLUGIN_STRING_DICTIONARY_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "binary_io.h"
+
+namespace app_focus_tracker {
+
+// Interns strings (app names, window titles) into dense ids assigned in
+// insertion order, so ids written to the journal stay valid across restarts.
+class StringDictionary {
+public:
+    static constexpr uint32_t kNotFound = 0xffffffffu;
+
+    // Returns the id for |value|, adding it if needed. |inserted| reports
+    // whether a new id was assigned.
+    uint32_t Intern(const std::string& value, bool* inserted = nullptr);
+
+    // Re-adds an entry read back from disk. Ids must arrive in order.
+    bool Assign(uint32_t id, const std::string& value);
+
+    // Adds empty placeholder entries for every id below |end| that has no
+    // value, e.g. because the journal segment defining it was lost, so later
+    // ids can still be assigned and new strings never reuse an id that
+    // sessions already refer to. Placeholders read back as empty strings but
+    // are never found by value, so a real empty string gets an id of its
+    // own. Returns the number of placeholders added.
+    size_t PadTo(uint32_t end);
+
+    uint32_t Find(const std::string& value) const;
+    const std::string* Lookup(uint32_t id) const;
+
+    size_t size() const { return values_.size(); }
+    void Clear();
+
+    void Serialize(std::string* out) const;
+    bool Deserialize(ByteReader& in);
+
+private:
+    std::vector<std::string> values_;
+    std::unordered_map<std::string, uint32_t> ids_;
+    // Ids added by PadTo(), ascending.
+    std::vector<uint32_t> placeholders_;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_STRING_DICTIONARY_H_
@@ -0,0 +1,254 @@
+#include "synthetic_workload.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <utility>
+
+#include "event_encoding.h"
+#include "focus_sampler.h"
+#include "latency_histogram.h"
+#include "process_memory.h"
+#include "virtual_clock.h"
+
+namespace app_focus_tracker {
+
+namespace {
+
+// 2026-01-01T00:00:00Z.
+constexpr int64_t kStartUs = 1767225600LL * 1000000;
+
+uint64_t SplitMix(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+const char* const kAsciiGlyphs[] = {"e", "t", "a", "o", "i", "n", "s", "r", "h", "l", "d", "c", " ", " "};
+// Latin, Cyrillic, CJK, Hangul and emoji: 1 to 4 bytes each.
+const char* const kUnicodeGlyphs[] = {"e", "a", " ", "\xC3\xA9", "\xC3\x9F", "\xD0\x96", "\xD1\x8F",
+                                      "\xE6\x97\xA5", "\xE6\x9C\xAC", "\xED\x95\x9C",
+                                      "\xF0\x9F\x98\x80", "\xF0\x9F\x9A\x80"};
+
+}  // namespace
+
+std::vector<WorkloadProfile> WorkloadProfiles() {
+    std::vector<WorkloadProfile> profiles;
+
+    WorkloadProfile typical;
+    typical.name = "typical";
+    profiles.push_back(typical);
+
+    // A new window on every sample; the pipeline should keep up with 10k
+    // switches a second.
+    WorkloadProfile storm;
+    storm.name = "switch_storm";
+    storm.apps = 200;
+    storm.stay_probability = 0;
+    storm.return_probability = 0.2;
+    storm.target_switches_per_second = 10000;
+    profiles.push_back(storm);
+
+    WorkloadProfile huge;
+    huge.name = "huge_titles";
+    huge.title_bytes = 4096;
+    huge.title_change_probability = 0.2;
+    profiles.push_back(huge);
+
+    // A fresh title on almost every sample, from a large vocabulary, as a
+    // terminal or a browser tab showing a clock does.
+    WorkloadProfile churn;
+    churn.name = "title_churn";
+    churn.distinct_titles = 100000;
+    churn.stay_probability = 0.95;
+    churn.title_change_probability = 1;
+    churn.title_bytes = 80;
+    profiles.push_back(churn);
+
+    WorkloadProfile unicode;
+    unicode.name = "unicode";
+    unicode.unicode = true;
+    unicode.title_bytes = 512;
+    unicode.title_change_probability = 0.2;
+    profiles.push_back(unicode);
+
+    // Two windows stealing focus from each other on every sample.
+    WorkloadProfile flapping;
+    flapping.name = "flapping";
+    flapping.apps = 2;
+    flapping.windows_per_app = 1;
+    flapping.stay_probability = 0;
+    flapping.return_probability = 1;
+    flapping.title_change_probability = 0;
+    profiles.push_back(flapping);
+
+    return profiles;
+}
+
+bool FindWorkloadProfile(const std::string& name, WorkloadProfile* profile) {
+    for (WorkloadProfile& candidate : WorkloadProfiles()) {
+        if (candidate.name == name) {
+            *profile = std::move(candidate);
+            return true;
+        }
+    }
+    return false;
+}
+
+SyntheticFocusSource::SyntheticFocusSource(const WorkloadProfile& profile)
+    : profile_(profile), state_(profile.seed) {
+    profile_.apps = std::max<uint32_t>(profile_.apps, 1);
+    profile_.windows_per_app = std::max<uint32_t>(profile_.windows_per_app, 1);
+    profile_.distinct_titles = std::max<uint32_t>(profile_.distinct_titles, 1);
+    double total = 0;
+    for (uint32_t k = 1; k <= profile_.apps; ++k) {
+        total += 1.0 / std::pow(static_cast<double>(k), profile_.app_zipf);
+        app_cdf_.push_back(total);
+    }
+    for (double& weight : app_cdf_) weight /= total;
+    app_cdf_.back() = 1;
+    for (uint32_t k = 0; k < profile_.apps; ++k) app_names_.push_back("app" + std::to_string(k) + ".exe");
+}
+
+std::string SyntheticFocusSource::Title(const WorkloadProfile& profile, uint32_t id) {
+    std::string title = "Document " + std::to_string(id) + " - ";
+    if (title.size() > profile.title_bytes) title.resize(profile.title_bytes);
+    uint64_t state = profile.seed ^ (static_cast<uint64_t>(id) << 20);
+    size_t glyph_count = profile.unicode ? std::size(kUnicodeGlyphs) : std::size(kAsciiGlyphs);
+    const char* const* glyphs = profile.unicode ? kUnicodeGlyphs : kAsciiGlyphs;
+    while (title.size() < profile.title_bytes) {
+        const char* glyph = glyphs[SplitMix(&state) % glyph_count];
+        size_t length = std::char_traits<char>::length(glyph);
+        // Pad with ASCII rather than split a character at the end.
+        if (title.size() + length > profile.title_bytes) {
+            title.push_back('x');
+        } else {
+            title.append(glyph, length);
+        }
+    }
+    return title;
+}
+
+uint64_t SyntheticFocusSource::Next() {
+    return SplitMix(&state_);
+}
+
+double SyntheticFocusSource::Uniform() {
+    return static_cast<double>(Next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+uint32_t SyntheticFocusSource::DrawApp() {
+    auto it = std::lower_bound(app_cdf_.begin(), app_cdf_.end(), Uniform());
+    return static_cast<uint32_t>(std::min<size_t>(it - app_cdf_.begin(), app_cdf_.size() - 1));
+}
+
+void SyntheticFocusSource::Focus(Window window) {
+    bool retitled = !has_current_ || window.title != current_.title;
+    if (has_current_) {
+        if (window.app == current_.app && window.index == current_.index) {
+            current_ = window;
+            if (retitled) title_ = Title(profile_, window.title);
+            return;
+        }
+        ++switches_;
+        previous_ = current_;
+    }
+    current_ = window;
+    has_current_ = true;
+    if (retitled) title_ = Title(profile_, window.title);
+}
+
+bool SyntheticFocusSource::Sample(FocusSample* sample) {
+    if (has_current_ && Uniform() < profile_.stay_probability) {
+        if (Uniform() < profile_.title_change_probability) {
+            Window retitled = current_;
+            retitled.title = static_cast<uint32_t>(Next() % profile_.distinct_titles);
+            Focus(retitled);
+        }
+    } else if (has_current_ && switches_ > 0 && Uniform() < profile_.return_probability) {
+        Focus(previous_);
+    } else {
+        // A jump always moves focus, unless there is nowhere to go.
+        bool single = profile_.apps == 1 && profile_.windows_per_app == 1;
+        Window window;
+        do {
+            window.app = DrawApp();
+            window.index = static_cast<uint32_t>(Next() % profile_.windows_per_app);
+        } while (has_current_ && !single && window.app == current_.app && window.index == current_.index);
+        // A window keeps its title until churn changes it.
+        uint64_t key = (static_cast<uint64_t>(window.app) << 32) | window.index;
+        window.title = static_cast<uint32_t>(SplitMix(&key) % profile_.distinct_titles);
+        if (single && has_current_) window.title = current_.title;
+        Focus(window);
+    }
+
+    sample->window_id = 0x10000 + static_cast<uint64_t>(current_.app) * profile_.windows_per_app + current_.index;
+    sample->process_id = 1000 + current_.app;
+    sample->app_name = app_names_[current_.app];
+    sample->title = title_;
+    ++samples_;
+    last_sample_time_ = std::chrono::steady_clock::now();
+    return true;
+}
+
+WorkloadReport RunWorkload(const WorkloadProfile& profile, uint64_t samples) {
+    WorkloadReport report;
+    report.profile = profile.name;
+    if (samples == 0) return report;
+
+    VirtualClock clock(kStartUs);
+    ScheduleOptions schedule = ScheduleOptions::Fixed(std::chrono::milliseconds(1));
+    schedule.clock = &clock;
+    auto owned = std::make_unique<SyntheticFocusSource>(profile);
+    SyntheticFocusSource* source = owned.get();
+    LatencyHistogram latency;
+    uint64_t encoded_events = 0;
+    ProcessMemory before;
+    bool has_memory = QueryProcessMemory(&before);
+
+    auto started = std::chrono::steady_clock::now();
+    {
+        FocusSampler sampler(std::move(owned), schedule);
+        auto raw = sampler.Subscribe(SubscriptionOptions(), [&](const FocusSpan* spans, size_t count) {
+            flutter::EncodableValue event = EncodeSpans(spans, count, Granularity::kRaw, kAllFields);
+            encoded_events += std::holds_alternative<flutter::EncodableMap>(event) ? 1 : 0;
+            latency.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now() - source->last_sample_time())
+                               .count());
+        });
+        SubscriptionOptions span_options;
+        span_options.granularity = Granularity::kSpans;
+        auto spans = sampler.Subscribe(span_options, [&report](const FocusSpan*, size_t count) {
+            report.spans += count;
+        });
+
+        clock.RunFor(std::chrono::milliseconds(static_cast<int64_t>(samples) - 1));
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        ProcessMemory after;
+        if (has_memory && QueryProcessMemory(&after)) {
+            report.resident_growth_bytes =
+                static_cast<int64_t>(after.resident_bytes) - static_cast<int64_t>(before.resident_bytes);
+            report.peak_resident_bytes = after.peak_resident_bytes;
+        }
+        sampler.Unsubscribe(spans);
+        sampler.Unsubscribe(raw);
+        // |source| goes with the sampler.
+        report.samples = source->samples();
+        report.switches = source->switches();
+    }
+
+    if (report.seconds > 0) {
+        report.samples_per_second = report.samples / report.seconds;
+        report.switches_per_second = report.switches / report.seconds;
+    }
+    report.met_target = report.switches_per_second >= profile.target_switches_per_second;
+    report.encoded_events = encoded_events;
+    report.latency_p50_ns = latency.Percentile(50);
+    report.latency_p99_ns = latency.Percentile(99);
+    report.latency_max_ns = latency.max();
+    return report;
+}
+
+}  // namespace app_focus_tracker
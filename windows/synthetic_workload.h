@@ -0,0 +1,128 @@
+#ifndef FLUTTER_PLUGIN_SYNTHETIC_WORKLOAD_H_
+#define FLUTTER_PLUGIN_SYNTHETIC_WORKLOAD_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "focus_source.h"
+
+namespace app_focus_tracker {
+
+// Parameters of a generated focus workload. Every draw comes from a seeded
+// generator of our own, so a profile and seed give the same samples on
+// every platform.
+struct WorkloadProfile {
+    std::string name;
+
+    // App popularity: a jump lands on app k (from 1) with probability
+    // proportional to 1 / k^app_zipf.
+    uint32_t apps = 20;
+    double app_zipf = 1.1;
+    uint32_t windows_per_app = 4;
+
+    // Markov switching: each sample keeps the focused window with
+    // |stay_probability|; otherwise focus goes back to the previous window
+    // with |return_probability|, or jumps to another window of a Zipf-drawn
+    // app.
+    double stay_probability = 0.9;
+    double return_probability = 0.3;
+
+    // Title churn: each sample that keeps the window retitles it with
+    // |title_change_probability|. Titles are drawn from |distinct_titles|
+    // and are |title_bytes| of UTF-8, mixing in 2- to 4-byte characters
+    // when |unicode| is set.
+    double title_change_probability = 0.05;
+    uint32_t distinct_titles = 1000;
+    size_t title_bytes = 40;
+    bool unicode = false;
+
+    // Rate a report is compared against, in focus switches per second of
+    // real time; 0 for none.
+    double target_switches_per_second = 0;
+
+    uint64_t seed = 1;
+};
+
+// The stock profiles: "typical", "switch_storm", "huge_titles",
+// "title_churn", "unicode" and "flapping".
+std::vector<WorkloadProfile> WorkloadProfiles();
+// Looks up one of WorkloadProfiles() by name.
+bool FindWorkloadProfile(const std::string& name, WorkloadProfile* profile);
+
+// A FocusSource that never fails, generating samples from a profile.
+class SyntheticFocusSource : public FocusSource {
+public:
+    explicit SyntheticFocusSource(const WorkloadProfile& profile);
+
+    bool Sample(FocusSample* sample) override;
+
+    uint64_t samples() const { return samples_; }
+    // Samples that landed on a different window from the one before.
+    uint64_t switches() const { return switches_; }
+    // When the last Sample() returned, for measuring what happens next.
+    std::chrono::steady_clock::time_point last_sample_time() const { return last_sample_time_; }
+
+    // Title |id| as the source renders it under |profile|.
+    static std::string Title(const WorkloadProfile& profile, uint32_t id);
+
+private:
+    struct Window {
+        uint32_t app = 0;
+        uint32_t index = 0;
+        uint32_t title = 0;
+    };
+
+    uint64_t Next();
+    double Uniform();
+    uint32_t DrawApp();
+    void Focus(Window window);
+
+    WorkloadProfile profile_;
+    uint64_t state_;
+    // Cumulative Zipf weights, ending at 1.
+    std::vector<double> app_cdf_;
+    std::vector<std::string> app_names_;
+    Window current_;
+    Window previous_;
+    bool has_current_ = false;
+    std::string title_;
+    uint64_t samples_ = 0;
+    uint64_t switches_ = 0;
+    std::chrono::steady_clock::time_point last_sample_time_;
+};
+
+struct WorkloadReport {
+    std::string profile;
+    uint64_t samples = 0;
+    uint64_t switches = 0;
+    uint64_t spans = 0;
+    // Raw events encoded for the event channel; equals |samples|.
+    uint64_t encoded_events = 0;
+    // Real time taken, and the rates it implies.
+    double seconds = 0;
+    double samples_per_second = 0;
+    double switches_per_second = 0;
+    bool met_target = true;
+    // From Sample() returning to the encoded raw event reaching its
+    // subscriber, in nanoseconds.
+    int64_t latency_p50_ns = 0;
+    int64_t latency_p99_ns = 0;
+    int64_t latency_max_ns = 0;
+    // Resident memory gained over the run, measured with the sampler still
+    // alive, and the process peak afterwards; 0 where unavailable.
+    int64_t resident_growth_bytes = 0;
+    uint64_t peak_resident_bytes = 0;
+};
+
+// Pushes |samples| samples of |profile| through a FocusSampler with a raw
+// subscriber that encodes every event and a span subscriber, one sample
+// per millisecond of VirtualClock time, so the run takes as long as the
+// pipeline needs and no longer.
+WorkloadReport RunWorkload(const WorkloadProfile& profile, uint64_t samples);
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_SYNTHETIC_WORKLOAD_H_
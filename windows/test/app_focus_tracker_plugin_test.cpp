@@ -1,42 +1,312 @@
+#include <flutter/encodable_value.h>
 #include <flutter/method_call.h>
 #include <flutter/method_result_functions.h>
 #include <flutter/standard_method_codec.h>
 #include <gtest/gtest.h>
-#include <windows.h>
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
+#include <thread>
 #include <variant>
+#include <vector>
 
 #include "app_focus_tracker_plugin.h"
+#include "fake_binary_messenger.h"
+#include "focus_store.h"
+#include "queue_dispatcher.h"
+#include "scoped_temp_dir.h"
+#include "tracker_metrics.h"
 
 namespace app_focus_tracker {
 namespace test {
 
 namespace {
 
+using flutter::EncodableList;
 using flutter::EncodableMap;
 using flutter::EncodableValue;
 using flutter::MethodCall;
 using flutter::MethodResultFunctions;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+constexpr char kEvents[] = "app_focus_tracker";
+constexpr char kMethods[] = "app_focus_tracker/methods";
+
+// Focus moves to a new app on every sample.
+class SwitchingSource : public FocusSource {
+ public:
+  bool Sample(FocusSample* sample) override {
+    int n = samples.fetch_add(1);
+    sample->window_id = static_cast<uint64_t>(n);
+    sample->process_id = 7;
+    sample->app_name = "app" + std::to_string(n);
+    sample->title = "title";
+    return true;
+  }
+
+  std::atomic<int> samples{0};
+};
+
+class PluginTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    sampler_ = std::make_shared<FocusSampler>(std::make_unique<SwitchingSource>(), milliseconds(2));
+    auto dispatcher = std::make_unique<QueueDispatcher>();
+    dispatcher_ = dispatcher.get();
+    plugin_ = std::make_unique<AppFocusTrackerPlugin>(sampler_, std::move(dispatcher));
+    plugin_->ConnectChannels(&messenger_);
+  }
+
+  // Pumps the platform thread until at least |count| messages were sent.
+  bool PumpUntilSent(size_t count) {
+    auto deadline = steady_clock::now() + std::chrono::seconds(5);
+    while (messenger_.sent_count() < count) {
+      if (steady_clock::now() > deadline) return false;
+      dispatcher_->WaitAndRun(milliseconds(10));
+    }
+    return true;
+  }
+
+  static EncodableValue Arguments(const char* granularity) {
+    EncodableMap arguments;
+    arguments[EncodableValue("granularity")] = EncodableValue(granularity);
+    return EncodableValue(arguments);
+  }
+
+  FakeBinaryMessenger messenger_;
+  QueueDispatcher* dispatcher_ = nullptr;
+  std::shared_ptr<FocusSampler> sampler_;
+  std::unique_ptr<AppFocusTrackerPlugin> plugin_;
+};
 
 }  // namespace
 
-TEST(AppFocusTrackerPlugin, GetPlatformVersion) {
-  AppFocusTrackerPlugin plugin;
-  // Save the reply value from the success callback.
-  std::string result_string;
-  plugin.HandleMethodCall(
-      MethodCall("getPlatformVersion", std::make_unique<EncodableValue>()),
-      std::make_unique<MethodResultFunctions<>>(
-          [&result_string](const EncodableValue* result) {
-            result_string = std::get<std::string>(*result);
-          },
-          nullptr, nullptr));
-
-  // Since the exact string varies by host, just ensure that it's a string
-  // with the expected format.
-  EXPECT_TRUE(result_string.rfind("Windows ", 0) == 0);
+TEST_F(PluginTest, ListenSendsEncodedEvents) {
+  EncodableValue reply;
+  ASSERT_TRUE(FakeBinaryMessenger::DecodeSuccess(messenger_.Call(kEvents, "listen", Arguments("spans")), &reply));
+  EXPECT_EQ(sampler_->state(), TrackerState::kRunning);
+
+  ASSERT_TRUE(PumpUntilSent(2));
+  for (const auto& message : messenger_.Take()) {
+    EXPECT_EQ(message.channel, kEvents);
+    EncodableValue event;
+    ASSERT_TRUE(FakeBinaryMessenger::DecodeSuccess(message.bytes, &event));
+    const auto& map = std::get<EncodableMap>(event);
+    EXPECT_EQ(std::get<std::string>(map.at(EncodableValue("appName"))).rfind("app", 0), 0u);
+    EXPECT_EQ(std::get<int64_t>(map.at(EncodableValue("processId"))), 7);
+  }
+}
+
+TEST_F(PluginTest, CancelStopsSamplingAndDropsQueuedEvents) {
+  messenger_.Call(kEvents, "listen", Arguments("raw"));
+  ASSERT_TRUE(PumpUntilSent(1));
+  EncodableValue reply;
+  ASSERT_TRUE(FakeBinaryMessenger::DecodeSuccess(messenger_.Call(kEvents, "cancel"), &reply));
+  EXPECT_EQ(sampler_->state(), TrackerState::kIdle);
+
+  // Events encoded before the cancel are still queued; none may be sent.
+  messenger_.Take();
+  dispatcher_->RunPending();
+  EXPECT_EQ(messenger_.sent_count(), 0u);
+}
+
+TEST_F(PluginTest, ListenAgainReplacesTheStream) {
+  messenger_.Call(kEvents, "listen", Arguments("raw"));
+  messenger_.Call(kEvents, "listen", Arguments("raw"));
+  EXPECT_EQ(sampler_->subscriber_count(), 1u);
+  ASSERT_TRUE(PumpUntilSent(1));
+  messenger_.Call(kEvents, "cancel");
+  EXPECT_EQ(sampler_->subscriber_count(), 0u);
+}
+
+TEST_F(PluginTest, StampsEventsAndKeepsLatencyPerStage) {
+  EncodableMap arguments;
+  arguments[EncodableValue("granularity")] = EncodableValue("raw");
+  arguments[EncodableValue("latency")] = EncodableValue(true);
+  int64_t before_us = MonotonicToWallUs(MonotonicNowNs());
+  messenger_.Call(kEvents, "listen", EncodableValue(arguments));
+  ASSERT_TRUE(PumpUntilSent(3));
+  messenger_.Call(kEvents, "cancel");
+
+  for (const auto& message : messenger_.Take()) {
+    EncodableValue event;
+    ASSERT_TRUE(FakeBinaryMessenger::DecodeSuccess(message.bytes, &event));
+    const auto& stamps = std::get<EncodableMap>(std::get<EncodableMap>(event).at(EncodableValue("latency")));
+    int64_t detected = std::get<int64_t>(stamps.at(EncodableValue("detectedUs")));
+    int64_t delivered = std::get<int64_t>(stamps.at(EncodableValue("deliveredUs")));
+    int64_t encoded = std::get<int64_t>(stamps.at(EncodableValue("encodedUs")));
+    int64_t dispatched = std::get<int64_t>(stamps.at(EncodableValue("dispatchedUs")));
+    EXPECT_GE(detected, before_us);
+    EXPECT_LE(detected, delivered);
+    EXPECT_LE(delivered, encoded);
+    EXPECT_LE(encoded, dispatched);
+  }
+
+  EncodableMap reset;
+  reset[EncodableValue("reset")] = EncodableValue(true);
+  EncodableValue latency;
+  ASSERT_TRUE(FakeBinaryMessenger::DecodeSuccess(
+      messenger_.Call(kMethods, "getLatency", EncodableValue(reset)), &latency));
+  for (const char* stage : {"deliver", "encode", "queue", "total"}) {
+    const auto& summary = std::get<EncodableMap>(std::get<EncodableMap>(latency).at(EncodableValue(stage)));
+    EXPECT_GE(std::get<int64_t>(summary.at(EncodableValue("count"))), 3) << stage;
+    EXPECT_GE(std::get<int64_t>(summary.at(EncodableValue("maxNs"))),
+              std::get<int64_t>(summary.at(EncodableValue("p50Ns")))) << stage;
+  }
+  ASSERT_TRUE(FakeBinaryMessenger::DecodeSuccess(messenger_.Call(kMethods, "getLatency"), &latency));
+  const auto& total = std::get<EncodableMap>(std::get<EncodableMap>(latency).at(EncodableValue("total")));
+  EXPECT_EQ(std::get<int64_t>(total.at(EncodableValue("count"))), 0);
+}
+
+TEST_F(PluginTest, GetMetricsCountsWhatWasSent) {
+  auto metric = [this](const char* name) {
+    EncodableValue metrics;
+    EXPECT_TRUE(FakeBinaryMessenger::DecodeSuccess(messenger_.Call(kMethods, "getMetrics"), &metrics));
+    return std::get<int64_t>(std::get<EncodableMap>(metrics).at(EncodableValue(name)));
+  };
+  int64_t emitted = metric("eventsEmitted");
+  int64_t bytes = metric("eventBytes");
+
+  messenger_.Call(kEvents, "listen", Arguments("raw"));
+  ASSERT_TRUE(PumpUntilSent(3));
+  messenger_.Call(kEvents, "cancel");
+  dispatcher_->RunPending();
+  size_t sent_bytes = 0;
+  std::vector<FakeBinaryMessenger::Message> sent = messenger_.Take();
+  // Each message is the event behind a one-byte success envelope.
+  for (const auto& message : sent) sent_bytes += message.bytes.size() - 1;
+
+  EXPECT_EQ(metric("eventsEmitted") - emitted, static_cast<int64_t>(sent.size()));
+  EXPECT_EQ(metric("eventBytes") - bytes, static_cast<int64_t>(sent_bytes));
+  EXPECT_EQ(metric("queueDepth"), 0);
+  EXPECT_GE(metric("samples"), static_cast<int64_t>(sent.size()));
+}
+
+TEST_F(PluginTest, TracesThePipelineThreads) {
+  messenger_.Call(kMethods, "startTracing");
+  messenger_.Call(kEvents, "listen", Arguments("raw"));
+  ASSERT_TRUE(PumpUntilSent(2));
+  messenger_.Call(kEvents, "cancel");
+  messenger_.Take();
+
+  EncodableValue json;
+  ASSERT_TRUE(FakeBinaryMessenger::DecodeSuccess(messenger_.Call(kMethods, "stopTracing"), &json));
+  const std::string& trace = std::get<std::string>(json);
+  for (const char* name : {"\"sample\"", "\"onSample\"", "\"encode\"", "\"dispatch\"", "\"focus sampler\"",
+                           "\"platform\""}) {
+    EXPECT_NE(trace.find(name), std::string::npos) << name;
+  }
+
+  EncodableValue proto;
+  EncodableMap perfetto{{EncodableValue("format"), EncodableValue("perfetto")}};
+  ASSERT_TRUE(FakeBinaryMessenger::DecodeSuccess(
+      messenger_.Call(kMethods, "stopTracing", EncodableValue(perfetto)), &proto));
+  EXPECT_FALSE(std::get<std::vector<uint8_t>>(proto).empty());
+}
+
+TEST_F(PluginTest, GetCurrentFocusOverTheMethodChannel) {
+  EncodableValue focus;
+  auto deadline = steady_clock::now() + std::chrono::seconds(5);
+  do {
+    ASSERT_TRUE(FakeBinaryMessenger::DecodeSuccess(messenger_.Call(kMethods, "getCurrentFocus"), &focus));
+  } while (focus.IsNull() && steady_clock::now() < deadline);
+  ASSERT_FALSE(focus.IsNull());
+  EXPECT_EQ(std::get<int64_t>(std::get<EncodableMap>(focus).at(EncodableValue("processId"))), 7);
+}
+
+TEST_F(PluginTest, RecordsHistoryForExport) {
+  ScopedTempDir dir;
+  uint64_t journal_bytes = TrackerMetrics::Get().value(Counter::kJournalBytes);
+  EncodableMap arguments{{EncodableValue("directory"), EncodableValue(dir.path())}};
+  EncodableValue started;
+  ASSERT_TRUE(FakeBinaryMessenger::DecodeSuccess(
+      messenger_.Call(kMethods, "startRecording", EncodableValue(arguments)), &started));
+  ASSERT_TRUE(std::get<bool>(started));
+  // Focus moves on every sample, so spans close every couple of ms.
+  auto deadline = steady_clock::now() + std::chrono::seconds(5);
+  while (TrackerMetrics::Get().value(Counter::kJournalBytes) < journal_bytes + 1000 &&
+         steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EncodableValue stopped;
+  ASSERT_TRUE(FakeBinaryMessenger::DecodeSuccess(messenger_.Call(kMethods, "stopRecording"), &stopped));
+  EXPECT_TRUE(std::get<bool>(stopped));
+  ASSERT_TRUE(FakeBinaryMessenger::DecodeSuccess(messenger_.Call(kMethods, "stopRecording"), &stopped));
+  EXPECT_FALSE(std::get<bool>(stopped));
+
+  FocusStore::Options options;
+  options.read_only = true;
+  FocusStore store;
+  ASSERT_TRUE(store.Open(dir.path(), options));
+  EXPECT_TRUE(store.open_stats().snapshot_loaded);
+  EXPECT_GT(store.aggregates().session_count(), 0u);
+}
+
+TEST_F(PluginTest, ExportsHistoryOffThePlatformThread) {
+  ScopedTempDir dir;
+  {
+    FocusStore store;
+    ASSERT_TRUE(store.Open(dir.path(), FocusStore::Options()));
+    for (int i = 0; i < 10; ++i) {
+      ASSERT_TRUE(store.Append("app" + std::to_string(i % 2), i < 3 ? "Inbox - Mail" : "notes.txt",
+                               i * 60000000LL, i * 60000000LL + 1000000));
+    }
+  }
+  std::string path = dir.path() + "/export.csv";
+  // Answers arrive through the dispatcher, so pump it until one does.
+  auto export_history = [&](EncodableMap arguments, int64_t* sessions) {
+    arguments.emplace(EncodableValue("directory"), EncodableValue(dir.path()));
+    arguments.emplace(EncodableValue("path"), EncodableValue(path));
+    bool answered = false;
+    bool ok = false;
+    plugin_->HandleMethodCall(
+        MethodCall<EncodableValue>("exportHistory", std::make_unique<EncodableValue>(arguments)),
+        std::make_unique<MethodResultFunctions<>>(
+            [&](const EncodableValue* value) {
+              answered = ok = true;
+              *sessions = std::get<int64_t>(*value);
+            },
+            [&](const std::string&, const std::string&, const EncodableValue*) { answered = true; }, nullptr));
+    auto deadline = steady_clock::now() + std::chrono::seconds(5);
+    while (!answered && steady_clock::now() < deadline) dispatcher_->WaitAndRun(milliseconds(10));
+    return ok;
+  };
+
+  int64_t sessions = 0;
+  ASSERT_TRUE(export_history(EncodableMap(), &sessions));
+  EXPECT_EQ(sessions, 10);
+  ASSERT_TRUE(export_history({{EncodableValue("titleContains"), EncodableValue("inbox")},
+                              {EncodableValue("appName"), EncodableValue("app0")}}, &sessions));
+  EXPECT_EQ(sessions, 2);
+  ASSERT_TRUE(export_history({{EncodableValue("from"), EncodableValue(int64_t{240000})},
+                              {EncodableValue("format"), EncodableValue("jsonl")}}, &sessions));
+  EXPECT_EQ(sessions, 6);
+  EXPECT_FALSE(export_history({{EncodableValue("path"), EncodableValue(dir.path() + "/none/export.csv")}}, &sessions));
+}
+
+TEST_F(PluginTest, RejectsBadArgumentsAndUnknownMethods) {
+  std::vector<uint8_t> reply = messenger_.Call(kMethods, "addBudget", EncodableValue(EncodableMap()));
+  ASSERT_FALSE(reply.empty());
+  EXPECT_EQ(reply[0], 1);  // error envelope
+  EXPECT_TRUE(messenger_.Call(kMethods, "nope").empty());
+
+  // Direct calls see the same answers.
+  bool not_implemented = false;
+  plugin_->HandleMethodCall(MethodCall<EncodableValue>("nope", std::make_unique<EncodableValue>()),
+                            std::make_unique<MethodResultFunctions<>>(
+                                nullptr, nullptr, [&not_implemented] { not_implemented = true; }));
+  EXPECT_TRUE(not_implemented);
+}
+
+TEST_F(PluginTest, DestroyingThePluginDetachesItsChannels) {
+  messenger_.Call(kEvents, "listen", Arguments("raw"));
+  plugin_.reset();
+  EXPECT_FALSE(messenger_.has_handler(kEvents));
+  EXPECT_FALSE(messenger_.has_handler(kMethods));
+  EXPECT_EQ(sampler_->subscriber_count(), 0u);
 }
 
 }  // namespace test
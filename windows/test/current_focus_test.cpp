@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "current_focus.h"
+#include "focus_sampler.h"
+#include "seqlock.h"
+
+namespace app_focus_tracker {
+namespace test {
+
+namespace {
+
+struct Wide {
+  int64_t values[6];
+};
+
+class FixedSource : public FocusSource {
+ public:
+  bool Sample(FocusSample* sample) override {
+    sample->window_id = 7;
+    sample->process_id = 99;
+    sample->app_name = "editor.exe";
+    sample->title = "main.cpp";
+    return true;
+  }
+};
+
+}  // namespace
+
+TEST(SeqLock, ReadersNeverSeeTornValues) {
+  SeqLock<Wide> lock;
+  std::atomic<bool> done{false};
+  std::atomic<int64_t> torn{0};
+  std::atomic<int64_t> reads{0};
+
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 2; ++r) {
+    readers.emplace_back([&] {
+      while (!done) {
+        Wide value = lock.Load();
+        for (int64_t v : value.values) {
+          if (v != value.values[0]) ++torn;
+        }
+        ++reads;
+      }
+    });
+  }
+  // Keep writing until the readers have overlapped with it for a while.
+  int64_t n = 0;
+  while (n < 100000 || reads < 10000) {
+    ++n;
+    Wide value;
+    for (int64_t& v : value.values) v = n;
+    lock.Store(value);
+    if (n % 1000 == 0) std::this_thread::yield();
+  }
+  done = true;
+  for (auto& reader : readers) reader.join();
+
+  EXPECT_EQ(torn, 0);
+  EXPECT_EQ(lock.Load().values[5], n);
+  EXPECT_EQ(lock.sequence(), 2u * static_cast<uint64_t>(n + 1));
+}
+
+TEST(CurrentFocusSlot, PublishesAndClears) {
+  CurrentFocusSlot slot;
+  CurrentFocus focus;
+  EXPECT_FALSE(slot.Read(&focus));
+
+  FocusSpan span;
+  span.start_us = 100;
+  span.window_id = 3;
+  span.process_id = 4;
+  span.app_name = "app";
+  span.title = "title";
+  slot.Publish(span, 250);
+  ASSERT_TRUE(slot.Read(&focus));
+  EXPECT_EQ(focus.since_us, 100);
+  EXPECT_EQ(focus.updated_us, 250);
+  EXPECT_EQ(focus.window_id, 3u);
+  EXPECT_STREQ(focus.app_name, "app");
+  EXPECT_STREQ(focus.title, "title");
+
+  slot.Clear();
+  EXPECT_FALSE(slot.Read(&focus));
+}
+
+TEST(CurrentFocusSlot, CutsLongNamesAtACharacterBoundary) {
+  CurrentFocusSlot slot;
+  FocusSpan span;
+  span.app_name = "app";
+  // 1022 ASCII bytes and then a 3-byte character that does not fit.
+  span.title = std::string(CurrentFocus::kTitleSize - 2, 'x') + "\xe2\x82\xac";
+  slot.Publish(span, 0);
+  CurrentFocus focus;
+  ASSERT_TRUE(slot.Read(&focus));
+  EXPECT_EQ(std::string(focus.title), std::string(CurrentFocus::kTitleSize - 2, 'x'));
+
+  // Names live in the slot itself, so new titles replace old ones instead
+  // of piling up.
+  for (int i = 0; i < 1000; ++i) {
+    span.title = "title " + std::to_string(i);
+    slot.Publish(span, i);
+  }
+  ASSERT_TRUE(slot.Read(&focus));
+  EXPECT_STREQ(focus.title, "title 999");
+}
+
+TEST(FocusSampler, PublishesCurrentFocusWhileRunning) {
+  FocusSampler sampler(std::make_unique<FixedSource>(), std::chrono::milliseconds(1));
+  CurrentFocus focus;
+  EXPECT_FALSE(sampler.current().Read(&focus));
+
+  auto id = sampler.Subscribe(SubscriptionOptions(), nullptr);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!sampler.current().Read(&focus) && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_TRUE(focus.valid);
+  EXPECT_STREQ(focus.app_name, "editor.exe");
+  EXPECT_STREQ(focus.title, "main.cpp");
+  EXPECT_EQ(focus.process_id, 99u);
+  EXPECT_LE(focus.since_us, focus.updated_us);
+
+  sampler.Unsubscribe(id);
+  EXPECT_FALSE(sampler.current().Read(&focus));
+}
+
+}  // namespace test
+}  // namespace app_focus_tracker
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include <flutter/encodable_value.h>
+
+#include <string>
+
+#include "event_encoding.h"
+
+namespace app_focus_tracker {
+namespace test {
+
+namespace {
+
+using flutter::EncodableList;
+using flutter::EncodableMap;
+using flutter::EncodableValue;
+
+FocusSpan MakeSpan() {
+  FocusSpan span;
+  span.start_us = 1000000;
+  span.end_us = 3600000;
+  span.process_id = 42;
+  span.app_name = "code";
+  span.title = "main.cpp";
+  return span;
+}
+
+}  // namespace
+
+TEST(EventEncoding, ParsesListenArguments) {
+  EncodableMap filter;
+  filter[EncodableValue("apps")] = EncodableList{EncodableValue("code")};
+  filter[EncodableValue("minDurationMs")] = EncodableValue(1500);
+  EncodableMap arguments;
+  arguments[EncodableValue("granularity")] = EncodableValue("batched");
+  arguments[EncodableValue("maxBatch")] = EncodableValue(int64_t{5});
+  arguments[EncodableValue("filter")] = EncodableValue(filter);
+  EncodableValue value(arguments);
+
+  SubscriptionOptions options = ParseSubscriptionOptions(&value);
+  EXPECT_EQ(options.granularity, Granularity::kBatched);
+  EXPECT_EQ(options.max_batch, 5u);
+  ASSERT_EQ(options.filter.apps.size(), 1u);
+  EXPECT_EQ(options.filter.apps[0], "code");
+  EXPECT_EQ(options.filter.min_duration_us, 1500000);
+
+  EXPECT_EQ(ParseSubscriptionOptions(nullptr).granularity, Granularity::kRaw);
+}
+
+TEST(EventEncoding, EncodesOnlySelectedFields) {
+  EncodableMap arguments;
+  arguments[EncodableValue("fields")] = EncodableList{EncodableValue("appName"), EncodableValue("duration")};
+  EncodableValue value(arguments);
+  uint32_t fields = ParseFields(&value);
+  EXPECT_EQ(fields, kAppNameField | kDurationField);
+  EXPECT_EQ(ParseFields(nullptr), kAllFields);
+
+  EncodableValue event = EncodeSpan(MakeSpan(), fields);
+  const auto& map = std::get<EncodableMap>(event);
+  EXPECT_EQ(map.size(), 2u);
+  EXPECT_EQ(std::get<std::string>(map.at(EncodableValue("appName"))), "code");
+  EXPECT_EQ(std::get<int32_t>(map.at(EncodableValue("duration"))), 3);
+}
+
+TEST(EventEncoding, WrapsBatches) {
+  FocusSpan spans[] = {MakeSpan(), MakeSpan()};
+  EncodableValue batch = EncodeSpans(spans, 2, Granularity::kBatched, kAllFields);
+  const auto& events = std::get<EncodableList>(std::get<EncodableMap>(batch).at(EncodableValue("events")));
+  ASSERT_EQ(events.size(), 2u);
+  EXPECT_EQ(std::get<std::string>(std::get<EncodableMap>(events[1]).at(EncodableValue("windowTitle"))),
+            "main.cpp");
+}
+
+}  // namespace test
+}  // namespace app_focus_tracker
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "file_util.h"
+#include "focus_export.h"
+#include "focus_store.h"
+#include "scoped_temp_dir.h"
+
+namespace app_focus_tracker {
+namespace test {
+
+namespace {
+
+constexpr int64_t kSecond = kMicrosPerSecond;
+// 2024-03-01T09:00:00Z
+constexpr int64_t kMarch1 = 1709283600 * kSecond;
+
+class FocusExportTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    FocusStore::Options options;
+    options.journal.segment_bytes = 8 * 1024;
+    ASSERT_TRUE(store_.Open(dir_.path(), options));
+    ASSERT_TRUE(store_.Append("Slack", "general, \"team\"", kMarch1, kMarch1 + 90 * kSecond));
+    ASSERT_TRUE(store_.Append("Code", "main.cpp\tline\n2", kMarch1 + 90 * kSecond,
+                              kMarch1 + 100 * kSecond));
+    for (int i = 0; i < 5000; ++i) {
+      int64_t start = kMarch1 + (200 + i) * kSecond;
+      ASSERT_TRUE(store_.Append(i % 2 ? "Slack" : "Code", "t" + std::to_string(i % 10), start,
+                                start + kSecond));
+    }
+    store_.journal().Flush();
+  }
+
+  void TearDown() override { store_.Close(); }
+
+  ScopedTempDir dir_;
+  FocusStore store_;
+};
+
+}  // namespace
+
+TEST_F(FocusExportTest, WritesEscapedCsv) {
+  ExportOptions options;
+  options.filter.to_us = kMarch1 + 150 * kSecond;
+  std::string path = dir_.path() + "/out.csv";
+  ExportResult result = ExportSessionsToFile(store_, path, options);
+  ASSERT_TRUE(result.ok);
+  EXPECT_EQ(result.sessions, 2u);
+
+  std::string contents;
+  ASSERT_TRUE(ReadFile(path, &contents));
+  EXPECT_EQ(contents,
+            "start,end,durationMs,appName,title\r\n"
+            "2024-03-01T09:00:00.000Z,2024-03-01T09:01:30.000Z,90000,Slack,"
+            "\"general, \"\"team\"\"\"\r\n"
+            "2024-03-01T09:01:30.000Z,2024-03-01T09:01:40.000Z,10000,Code,"
+            "\"main.cpp\tline\n2\"\r\n");
+  EXPECT_EQ(result.bytes, contents.size());
+}
+
+TEST_F(FocusExportTest, WritesJsonLinesForOneApp) {
+  ExportOptions options;
+  options.format = ExportFormat::kJsonLines;
+  options.filter.filter_app = true;
+  options.filter.app_id = store_.apps().Find("Code");
+  options.filter.to_us = kMarch1 + 201 * kSecond;
+  std::string out;
+  ExportResult result = ExportSessions(store_, options, [&](const char* data, size_t size) {
+    out.append(data, size);
+    return true;
+  });
+  ASSERT_TRUE(result.ok);
+  EXPECT_EQ(out,
+            "{\"start\":\"2024-03-01T09:01:30.000Z\",\"end\":\"2024-03-01T09:01:40.000Z\","
+            "\"durationMs\":10000,\"appName\":\"Code\",\"title\":\"main.cpp\\tline\\n2\"}\n"
+            "{\"start\":\"2024-03-01T09:03:20.000Z\",\"end\":\"2024-03-01T09:03:21.000Z\","
+            "\"durationMs\":1000,\"appName\":\"Code\",\"title\":\"t0\"}\n");
+}
+
+TEST_F(FocusExportTest, StreamsThroughFixedBufferAndReportsProgress) {
+  ExportOptions options;
+  options.buffer_bytes = 4096;
+  options.progress_interval = 1000;
+  std::vector<ExportProgress> reports;
+  options.progress = [&](const ExportProgress& progress) {
+    reports.push_back(progress);
+    return true;
+  };
+  size_t largest_chunk = 0;
+  uint64_t total = 0;
+  ExportResult result = ExportSessions(store_, options, [&](const char*, size_t size) {
+    largest_chunk = std::max(largest_chunk, size);
+    total += size;
+    return true;
+  });
+  ASSERT_TRUE(result.ok);
+  EXPECT_EQ(result.sessions, 5002u);
+  EXPECT_EQ(result.bytes, total);
+  EXPECT_LE(largest_chunk, options.buffer_bytes);
+  ASSERT_EQ(reports.size(), 6u);
+  EXPECT_EQ(reports[0].sessions, 1000u);
+  EXPECT_TRUE(reports.back().done);
+  EXPECT_EQ(reports.back().bytes, total);
+}
+
+TEST_F(FocusExportTest, ProgressCallbackCancels) {
+  ExportOptions options;
+  options.progress_interval = 100;
+  options.progress = [](const ExportProgress& progress) { return progress.sessions < 300; };
+  ExportResult result = ExportSessions(store_, options, [](const char*, size_t) { return true; });
+  EXPECT_FALSE(result.ok);
+  EXPECT_TRUE(result.cancelled);
+  EXPECT_EQ(result.sessions, 300u);
+}
+
+}  // namespace test
+}  // namespace app_focus_tracker
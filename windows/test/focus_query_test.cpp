@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "focus_query.h"
+#include "focus_store.h"
+#include "scoped_temp_dir.h"
+
+namespace app_focus_tracker {
+namespace test {
+
+namespace {
+
+constexpr int64_t kSecond = kMicrosPerSecond;
+
+class FocusQueryTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    FocusStore::Options options;
+    options.journal.segment_bytes = 16 * 1024;
+    ASSERT_TRUE(store_.Open(dir_.path(), options));
+    // 90 days, one session every 15 minutes; "Slack" every 16th session.
+    for (int i = 0; i < 90 * 96; ++i) {
+      int64_t start = i * 900 * kSecond;
+      std::string app = i % 16 == 0 ? "Slack" : "Editor" + std::to_string(i % 5);
+      ASSERT_TRUE(store_.Append(app, "t" + std::to_string(i % 50), start, start + 600 * kSecond));
+      sessions_.push_back({start, start + 600 * kSecond, store_.apps().Find(app), 0});
+    }
+    store_.journal().Flush();
+  }
+
+  void TearDown() override { store_.Close(); }
+
+  ScopedTempDir dir_;
+  FocusStore store_;
+  std::vector<FocusSession> sessions_;
+};
+
+}  // namespace
+
+TEST_F(FocusQueryTest, AppFilteredRangeReadsOnlyMatchingRows) {
+  SessionQuery query;
+  query.filter_app = true;
+  query.app_id = store_.apps().Find("Slack");
+  query.from_us = 30 * kMicrosPerDay;
+  query.to_us = 60 * kMicrosPerDay;
+
+  uint64_t expected = 0;
+  for (const auto& session : sessions_) {
+    if (session.app_id == query.app_id && session.start_us < query.to_us &&
+        session.end_us > query.from_us) {
+      ++expected;
+    }
+  }
+
+  FocusQueryEngine engine(dir_.path());
+  std::vector<FocusSession> results;
+  QueryStats stats;
+  ASSERT_TRUE(engine.Query(query, [&](const FocusSession& session) {
+    results.push_back(session);
+    return true;
+  }, &stats));
+
+  EXPECT_EQ(results.size(), expected);
+  for (const auto& session : results) {
+    EXPECT_EQ(session.app_id, query.app_id);
+  }
+  EXPECT_GT(stats.segments_skipped, 0u);
+  // Only Slack rows of the overlapping segments are touched.
+  EXPECT_LT(stats.rows_read, expected + 2 * 6 * stats.segments_scanned);
+}
+
+TEST_F(FocusQueryTest, SealedSegmentIndexesArePersisted) {
+  FocusQueryEngine engine(dir_.path());
+  SessionQuery query;
+  query.filter_app = true;
+  query.app_id = store_.apps().Find("Editor1");
+  uint64_t first = 0;
+  ASSERT_TRUE(engine.Query(query, [&](const FocusSession&) { return ++first, true; }));
+
+  auto segments = FocusJournal::ListSegments(dir_.path());
+  ASSERT_GT(segments.size(), 1u);
+  SegmentIndex index;
+  EXPECT_TRUE(index.Load(dir_.path(), segments.front()));
+  EXPECT_FALSE(index.Load(dir_.path(), segments.back()));
+
+  FocusQueryEngine reopened(dir_.path());
+  uint64_t second = 0;
+  ASSERT_TRUE(reopened.Query(query, [&](const FocusSession&) { return ++second, true; }));
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(first, sessions_.size() * 3 / 16);
+}
+
+TEST_F(FocusQueryTest, UnfilteredRangeSeesAppendsToActiveSegment) {
+  FocusQueryEngine engine(dir_.path());
+  SessionQuery query;
+  query.from_us = 89 * kMicrosPerDay;
+  uint64_t before = 0;
+  ASSERT_TRUE(engine.Query(query, [&](const FocusSession&) { return ++before, true; }));
+  EXPECT_EQ(before, 96u);
+
+  int64_t start = 90 * kMicrosPerDay;
+  ASSERT_TRUE(store_.Append("Slack", "late", start, start + kSecond));
+  store_.journal().Flush();
+  uint64_t after = 0;
+  ASSERT_TRUE(engine.Query(query, [&](const FocusSession&) { return ++after, true; }));
+  EXPECT_EQ(after, before + 1);
+}
+
+TEST_F(FocusQueryTest, SkipsSegmentsThatCannotBeRead) {
+  auto segments = FocusJournal::ListSegments(dir_.path());
+  ASSERT_GT(segments.size(), 2u);
+  std::string damaged = FocusJournal::SegmentPath(dir_.path(), segments[1]);
+  std::FILE* file = std::fopen(damaged.c_str(), "r+b");
+  ASSERT_NE(file, nullptr);
+  std::fputc('X', file);
+  std::fclose(file);
+
+  FocusQueryEngine engine(dir_.path());
+  SessionQuery query;
+  uint64_t all = 0;
+  QueryStats stats;
+  ASSERT_TRUE(engine.Query(query, [&](const FocusSession&) { return ++all, true; }, &stats));
+  EXPECT_EQ(stats.damaged_segments, std::vector<uint32_t>{segments[1]});
+  EXPECT_GT(all, 0u);
+  EXPECT_LT(all, sessions_.size());
+
+  query.filter_app = true;
+  query.app_id = store_.apps().Find("Slack");
+  uint64_t slack = 0;
+  ASSERT_TRUE(engine.Query(query, [&](const FocusSession&) { return ++slack, true; }, &stats));
+  EXPECT_EQ(stats.damaged_segments, std::vector<uint32_t>{segments[1]});
+  EXPECT_GT(slack, 0u);
+}
+
+}  // namespace test
+}  // namespace app_focus_tracker
@@ -0,0 +1,431 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "focus_sampler.h"
+#include "sessionizer.h"
+
+namespace app_focus_tracker {
+namespace test {
+
+namespace {
+
+using std::chrono::steady_clock;
+
+// Focus moves to a new window every |period| samples.
+class ScriptedSource : public FocusSource {
+ public:
+  ScriptedSource(std::atomic<int>* samples, std::set<std::thread::id>* threads, std::mutex* mutex,
+                 int period)
+      : samples_(samples), threads_(threads), mutex_(mutex), period_(period) {}
+
+  bool Sample(FocusSample* sample) override {
+    {
+      std::lock_guard<std::mutex> lock(*mutex_);
+      threads_->insert(std::this_thread::get_id());
+    }
+    int n = samples_->fetch_add(1);
+    sample->window_id = static_cast<uint64_t>(n / period_);
+    sample->process_id = 42;
+    sample->app_name = "app" + std::to_string(n / period_);
+    sample->title = "title";
+    return true;
+  }
+
+ private:
+  std::atomic<int>* samples_;
+  std::set<std::thread::id>* threads_;
+  std::mutex* mutex_;
+  int period_;
+};
+
+class FakeIdleSource : public IdleSource {
+ public:
+  explicit FakeIdleSource(std::atomic<int64_t>* idle_us) : idle_us_(idle_us) {}
+  bool IdleTime(int64_t* idle_us) override {
+    ++polls;
+    *idle_us = idle_us_->load();
+    return true;
+  }
+
+  std::atomic<int> polls{0};
+
+ private:
+  std::atomic<int64_t>* idle_us_;
+};
+
+template <typename Predicate>
+bool WaitFor(Predicate predicate) {
+  auto deadline = steady_clock::now() + std::chrono::seconds(5);
+  while (!predicate()) {
+    if (steady_clock::now() > deadline) return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+FocusSample Sample(int64_t ts, uint64_t window, const std::string& title) {
+  FocusSample sample;
+  sample.timestamp_us = ts;
+  sample.window_id = window;
+  sample.app_name = "app";
+  sample.title = title;
+  return sample;
+}
+
+}  // namespace
+
+TEST(Sessionizer, ClosesSpanWhenFocusMoves) {
+  Sessionizer sessionizer;
+  FocusSpan closed;
+  EXPECT_FALSE(sessionizer.Push(Sample(0, 1, "a"), &closed));
+  EXPECT_FALSE(sessionizer.Push(Sample(10, 1, "a"), &closed));
+  ASSERT_TRUE(sessionizer.Push(Sample(20, 1, "b"), &closed));
+  EXPECT_EQ(closed.start_us, 0);
+  EXPECT_EQ(closed.end_us, 20);
+  EXPECT_EQ(closed.title, "a");
+  ASSERT_TRUE(sessionizer.Push(Sample(35, 2, "b"), &closed));
+  EXPECT_EQ(closed.duration_us(), 15);
+  ASSERT_TRUE(sessionizer.Close(50, &closed));
+  EXPECT_EQ(closed.window_id, 2u);
+  EXPECT_FALSE(sessionizer.Close(60, &closed));
+}
+
+TEST(SpanFilter, MatchesAppsAndDuration) {
+  FocusSpan span;
+  span.app_name = "Code.exe";
+  span.start_us = 0;
+  span.end_us = 5000000;
+
+  SpanFilter filter;
+  EXPECT_TRUE(filter.empty());
+  EXPECT_TRUE(filter.Matches(span));
+
+  filter.apps = {"devenv.exe", "code.EXE"};
+  EXPECT_TRUE(filter.Matches(span));
+  filter.exclude_apps = {"CODE.exe"};
+  EXPECT_FALSE(filter.Matches(span));
+  filter.exclude_apps.clear();
+
+  filter.min_duration_us = 5000001;
+  EXPECT_FALSE(filter.Matches(span));
+  filter.min_duration_us = 5000000;
+  EXPECT_TRUE(filter.Matches(span));
+
+  filter.apps = {"chrome.exe"};
+  EXPECT_FALSE(filter.Matches(span));
+}
+
+TEST(FocusSampler, FansOutOneThreadToEveryGranularity) {
+  std::atomic<int> samples{0};
+  std::set<std::thread::id> threads;
+  std::mutex threads_mutex;
+  FocusSampler sampler(std::make_unique<ScriptedSource>(&samples, &threads, &threads_mutex, 3),
+                       std::chrono::milliseconds(1));
+
+  std::atomic<int> raw{0};
+  std::atomic<int> spans{0};
+  std::atomic<int> batches{0};
+  std::atomic<int> batched_spans{0};
+  std::atomic<int> raw2{0};
+
+  SubscriptionOptions raw_options;
+  SubscriptionOptions span_options;
+  span_options.granularity = Granularity::kSpans;
+  SubscriptionOptions batch_options;
+  batch_options.granularity = Granularity::kBatched;
+  batch_options.batch_interval = std::chrono::hours(1);
+  batch_options.max_batch = 4;
+
+  auto a = sampler.Subscribe(raw_options, [&](const FocusSpan*, size_t count) { raw += static_cast<int>(count); });
+  // The tracker is already running when this subscribes, so its first
+  // span can be any app; after that they follow on without gaps.
+  int first_app = -1;
+  auto b = sampler.Subscribe(span_options, [&](const FocusSpan* span, size_t count) {
+    EXPECT_EQ(count, 1u);
+    ASSERT_EQ(span->app_name.rfind("app", 0), 0u);
+    int app = std::stoi(span->app_name.substr(3));
+    if (first_app < 0) first_app = app;
+    EXPECT_EQ(app, first_app + spans.load());
+    ++spans;
+  });
+  auto c = sampler.Subscribe(batch_options, [&](const FocusSpan*, size_t count) {
+    ++batches;
+    batched_spans += static_cast<int>(count);
+  });
+  auto d = sampler.Subscribe(raw_options, [&](const FocusSpan*, size_t) { ++raw2; });
+  EXPECT_EQ(sampler.subscriber_count(), 4u);
+
+  // Each subscriber joins a running tracker, so wait for all of them rather
+  // than only the batches.
+  ASSERT_TRUE(WaitFor([&] { return batches >= 2 && raw >= 24 && raw2 >= 24 && spans >= 8; }));
+  EXPECT_EQ(sampler.state(), TrackerState::kRunning);
+
+  sampler.Unsubscribe(a);
+  sampler.Unsubscribe(b);
+  sampler.Unsubscribe(d);
+  EXPECT_EQ(sampler.state(), TrackerState::kRunning);
+  sampler.Unsubscribe(c);
+  EXPECT_EQ(sampler.state(), TrackerState::kIdle);
+  EXPECT_EQ(sampler.subscriber_count(), 0u);
+
+  EXPECT_GE(raw.load(), 24);
+  EXPECT_GE(raw2.load(), 24);
+  EXPECT_GE(spans.load(), 8);
+  // Every batch but the final flush is full.
+  EXPECT_GE(batched_spans.load(), 4 * (batches.load() - 1));
+  std::lock_guard<std::mutex> lock(threads_mutex);
+  EXPECT_EQ(threads.size(), 1u);
+}
+
+TEST(FocusSampler, UnsubscribeFlushesPendingBatch) {
+  std::atomic<int> samples{0};
+  std::set<std::thread::id> threads;
+  std::mutex threads_mutex;
+  FocusSampler sampler(std::make_unique<ScriptedSource>(&samples, &threads, &threads_mutex, 1),
+                       std::chrono::milliseconds(1));
+  SubscriptionOptions options;
+  options.granularity = Granularity::kBatched;
+  options.batch_interval = std::chrono::hours(1);
+  options.max_batch = 1000000;
+
+  std::vector<size_t> deliveries;
+  auto id = sampler.Subscribe(options, [&](const FocusSpan*, size_t count) { deliveries.push_back(count); });
+  ASSERT_TRUE(WaitFor([&] { return samples > 5; }));
+  sampler.Unsubscribe(id);
+  ASSERT_EQ(deliveries.size(), 1u);
+  EXPECT_GE(deliveries[0], 4u);
+
+  int stopped_at = samples;
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(samples, stopped_at);
+}
+
+TEST(FocusSampler, FlushesBatchAtItsDeadlineWhileIdle) {
+  std::atomic<int> samples{0};
+  std::set<std::thread::id> threads;
+  std::mutex threads_mutex;
+  std::atomic<int64_t> idle_us{0};
+  ScheduleOptions schedule = ScheduleOptions::Fixed(std::chrono::milliseconds(1));
+  schedule.idle_threshold = std::chrono::milliseconds(100);
+  // Once idle, nothing but the batch deadline wakes the thread in time.
+  schedule.idle_interval = std::chrono::hours(1);
+  FocusSampler sampler(std::make_unique<ScriptedSource>(&samples, &threads, &threads_mutex, 5), schedule,
+                       std::make_unique<FakeIdleSource>(&idle_us));
+  SubscriptionOptions options;
+  options.granularity = Granularity::kBatched;
+  options.batch_interval = std::chrono::milliseconds(200);
+  options.max_batch = 1000000;
+
+  std::atomic<int> batches{0};
+  std::atomic<int> batched_spans{0};
+  auto id = sampler.Subscribe(options, [&](const FocusSpan*, size_t count) {
+    batched_spans += static_cast<int>(count);
+    ++batches;
+  });
+  ASSERT_TRUE(WaitFor([&] { return samples > 12; }));
+  idle_us = 3600LL * 1000000;
+  ASSERT_TRUE(WaitFor([&] { return batches >= 1; }));
+  EXPECT_GE(batched_spans.load(), 2);
+  sampler.Unsubscribe(id);
+}
+
+TEST(FocusSampler, FiltersBeforeDelivery) {
+  std::atomic<int> samples{0};
+  std::set<std::thread::id> threads;
+  std::mutex threads_mutex;
+  FocusSampler sampler(std::make_unique<ScriptedSource>(&samples, &threads, &threads_mutex, 2),
+                       std::chrono::milliseconds(1));
+
+  SubscriptionOptions options;
+  options.granularity = Granularity::kSpans;
+  options.filter.apps = {"APP1", "app3"};
+  std::vector<std::string> delivered;
+  std::mutex delivered_mutex;
+  auto spans = sampler.Subscribe(options, [&](const FocusSpan* span, size_t) {
+    std::lock_guard<std::mutex> lock(delivered_mutex);
+    delivered.push_back(span->app_name);
+  });
+
+  SubscriptionOptions raw_options;
+  raw_options.filter.exclude_apps = {"app0"};
+  std::atomic<int> raw_app0{0};
+  auto raw = sampler.Subscribe(raw_options, [&](const FocusSpan* span, size_t) {
+    if (span->app_name == "app0") ++raw_app0;
+  });
+
+  ASSERT_TRUE(WaitFor([&] {
+    std::lock_guard<std::mutex> lock(delivered_mutex);
+    return delivered.size() >= 2;
+  }));
+  sampler.Unsubscribe(spans);
+  sampler.Unsubscribe(raw);
+  EXPECT_EQ(delivered[0], "app1");
+  EXPECT_EQ(delivered[1], "app3");
+  EXPECT_EQ(raw_app0, 0);
+}
+
+TEST(FocusSampler, IdleClosesSpanAtLastInputAndStopsSampling) {
+  std::atomic<int> samples{0};
+  std::set<std::thread::id> threads;
+  std::mutex threads_mutex;
+  std::atomic<int64_t> idle_us{0};
+  auto idle = std::make_unique<FakeIdleSource>(&idle_us);
+  FakeIdleSource* idle_source = idle.get();
+  ScheduleOptions schedule = ScheduleOptions::Fixed(std::chrono::milliseconds(1));
+  schedule.idle_threshold = std::chrono::milliseconds(100);
+  schedule.idle_interval = std::chrono::milliseconds(50);
+  // Focus never moves, so the only span is the one idleness closes.
+  FocusSampler sampler(std::make_unique<ScriptedSource>(&samples, &threads, &threads_mutex, 1000000),
+                       schedule, std::move(idle));
+
+  std::mutex mutex;
+  std::vector<FocusSpan> spans;
+  std::atomic<int> raw{0};
+  SubscriptionOptions span_options;
+  span_options.granularity = Granularity::kSpans;
+  auto a = sampler.Subscribe(span_options, [&](const FocusSpan* span, size_t) {
+    std::lock_guard<std::mutex> lock(mutex);
+    spans.push_back(*span);
+  });
+  auto b = sampler.Subscribe(SubscriptionOptions(), [&](const FocusSpan*, size_t) { ++raw; });
+  ASSERT_TRUE(WaitFor([&] { return raw > 5; }));
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+  // The user stopped typing 200ms ago, while samples kept coming.
+  int64_t went_idle_us = 200000;
+  idle_us = went_idle_us;
+  ASSERT_TRUE(WaitFor([&] {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !spans.empty();
+  }));
+  auto now_us = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_NEAR(static_cast<double>(spans[0].end_us), static_cast<double>(now_us - went_idle_us), 50000);
+    EXPECT_GT(spans[0].duration_us(), 50000);
+  }
+  CurrentFocus focus;
+  EXPECT_FALSE(sampler.current().Read(&focus));
+
+  // While idle, focus is not sampled and only a slow idle poll runs.
+  int raw_at = raw;
+  int samples_at = samples;
+  int polls_at = idle_source->polls;
+  std::this_thread::sleep_for(std::chrono::milliseconds(120));
+  EXPECT_EQ(raw, raw_at);
+  EXPECT_EQ(samples, samples_at);
+  EXPECT_LE(idle_source->polls - polls_at, 4);
+
+  idle_us = 0;
+  ASSERT_TRUE(WaitFor([&] { return raw > raw_at + 3; }));
+  EXPECT_TRUE(sampler.current().Read(&focus));
+  sampler.Unsubscribe(a);
+  sampler.Unsubscribe(b);
+}
+
+TEST(FocusSampler, LockPausesSamplingAndClosesTheSpan) {
+  std::atomic<int> samples{0};
+  std::set<std::thread::id> threads;
+  std::mutex threads_mutex;
+  FocusSampler sampler(std::make_unique<ScriptedSource>(&samples, &threads, &threads_mutex, 1000000),
+                       std::chrono::milliseconds(1));
+  std::mutex mutex;
+  std::vector<FocusSpan> spans;
+  std::set<std::thread::id> span_threads;
+  SubscriptionOptions options;
+  options.granularity = Granularity::kSpans;
+  auto id = sampler.Subscribe(options, [&](const FocusSpan* span, size_t) {
+    std::lock_guard<std::mutex> lock(mutex);
+    spans.push_back(*span);
+    span_threads.insert(std::this_thread::get_id());
+  });
+  SubscriptionOptions batch_options;
+  batch_options.granularity = Granularity::kBatched;
+  batch_options.batch_interval = std::chrono::hours(1);
+  std::atomic<int> batched{0};
+  auto batch = sampler.Subscribe(batch_options, [&](const FocusSpan*, size_t count) {
+    batched += static_cast<int>(count);
+  });
+  ASSERT_TRUE(WaitFor([&] { return samples > 5; }));
+
+  // The sampling thread closes the span and flushes batches itself, then
+  // pauses.
+  auto locked_at = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  sampler.SetSessionLocked(true);
+  ASSERT_TRUE(WaitFor([&] { return sampler.state() == TrackerState::kPaused; }));
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(spans.size(), 1u);
+    EXPECT_GE(spans[0].end_us, locked_at);
+  }
+  EXPECT_EQ(batched, 1);
+  CurrentFocus focus;
+  EXPECT_FALSE(sampler.current().Read(&focus));
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  int paused_at = samples;
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(samples, paused_at);
+  EXPECT_FALSE(sampler.current().Read(&focus));
+
+  sampler.SetSessionLocked(false);
+  ASSERT_TRUE(WaitFor([&] { return sampler.current().Read(&focus); }));
+
+  // A suspend notification closes the reopened span at the given time.
+  int64_t suspended_at = focus.since_us + 1000;
+  sampler.NotifySuspended(suspended_at);
+  ASSERT_TRUE(WaitFor([&] {
+    std::lock_guard<std::mutex> lock(mutex);
+    return spans.size() == 2;
+  }));
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(spans[1].end_us, suspended_at);
+  }
+  EXPECT_EQ(batched, 2);
+  sampler.Unsubscribe(batch);
+  sampler.Unsubscribe(id);
+  {
+    std::lock_guard<std::mutex> lock(threads_mutex);
+    EXPECT_EQ(span_threads, threads);
+  }
+
+  // Subscribing while locked keeps the thread paused.
+  sampler.SetSessionLocked(true);
+  id = sampler.Subscribe(options, nullptr);
+  EXPECT_EQ(sampler.state(), TrackerState::kPaused);
+  sampler.Unsubscribe(id);
+}
+
+TEST(FocusSampler, AcquireSharesOneInstance) {
+  std::atomic<int> created{0};
+  std::atomic<int> samples{0};
+  std::set<std::thread::id> threads;
+  std::mutex threads_mutex;
+  auto factory = [&]() -> std::unique_ptr<FocusSource> {
+    ++created;
+    return std::make_unique<ScriptedSource>(&samples, &threads, &threads_mutex, 1);
+  };
+
+  auto first = FocusSampler::Acquire(factory, std::chrono::milliseconds(1));
+  auto second = FocusSampler::Acquire(factory, std::chrono::milliseconds(1));
+  EXPECT_EQ(first.get(), second.get());
+  EXPECT_EQ(created, 1);
+
+  first.reset();
+  second.reset();
+  auto third = FocusSampler::Acquire(factory, std::chrono::milliseconds(1));
+  EXPECT_EQ(created, 2);
+}
+
+}  // namespace test
+}  // namespace app_focus_tracker
@@ -0,0 +1,257 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+#include "focus_store.h"
+#include "scoped_temp_dir.h"
+#include "tracker_metrics.h"
+
+namespace app_focus_tracker {
+namespace test {
+
+namespace {
+
+constexpr int64_t kSecond = kMicrosPerSecond;
+
+void AppendSessions(FocusStore& store, int count, int64_t start) {
+  for (int i = 0; i < count; ++i) {
+    std::string app = "app" + std::to_string(i % 7);
+    std::string title = "title " + std::to_string(i % 31);
+    int64_t begin = start + i * 10 * kSecond;
+    ASSERT_TRUE(store.Append(app, title, begin, begin + (i % 9 + 1) * kSecond));
+  }
+}
+
+}  // namespace
+
+TEST(FocusStore, ReopenLoadsSnapshotAndReplaysOnlyTail) {
+  ScopedTempDir dir;
+  FocusStore::Options options;
+  options.snapshot_interval_bytes = 0;
+  {
+    FocusStore store;
+    ASSERT_TRUE(store.Open(dir.path(), options));
+    AppendSessions(store, 1000, 0);
+    ASSERT_TRUE(store.WriteSnapshot());
+    AppendSessions(store, 5, 20000 * kSecond);
+    // Skip the final snapshot written by Close() to leave a tail behind.
+    store.journal().Close();
+  }
+
+  FocusStore store;
+  ASSERT_TRUE(store.Open(dir.path(), options));
+  EXPECT_TRUE(store.open_stats().snapshot_loaded);
+  EXPECT_EQ(store.open_stats().replayed_records, 5u);
+  EXPECT_EQ(store.aggregates().session_count(), 1005u);
+  EXPECT_EQ(store.apps().size(), 7u);
+  EXPECT_EQ(store.titles().size(), 31u);
+}
+
+TEST(FocusStore, SnapshotMatchesFullReplay) {
+  ScopedTempDir dir;
+  FocusStore::Options options;
+  options.journal.segment_bytes = 4096;
+  options.snapshot_interval_bytes = 2048;
+  FocusAggregates expected;
+  {
+    FocusStore store;
+    ASSERT_TRUE(store.Open(dir.path(), options));
+    AppendSessions(store, 2000, 86000 * kSecond);
+    expected = store.aggregates();
+  }
+  EXPECT_GT(FocusJournal::ListSegments(dir.path()).size(), 1u);
+
+  FocusStore from_snapshot;
+  ASSERT_TRUE(from_snapshot.Open(dir.path(), options));
+  EXPECT_TRUE(from_snapshot.open_stats().snapshot_loaded);
+  EXPECT_EQ(from_snapshot.open_stats().replayed_records, 0u);
+  from_snapshot.journal().Close();
+
+  std::filesystem::remove(FocusStore::SnapshotPath(dir.path()));
+  FocusStore from_journal;
+  ASSERT_TRUE(from_journal.Open(dir.path(), options));
+  EXPECT_FALSE(from_journal.open_stats().snapshot_loaded);
+
+  for (const FocusStore* store : {&from_snapshot, &from_journal}) {
+    EXPECT_EQ(store->aggregates().session_count(), expected.session_count());
+    EXPECT_EQ(store->aggregates().total_focus_us(), expected.total_focus_us());
+    EXPECT_EQ(store->aggregates().top_apps(), expected.top_apps());
+    EXPECT_EQ(store->aggregates().daily_rollups(), expected.daily_rollups());
+  }
+}
+
+TEST(FocusStore, CorruptSnapshotFallsBackToJournal) {
+  ScopedTempDir dir;
+  FocusStore::Options options;
+  {
+    FocusStore store;
+    ASSERT_TRUE(store.Open(dir.path(), options));
+    AppendSessions(store, 50, 0);
+  }
+  std::FILE* file = std::fopen(FocusStore::SnapshotPath(dir.path()).c_str(), "r+b");
+  ASSERT_NE(file, nullptr);
+  std::fseek(file, 20, SEEK_SET);
+  std::fputc(0x5a, file);
+  std::fclose(file);
+
+  FocusStore store;
+  ASSERT_TRUE(store.Open(dir.path(), options));
+  EXPECT_FALSE(store.open_stats().snapshot_loaded);
+  EXPECT_EQ(store.aggregates().session_count(), 50u);
+}
+
+TEST(FocusStore, SnapshotIsSyncedBeforeItReplacesTheOldOne) {
+  ScopedTempDir dir;
+  FocusStore::Options options;
+  options.snapshot_interval_bytes = 0;
+  FocusStore store;
+  ASSERT_TRUE(store.Open(dir.path(), options));
+  AppendSessions(store, 10, 0);
+  uint64_t fsyncs = TrackerMetrics::Get().value(Counter::kFsyncs);
+  ASSERT_TRUE(store.WriteSnapshot());
+  EXPECT_GE(TrackerMetrics::Get().value(Counter::kFsyncs), fsyncs + 1);
+  EXPECT_TRUE(std::filesystem::exists(FocusStore::SnapshotPath(dir.path())));
+  EXPECT_FALSE(std::filesystem::exists(FocusStore::SnapshotPath(dir.path()) + ".tmp"));
+}
+
+TEST(FocusStore, TornJournalTailIsDropped) {
+  ScopedTempDir dir;
+  FocusStore::Options options;
+  options.snapshot_interval_bytes = 0;
+  std::string segment;
+  {
+    FocusStore store;
+    ASSERT_TRUE(store.Open(dir.path(), options));
+    AppendSessions(store, 10, 0);
+    segment = FocusJournal::SegmentPath(dir.path(), store.journal().end().segment);
+    store.journal().Close();
+  }
+  std::filesystem::remove(FocusStore::SnapshotPath(dir.path()));
+  auto size = std::filesystem::file_size(segment);
+  std::filesystem::resize_file(segment, size - 3);
+
+  FocusStore store;
+  ASSERT_TRUE(store.Open(dir.path(), options));
+  EXPECT_EQ(store.aggregates().session_count(), 9u);
+  AppendSessions(store, 1, 500 * kSecond);
+  EXPECT_EQ(store.aggregates().session_count(), 10u);
+}
+
+TEST(FocusStore, DamagedNewestSegmentIsKeptAndSkipped) {
+  ScopedTempDir dir;
+  FocusStore::Options options;
+  options.snapshot_interval_bytes = 0;
+  std::string segment;
+  {
+    FocusStore store;
+    ASSERT_TRUE(store.Open(dir.path(), options));
+    AppendSessions(store, 10, 0);
+    segment = FocusJournal::SegmentPath(dir.path(), store.journal().end().segment);
+    store.journal().Close();
+  }
+  std::filesystem::remove(FocusStore::SnapshotPath(dir.path()));
+  auto size = std::filesystem::file_size(segment);
+  std::FILE* file = std::fopen(segment.c_str(), "r+b");
+  ASSERT_NE(file, nullptr);
+  std::fputc('X', file);
+  std::fclose(file);
+
+  FocusStore store;
+  ASSERT_TRUE(store.Open(dir.path(), options));
+  EXPECT_EQ(store.journal().damaged_segment(), 1u);
+  EXPECT_EQ(store.open_stats().damaged_segments, 1u);
+  EXPECT_EQ(store.journal().end().segment, 2u);
+  EXPECT_EQ(std::filesystem::file_size(segment), size);
+  AppendSessions(store, 1, 500 * kSecond);
+  EXPECT_EQ(store.aggregates().session_count(), 1u);
+}
+
+TEST(FocusStore, MissingMiddleSegmentLeavesPlaceholderNames) {
+  ScopedTempDir dir;
+  FocusStore::Options options;
+  options.journal.segment_bytes = 4096;
+  options.snapshot_interval_bytes = 0;
+  constexpr uint32_t kTitles = 400;
+  {
+    FocusStore store;
+    ASSERT_TRUE(store.Open(dir.path(), options));
+    // Every session brings a title of its own, so each segment defines some.
+    for (uint32_t i = 0; i < kTitles; ++i) {
+      ASSERT_TRUE(store.Append("app", "title " + std::to_string(i), i * kSecond, i * kSecond + 1));
+    }
+    store.journal().Close();
+  }
+  auto segments = FocusJournal::ListSegments(dir.path());
+  ASSERT_GE(segments.size(), 3u);
+  std::filesystem::remove(FocusJournal::SegmentPath(dir.path(), segments[1]));
+
+  {
+    FocusStore store;
+    ASSERT_TRUE(store.Open(dir.path(), options));
+    EXPECT_GT(store.open_stats().missing_names, 0u);
+    EXPECT_LT(store.aggregates().session_count(), kTitles);
+    ASSERT_EQ(store.titles().size(), kTitles);
+    EXPECT_EQ(*store.titles().Lookup(kTitles - 1), "title " + std::to_string(kTitles - 1));
+    // New strings continue after the placeholders rather than reusing them.
+    ASSERT_TRUE(store.Append("app", "new title", kTitles * kSecond, kTitles * kSecond + 1));
+    EXPECT_EQ(store.titles().Find("new title"), kTitles);
+  }
+
+  FocusStore store;
+  ASSERT_TRUE(store.Open(dir.path(), options));
+  EXPECT_TRUE(store.open_stats().snapshot_loaded);
+  EXPECT_EQ(store.titles().size(), kTitles + 1);
+}
+
+TEST(FocusStore, EmptyTitleNeverResolvesToAPlaceholder) {
+  ScopedTempDir dir;
+  FocusStore::Options options;
+  options.journal.segment_bytes = 4096;
+  options.snapshot_interval_bytes = 0;
+  {
+    FocusStore store;
+    ASSERT_TRUE(store.Open(dir.path(), options));
+    for (uint32_t i = 0; i < 400; ++i) {
+      ASSERT_TRUE(store.Append("app", "title " + std::to_string(i), i * kSecond, i * kSecond + 1));
+    }
+    store.journal().Close();
+  }
+  auto segments = FocusJournal::ListSegments(dir.path());
+  ASSERT_GE(segments.size(), 3u);
+  std::filesystem::remove(FocusJournal::SegmentPath(dir.path(), segments[1]));
+
+  uint32_t empty = 0;
+  {
+    FocusStore store;
+    ASSERT_TRUE(store.Open(dir.path(), options));
+    ASSERT_GT(store.open_stats().missing_names, 0u);
+    EXPECT_EQ(store.titles().Find(""), StringDictionary::kNotFound);
+    ASSERT_TRUE(store.Append("app", "", 1000 * kSecond, 1001 * kSecond));
+    empty = store.titles().Find("");
+    EXPECT_EQ(empty, 400u);
+  }
+
+  // The snapshot keeps placeholders apart from the real empty title.
+  FocusStore store;
+  ASSERT_TRUE(store.Open(dir.path(), options));
+  ASSERT_TRUE(store.open_stats().snapshot_loaded);
+  EXPECT_EQ(store.titles().Find(""), empty);
+  ASSERT_TRUE(store.Append("app", "", 1002 * kSecond, 1003 * kSecond));
+  EXPECT_EQ(store.titles().size(), 401u);
+}
+
+TEST(FocusAggregates, SplitsSessionsAtDayBoundaries) {
+  FocusAggregates aggregates;
+  aggregates.Apply(FocusSession{kMicrosPerDay - 60 * kSecond,
+                                kMicrosPerDay + 30 * kSecond, 3, 0});
+  const auto& days = aggregates.daily_rollups();
+  ASSERT_EQ(days.size(), 2u);
+  EXPECT_EQ(days.at(0).at(3), 60 * kSecond);
+  EXPECT_EQ(days.at(1).at(3), 30 * kSecond);
+  EXPECT_EQ(aggregates.app_totals().at(3).focus_us, 90 * kSecond);
+}
+
+}  // namespace test
+}  // namespace app_focus_tracker
@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "focus_sampler.h"
+#include "focus_trace.h"
+#include "virtual_clock.h"
+
+namespace app_focus_tracker {
+namespace test {
+
+namespace {
+
+using std::chrono::seconds;
+
+// 2026-01-01T00:00:00Z.
+constexpr int64_t kStartUs = 1767225600LL * 1000000;
+constexpr int64_t kSecondUs = 1000000;
+
+std::string TempFile(const std::string& name) {
+  auto path = std::filesystem::temp_directory_path() / ("aft_trace_test_" + name);
+  std::filesystem::remove(path);
+  return path.string();
+}
+
+FocusSample Focus(int64_t ts, int64_t interval, uint64_t window, const std::string& app,
+                  const std::string& title) {
+  FocusSample sample;
+  sample.timestamp_us = ts;
+  sample.interval_us = interval;
+  sample.window_id = window;
+  sample.process_id = static_cast<uint32_t>(1000 + window);
+  sample.app_name = app;
+  sample.title = title;
+  return sample;
+}
+
+std::vector<FocusSample> ScriptedTrace() {
+  std::vector<FocusSample> trace;
+  trace.push_back(Focus(kStartUs, 5 * kSecondUs, 1, "code", "main.cpp"));
+  trace.push_back(Focus(kStartUs + 5 * kSecondUs, 7 * kSecondUs, 2, "chrome", "Docs \xE2\x80\x94 t\xC3\xA9st"));
+  trace.push_back(Focus(kStartUs + 12 * kSecondUs, 3 * kSecondUs, 1, "code", "main.cpp"));
+  return trace;
+}
+
+void ExpectSameSample(const FocusSample& actual, const FocusSample& expected) {
+  EXPECT_EQ(actual.timestamp_us, expected.timestamp_us);
+  EXPECT_EQ(actual.interval_us, expected.interval_us);
+  EXPECT_EQ(actual.kind, expected.kind);
+  EXPECT_EQ(actual.window_id, expected.window_id);
+  EXPECT_EQ(actual.process_id, expected.process_id);
+  EXPECT_EQ(actual.app_name, expected.app_name);
+  EXPECT_EQ(actual.title, expected.title);
+}
+
+// Focus moves to a new window every |period| samples.
+class CountingSource : public FocusSource {
+ public:
+  explicit CountingSource(int period) : period_(period) {}
+  bool Sample(FocusSample* sample) override {
+    int window = n_++ / period_;
+    sample->window_id = static_cast<uint64_t>(window);
+    sample->app_name = "app" + std::to_string(window % 2);
+    sample->title = "window " + std::to_string(window);
+    return true;
+  }
+
+ private:
+  int period_;
+  int n_ = 0;
+};
+
+}  // namespace
+
+TEST(FocusTrace, RoundTripsEveryKindOfSample) {
+  std::string path = TempFile("round_trip");
+  std::vector<FocusSample> written = ScriptedTrace();
+  FocusSample idle;
+  idle.kind = SampleKind::kIdle;
+  idle.timestamp_us = kStartUs + 15 * kSecondUs;
+  written.push_back(idle);
+  FocusSample suspended;
+  suspended.kind = SampleKind::kSuspended;
+  // Earlier than the previous record, as a late suspend notification is.
+  suspended.timestamp_us = kStartUs + 14 * kSecondUs;
+  written.push_back(suspended);
+  written.push_back(Focus(kStartUs + 3600 * kSecondUs, kSecondUs, UINT64_MAX, "code", ""));
+
+  FocusTraceWriter writer;
+  ASSERT_TRUE(writer.Open(path));
+  for (const FocusSample& sample : written) ASSERT_TRUE(writer.Append(sample));
+  ASSERT_TRUE(writer.Close());
+  EXPECT_EQ(writer.samples(), written.size());
+  EXPECT_EQ(writer.bytes(), std::filesystem::file_size(path));
+
+  std::vector<FocusSample> read;
+  ASSERT_TRUE(ReadFocusTrace(path, &read));
+  ASSERT_EQ(read.size(), written.size());
+  for (size_t i = 0; i < read.size(); ++i) ExpectSameSample(read[i], written[i]);
+}
+
+TEST(FocusTrace, SteadySamplesAreCompact) {
+  std::string path = TempFile("compact");
+  FocusTraceWriter writer;
+  ASSERT_TRUE(writer.Open(path));
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_TRUE(writer.Append(Focus(kStartUs + i * kSecondUs, kSecondUs, 7, "code", "a long window title")));
+  }
+  ASSERT_TRUE(writer.Close());
+  EXPECT_LT(writer.bytes(), 1000u * 16);
+}
+
+TEST(FocusTrace, IgnoresATornFinalRecord) {
+  std::string path = TempFile("torn");
+  FocusTraceWriter writer;
+  ASSERT_TRUE(writer.Open(path));
+  for (const FocusSample& sample : ScriptedTrace()) writer.Append(sample);
+  ASSERT_TRUE(writer.Close());
+  std::filesystem::resize_file(path, writer.bytes() - 1);
+
+  std::vector<FocusSample> read;
+  ASSERT_TRUE(ReadFocusTrace(path, &read));
+  EXPECT_EQ(read.size(), 2u);
+
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  std::fputs("not a trace", file);
+  std::fclose(file);
+  EXPECT_FALSE(ReadFocusTrace(path, &read));
+  EXPECT_FALSE(ReadFocusTrace(TempFile("missing"), &read));
+}
+
+TEST(FocusTrace, ReplaysAsFastAsPossible) {
+  TraceReplaySource source(ScriptedTrace(), TraceReplaySource::Speed::kAsFastAsPossible);
+  std::vector<FocusSample> expected = ScriptedTrace();
+  for (const FocusSample& recorded : expected) {
+    FocusSample sample;
+    ASSERT_TRUE(source.Sample(&sample));
+    EXPECT_EQ(sample.window_id, recorded.window_id);
+    EXPECT_EQ(sample.title, recorded.title);
+  }
+  EXPECT_TRUE(source.finished());
+  FocusSample sample;
+  EXPECT_FALSE(source.Sample(&sample));
+  EXPECT_EQ(source.replayed(), expected.size());
+}
+
+TEST(FocusTrace, ReplaysAtOriginalSpeedThroughTheSampler) {
+  VirtualClock clock(kStartUs);
+  ScheduleOptions schedule = ScheduleOptions::Fixed(seconds(1));
+  schedule.clock = &clock;
+  auto source = std::make_unique<TraceReplaySource>(ScriptedTrace(), TraceReplaySource::Speed::kOriginal,
+                                                    &clock);
+  TraceReplaySource* replay = source.get();
+  FocusSampler sampler(std::move(source), schedule);
+  std::vector<FocusSpan> spans;
+  SubscriptionOptions options;
+  options.granularity = Granularity::kSpans;
+  sampler.Subscribe(options, [&spans](const FocusSpan* span, size_t) { spans.push_back(*span); });
+
+  clock.RunFor(seconds(20));
+  EXPECT_TRUE(replay->finished());
+  // Sampled every second for the 15 seconds the recording covers.
+  EXPECT_EQ(replay->replayed(), 15u);
+  ASSERT_EQ(spans.size(), 2u);
+  EXPECT_EQ(spans[0].app_name, "code");
+  EXPECT_EQ(spans[0].start_us, kStartUs);
+  EXPECT_EQ(spans[0].end_us, kStartUs + 5 * kSecondUs);
+  EXPECT_EQ(spans[1].app_name, "chrome");
+  EXPECT_EQ(spans[1].end_us, kStartUs + 12 * kSecondUs);
+}
+
+TEST(FocusTrace, SamplerCapturesWhatItSampled) {
+  std::string path = TempFile("capture");
+  VirtualClock clock(kStartUs);
+  ScheduleOptions schedule = ScheduleOptions::Fixed(seconds(1));
+  schedule.clock = &clock;
+  FocusSampler sampler(std::make_unique<CountingSource>(10), schedule);
+  std::vector<FocusSample> raw;
+  EXPECT_EQ(sampler.StopCapture(), -1);
+  ASSERT_TRUE(sampler.StartCapture(path));
+  sampler.Subscribe(SubscriptionOptions(), [&raw](const FocusSpan* span, size_t) {
+    FocusSample sample;
+    sample.window_id = span->window_id;
+    sample.title = span->title;
+    raw.push_back(sample);
+  });
+  clock.RunFor(seconds(29));
+  int64_t captured = sampler.StopCapture();
+  ASSERT_EQ(captured, 30);
+  ASSERT_EQ(raw.size(), 30u);
+
+  std::vector<FocusSample> read;
+  ASSERT_TRUE(ReadFocusTrace(path, &read));
+  ASSERT_EQ(read.size(), 30u);
+  for (size_t i = 0; i < read.size(); ++i) {
+    EXPECT_EQ(read[i].timestamp_us, kStartUs + static_cast<int64_t>(i) * kSecondUs);
+    EXPECT_EQ(read[i].window_id, raw[i].window_id);
+    EXPECT_EQ(read[i].title, raw[i].title);
+  }
+}
+
+}  // namespace test
+}  // namespace app_focus_tracker
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "focus_tracker.h"
+
+namespace app_focus_tracker {
+namespace test {
+
+namespace {
+
+using std::chrono::steady_clock;
+
+class CountingSource : public FocusSource {
+ public:
+  explicit CountingSource(std::atomic<int>* samples) : samples_(samples) {}
+  bool Sample(FocusSample* sample) override {
+    sample->app_name = "app";
+    sample->title = "title " + std::to_string(samples_->fetch_add(1));
+    return true;
+  }
+
+ private:
+  std::atomic<int>* samples_;
+};
+
+template <typename Predicate>
+bool WaitFor(Predicate predicate) {
+  auto deadline = steady_clock::now() + std::chrono::seconds(5);
+  while (!predicate()) {
+    if (steady_clock::now() > deadline) return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(FocusTracker, StopDoesNotWaitForTheSamplingPeriod) {
+  std::atomic<int> samples{0};
+  std::atomic<int> delivered{0};
+  FocusTracker tracker(std::make_unique<CountingSource>(&samples),
+                       [&](const FocusSample&) { ++delivered; }, std::chrono::hours(1));
+  ASSERT_TRUE(tracker.Start());
+  ASSERT_TRUE(WaitFor([&] { return delivered == 1; }));
+
+  auto started = steady_clock::now();
+  tracker.Stop();
+  EXPECT_LT(steady_clock::now() - started, std::chrono::milliseconds(100));
+  EXPECT_EQ(tracker.state(), TrackerState::kIdle);
+}
+
+TEST(FocusTracker, StartTwiceIsRejected) {
+  std::atomic<int> samples{0};
+  FocusTracker tracker(std::make_unique<CountingSource>(&samples), [](const FocusSample&) {},
+                       std::chrono::milliseconds(1));
+  EXPECT_TRUE(tracker.Start());
+  EXPECT_FALSE(tracker.Start());
+  tracker.Stop();
+  tracker.Stop();
+  EXPECT_TRUE(tracker.Start());
+  EXPECT_EQ(tracker.state(), TrackerState::kRunning);
+}
+
+TEST(FocusTracker, PauseAndResume) {
+  std::atomic<int> samples{0};
+  std::atomic<int> delivered{0};
+  FocusTracker tracker(std::make_unique<CountingSource>(&samples),
+                       [&](const FocusSample&) { ++delivered; }, std::chrono::milliseconds(1));
+  EXPECT_FALSE(tracker.Pause());
+  ASSERT_TRUE(tracker.Start());
+  ASSERT_TRUE(WaitFor([&] { return delivered > 2; }));
+
+  ASSERT_TRUE(tracker.Pause());
+  EXPECT_EQ(tracker.state(), TrackerState::kPaused);
+  // At most one sample already in flight may still land.
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  int paused_at = delivered;
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(delivered, paused_at);
+
+  ASSERT_TRUE(tracker.Resume());
+  ASSERT_TRUE(WaitFor([&] { return delivered > paused_at + 2; }));
+
+  ASSERT_TRUE(tracker.Pause());
+  auto started = steady_clock::now();
+  tracker.Stop();
+  EXPECT_LT(steady_clock::now() - started, std::chrono::milliseconds(100));
+}
+
+TEST(FocusTracker, StopFromCallbackDoesNotDeadlock) {
+  std::atomic<int> samples{0};
+  FocusTracker* self = nullptr;
+  FocusTracker tracker(std::make_unique<CountingSource>(&samples),
+                       [&](const FocusSample&) { self->Stop(); }, std::chrono::milliseconds(1));
+  self = &tracker;
+  ASSERT_TRUE(tracker.Start());
+  ASSERT_TRUE(WaitFor([&] { return tracker.state() == TrackerState::kStopping; }));
+  EXPECT_EQ(samples, 1);
+  EXPECT_TRUE(tracker.Start());
+  tracker.Stop();
+}
+
+}  // namespace test
+}  // namespace app_focus_tracker
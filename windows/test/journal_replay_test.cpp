@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+#include "focus_store.h"
+#include "journal_replay.h"
+
+namespace app_focus_tracker {
+namespace test {
+
+namespace {
+
+constexpr int64_t kSecond = kMicrosPerSecond;
+
+std::string TempDir(const std::string& name) {
+  auto path = std::filesystem::temp_directory_path() / ("aft_replay_test_" + name);
+  std::filesystem::remove_all(path);
+  return path.string();
+}
+
+// Writes |days| of synthetic history: a switch every few minutes during a
+// ten hour working day. AFT_REPLAY_YEARS overrides the length of the history.
+uint64_t WriteHistory(const std::string& dir, int days) {
+  FocusStore::Options options;
+  options.journal.segment_bytes = 64 * 1024;
+  options.snapshot_interval_bytes = 0;
+  FocusStore store;
+  EXPECT_TRUE(store.Open(dir, options));
+  uint64_t sessions = 0;
+  uint32_t seed = 12345;
+  for (int day = 0; day < days; ++day) {
+    int64_t t = day * kMicrosPerDay + 8 * 3600 * kSecond;
+    int64_t day_end = t + 10 * 3600 * kSecond;
+    while (t < day_end) {
+      seed = seed * 1664525u + 1013904223u;
+      int64_t length = (30 + (seed >> 8) % 600) * kSecond;
+      std::string app = "app" + std::to_string((seed >> 4) % 40);
+      std::string title = "document " + std::to_string((seed >> 12) % 2000);
+      store.Append(app, title, t, t + length);
+      t += length;
+      ++sessions;
+    }
+  }
+  store.journal().Close();
+  return sessions;
+}
+
+int HistoryDays() {
+  const char* years = std::getenv("AFT_REPLAY_YEARS");
+  return years ? static_cast<int>(std::atof(years) * 365) : 120;
+}
+
+}  // namespace
+
+TEST(JournalReplay, ParallelMatchesSequentialAndReportsThroughput) {
+  std::string dir = TempDir("throughput");
+  uint64_t sessions = WriteHistory(dir, HistoryDays());
+  ASSERT_GT(FocusJournal::ListSegments(dir).size(), 2u);
+
+  ReplayOptions sequential;
+  sequential.threads = 1;
+  ReplayResult expected = ReplayJournal(dir, sequential);
+  ReplayResult parallel = ReplayJournal(dir, ReplayOptions());
+
+  ASSERT_TRUE(expected.ok);
+  ASSERT_TRUE(parallel.ok);
+  EXPECT_EQ(parallel.aggregates.session_count(), sessions);
+  EXPECT_EQ(parallel.records, expected.records);
+  EXPECT_EQ(parallel.aggregates.total_focus_us(), expected.aggregates.total_focus_us());
+  EXPECT_EQ(parallel.aggregates.top_apps(), expected.aggregates.top_apps());
+  EXPECT_EQ(parallel.aggregates.daily_rollups(), expected.aggregates.daily_rollups());
+  EXPECT_EQ(parallel.app_names, expected.app_names);
+  EXPECT_EQ(parallel.titles, expected.titles);
+
+  ReplayOptions verify;
+  verify.verify_only = true;
+  ReplayResult verified = ReplayJournal(dir, verify);
+  EXPECT_TRUE(verified.ok);
+
+  std::printf("replay: %llu records, %llu bytes\n",
+              static_cast<unsigned long long>(parallel.records),
+              static_cast<unsigned long long>(parallel.bytes));
+  std::printf("  sequential: %.0f records/s\n", expected.records_per_second());
+  std::printf("  parallel (%zu threads): %.0f records/s\n", parallel.threads,
+              parallel.records_per_second());
+  std::printf("  verify (%zu threads): %.0f records/s\n", verified.threads,
+              verified.records_per_second());
+  std::filesystem::remove_all(dir);
+}
+
+TEST(JournalReplay, ReportsDamagedSealedSegments) {
+  std::string dir = TempDir("damaged");
+  WriteHistory(dir, 30);
+  auto segments = FocusJournal::ListSegments(dir);
+  ASSERT_GT(segments.size(), 2u);
+  std::string sealed = FocusJournal::SegmentPath(dir, segments[1]);
+  std::FILE* file = std::fopen(sealed.c_str(), "r+b");
+  ASSERT_NE(file, nullptr);
+  std::fseek(file, 1000, SEEK_SET);
+  std::fputc(0xff, file);
+  std::fclose(file);
+
+  ReplayOptions verify;
+  verify.verify_only = true;
+  ReplayResult result = ReplayJournal(dir, verify);
+  EXPECT_FALSE(result.ok);
+  ASSERT_EQ(result.damaged_segments.size(), 1u);
+  EXPECT_EQ(result.damaged_segments[0], segments[1]);
+  std::filesystem::remove_all(dir);
+}
+
+}  // namespace test
+}  // namespace app_focus_tracker
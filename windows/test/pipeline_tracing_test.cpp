@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pipeline_tracing.h"
+
+namespace app_focus_tracker {
+namespace test {
+
+namespace {
+
+// One protobuf field; |bytes| is set for length-delimited ones.
+struct ProtoField {
+  uint32_t number = 0;
+  uint64_t value = 0;
+  std::string bytes;
+};
+
+bool ReadVarint(const std::string& data, size_t* pos, uint64_t* value) {
+  *value = 0;
+  for (int shift = 0; *pos < data.size() && shift < 64; shift += 7) {
+    auto byte = static_cast<uint8_t>(data[(*pos)++]);
+    *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) return true;
+  }
+  return false;
+}
+
+std::vector<ProtoField> ParseMessage(const std::string& data) {
+  std::vector<ProtoField> fields;
+  size_t pos = 0;
+  while (pos < data.size()) {
+    uint64_t tag = 0;
+    ProtoField field;
+    if (!ReadVarint(data, &pos, &tag)) break;
+    field.number = static_cast<uint32_t>(tag >> 3);
+    if ((tag & 7) == 0) {
+      if (!ReadVarint(data, &pos, &field.value)) break;
+    } else if ((tag & 7) == 2) {
+      uint64_t size = 0;
+      if (!ReadVarint(data, &pos, &size) || size > data.size() - pos) break;
+      field.bytes = data.substr(pos, size);
+      pos += size;
+    } else {
+      ADD_FAILURE() << "unexpected wire type " << (tag & 7);
+      break;
+    }
+    fields.push_back(std::move(field));
+  }
+  return fields;
+}
+
+const ProtoField* Find(const std::vector<ProtoField>& fields, uint32_t number) {
+  for (const ProtoField& field : fields) {
+    if (field.number == number) return &field;
+  }
+  return nullptr;
+}
+
+// "B name @ts" and "E @ts" for each track event in a Perfetto trace.
+std::vector<std::string> SliceEdges(const std::string& trace) {
+  std::vector<std::string> edges;
+  for (const ProtoField& packet : ParseMessage(trace)) {
+    EXPECT_EQ(packet.number, 1u);
+    auto fields = ParseMessage(packet.bytes);
+    const ProtoField* event = Find(fields, 11);
+    if (!event) continue;
+    auto event_fields = ParseMessage(event->bytes);
+    const ProtoField* type = Find(event_fields, 9);
+    const ProtoField* name = Find(event_fields, 23);
+    const ProtoField* timestamp = Find(fields, 8);
+    if (!type || !timestamp) continue;
+    edges.push_back((type->value == 1 ? "B " + (name ? name->bytes : "?") + " @" : "E @") +
+                    std::to_string(timestamp->value));
+  }
+  return edges;
+}
+
+}  // namespace
+
+TEST(PipelineTracing, RecordsNothingWhileStopped) {
+  PipelineTracing::Start();
+  PipelineTracing::Stop();
+  { TracingScope scope("untraced"); }
+  EXPECT_FALSE(PipelineTracing::enabled());
+  EXPECT_EQ(PipelineTracing::ChromeJson().find("untraced"), std::string::npos);
+}
+
+TEST(PipelineTracing, DumpsNestedScopesAsChromeJson) {
+  PipelineTracing::Start();
+  PipelineTracing::SetThreadName("test main");
+  {
+    TracingScope outer("outer");
+    TracingScope inner("inner");
+  }
+  PipelineTracing::Stop();
+
+  std::string json = PipelineTracing::ChromeJson();
+  EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+  EXPECT_NE(json.find("\"args\":{\"name\":\"test main\"}"), std::string::npos);
+  size_t outer = json.find("{\"ph\":\"X\",\"name\":\"outer\"");
+  size_t inner = json.find("{\"ph\":\"X\",\"name\":\"inner\"");
+  ASSERT_NE(outer, std::string::npos);
+  ASSERT_NE(inner, std::string::npos);
+  // Sorted by start, so the enclosing span comes first.
+  EXPECT_LT(outer, inner);
+  EXPECT_EQ(json.substr(json.size() - 2), "]}");
+}
+
+TEST(PipelineTracing, KeepsSpansFromExitedThreadsUntilTheNextStart) {
+  PipelineTracing::Start();
+  std::thread worker([] {
+    PipelineTracing::SetThreadName("worker");
+    TracingScope scope("work");
+  });
+  worker.join();
+  PipelineTracing::Stop();
+  EXPECT_NE(PipelineTracing::ChromeJson().find("\"name\":\"work\""), std::string::npos);
+
+  PipelineTracing::Start();
+  PipelineTracing::Stop();
+  EXPECT_EQ(PipelineTracing::ChromeJson().find("\"name\":\"work\""), std::string::npos);
+}
+
+TEST(PipelineTracing, PerfettoSlicesNestPerTrack) {
+  PipelineTracing::Start();
+  // Recorded as scopes end: inner ones first.
+  PipelineTracing::Record("inner", 200, 300);
+  PipelineTracing::Record("outer", 100, 400);
+  PipelineTracing::Record("next", 400, 500);
+  PipelineTracing::Stop();
+
+  std::string trace = PipelineTracing::PerfettoProto();
+  auto packets = ParseMessage(trace);
+  ASSERT_FALSE(packets.empty());
+  // The thread's track is described before any of its events.
+  auto first = ParseMessage(packets[0].bytes);
+  ASSERT_NE(Find(first, 60), nullptr);
+  EXPECT_NE(Find(ParseMessage(Find(first, 60)->bytes), 4), nullptr);
+
+  std::vector<std::string> expected = {"B outer @100", "B inner @200", "E @300", "E @400",
+                                       "B next @400", "E @500"};
+  EXPECT_EQ(SliceEdges(trace), expected);
+}
+
+TEST(PipelineTracing, CountsSpansPastCapacityAsDropped) {
+  PipelineTracing::Start();
+  for (size_t i = 0; i < PipelineTracing::kThreadCapacity + 5; ++i) {
+    PipelineTracing::Record("span", 1000 + i, 1001 + i);
+  }
+  PipelineTracing::Stop();
+  EXPECT_EQ(PipelineTracing::dropped(), 5u);
+
+  PipelineTracing::Start();
+  PipelineTracing::Stop();
+  EXPECT_EQ(PipelineTracing::dropped(), 0u);
+}
+
+}  // namespace test
+}  // namespace app_focus_tracker
@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "event_encoding.h"
+#include "focus_sampler.h"
+#include "process_memory.h"
+#include "synthetic_workload.h"
+#include "tracker_metrics.h"
+#include "virtual_clock.h"
+
+namespace app_focus_tracker {
+namespace test {
+
+namespace {
+
+// 2026-01-01T00:00:00Z.
+constexpr int64_t kStartUs = 1767225600LL * 1000000;
+
+// What the engine may spend per minute of tracking once it has settled.
+struct ResourceBudget {
+  double wakeups_per_minute = 0;
+  double cpu_ms_per_minute = 0;
+  double context_switches_per_minute = 0;
+};
+
+// Settling costs on top of the per-minute rates: the backoff from 500ms to
+// 8s takes four extra samples, and the first few waits cost context
+// switches of their own.
+constexpr double kSettleWakeups = 5;
+constexpr double kSettleCpuMs = 5;
+constexpr double kSettleContextSwitches = 10;
+
+struct ResourceCost {
+  double minutes = 0;
+  double wakeups = 0;
+  double cpu_ms = 0;
+  double context_switches = 0;
+};
+
+// The budgets are for optimised builds. Without optimisation the same work
+// costs around ten times the CPU, most of it spent in the standard library.
+#ifdef NDEBUG
+constexpr double kBuildCpuScale = 1;
+#else
+constexpr double kBuildCpuScale = 20;
+#endif
+
+// Real-time runs last AFT_BUDGET_SECONDS (default 3); CPU budgets are
+// multiplied by AFT_BUDGET_SCALE, e.g. for sanitizer builds, on top of
+// kBuildCpuScale.
+std::chrono::milliseconds RealPeriod() {
+  const char* seconds = std::getenv("AFT_BUDGET_SECONDS");
+  return std::chrono::milliseconds(static_cast<int64_t>((seconds ? std::atof(seconds) : 3) * 1000));
+}
+
+double CpuScale() {
+  const char* scale = std::getenv("AFT_BUDGET_SCALE");
+  return (scale ? std::atof(scale) : 1) * kBuildCpuScale;
+}
+
+// The schedule the plugin registers with.
+ScheduleOptions ProductionSchedule(Clock* clock) {
+  ScheduleOptions schedule;
+  schedule.min_interval = std::chrono::milliseconds(500);
+  schedule.max_interval = std::chrono::seconds(8);
+  schedule.align_to_wall_clock = true;
+  schedule.clock = clock;
+  return schedule;
+}
+
+// Focus never moves.
+class StableSource : public FocusSource {
+ public:
+  bool Sample(FocusSample* sample) override {
+    sample->window_id = 1;
+    sample->process_id = 7;
+    sample->app_name = "code";
+    sample->title = "main.cpp - project";
+    return true;
+  }
+};
+
+// Focus moves to the next of a few windows on every sample.
+class SwitchingSource : public FocusSource {
+ public:
+  bool Sample(FocusSample* sample) override {
+    uint64_t window = n_++ % 4;
+    sample->window_id = window;
+    sample->process_id = static_cast<uint32_t>(window);
+    sample->app_name = "app" + std::to_string(window);
+    sample->title = "title " + std::to_string(window);
+    return true;
+  }
+
+ private:
+  uint64_t n_ = 0;
+};
+
+// The user is away for the whole run.
+class AwayIdleSource : public IdleSource {
+ public:
+  bool IdleTime(int64_t* idle_us) override {
+    *idle_us = 3600LL * 1000000;
+    return true;
+  }
+};
+
+// Almost every sample lands on a window, app and title not seen before.
+std::unique_ptr<FocusSource> HighCardinalitySource() {
+  WorkloadProfile profile;
+  profile.name = "high_cardinality";
+  profile.apps = 5000;
+  profile.app_zipf = 0.5;
+  profile.windows_per_app = 50;
+  profile.stay_probability = 0;
+  profile.return_probability = 0;
+  profile.distinct_titles = 1000000;
+  profile.title_bytes = 120;
+  profile.unicode = true;
+  return std::make_unique<SyntheticFocusSource>(profile);
+}
+
+using SourceFactory = std::function<std::unique_ptr<FocusSource>()>;
+using IdleFactory = std::function<std::unique_ptr<IdleSource>()>;
+
+// Runs the sampler with the production schedule and a span subscriber that
+// encodes like the plugin does, measuring the process while |wait| runs.
+ResourceCost Measure(const SourceFactory& source, const IdleFactory& idle, Clock* clock,
+                     const std::function<double()>& wait) {
+  FocusSampler sampler(source(), ProductionSchedule(clock), idle ? idle() : nullptr);
+  SubscriptionOptions options;
+  options.granularity = Granularity::kSpans;
+  auto id = sampler.Subscribe(options, [](const FocusSpan* spans, size_t count) {
+    EncodeSpans(spans, count, Granularity::kSpans, kAllFields);
+  });
+
+  ProcessCpu before;
+  EXPECT_TRUE(QueryProcessCpu(&before));
+  uint64_t wakeups = TrackerMetrics::Get().value(Counter::kWakeups);
+  ResourceCost cost;
+  cost.minutes = wait();
+  ProcessCpu after;
+  EXPECT_TRUE(QueryProcessCpu(&after));
+  cost.wakeups = static_cast<double>(TrackerMetrics::Get().value(Counter::kWakeups) - wakeups);
+  cost.cpu_ms = static_cast<double>(after.cpu_ns - before.cpu_ns) / 1e6;
+  cost.context_switches = static_cast<double>(after.voluntary_switches + after.involuntary_switches -
+                                              before.voluntary_switches - before.involuntary_switches);
+  sampler.Unsubscribe(id);
+  return cost;
+}
+
+// An hour of simulated time, in which wakeups follow the schedule exactly
+// and CPU is the engine's own work. Simulated waits return at once without
+// blocking, so context switches are only checked in real time.
+ResourceCost MeasureVirtual(const SourceFactory& source, const IdleFactory& idle) {
+  VirtualClock clock(kStartUs);
+  return Measure(source, idle, &clock, [&clock] {
+    clock.RunFor(std::chrono::minutes(60));
+    return 60.0;
+  });
+}
+
+ResourceCost MeasureReal(const SourceFactory& source, const IdleFactory& idle) {
+  return Measure(source, idle, nullptr, [] {
+    auto started = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(RealPeriod());
+    return std::chrono::duration<double, std::ratio<60>>(std::chrono::steady_clock::now() - started).count();
+  });
+}
+
+void ExpectWithin(const char* name, const ResourceCost& cost, const ResourceBudget& budget, bool real) {
+  std::printf("%s (%s, %.2f min): %.0f wakeups, %.2f ms CPU, %.0f context switches\n", name,
+              real ? "real" : "virtual", cost.minutes, cost.wakeups, cost.cpu_ms, cost.context_switches);
+  EXPECT_LE(cost.wakeups, budget.wakeups_per_minute * cost.minutes + kSettleWakeups) << name;
+  EXPECT_LE(cost.cpu_ms, (budget.cpu_ms_per_minute * cost.minutes + kSettleCpuMs) * CpuScale()) << name;
+#if defined(__linux__)
+  if (real) {
+    EXPECT_LE(cost.context_switches,
+              budget.context_switches_per_minute * cost.minutes + kSettleContextSwitches) << name;
+  }
+#endif
+}
+
+void ExpectWithinBudget(const char* name, const SourceFactory& source, const IdleFactory& idle,
+                        const ResourceBudget& budget) {
+  ExpectWithin(name, MeasureVirtual(source, idle), budget, false);
+  ExpectWithin(name, MeasureReal(source, idle), budget, true);
+}
+
+}  // namespace
+
+TEST(ResourceBudget, IdleStable) {
+  // Sampling backs off to every 8s.
+  ResourceBudget budget;
+  budget.wakeups_per_minute = 8;
+  budget.cpu_ms_per_minute = 0.5;
+  budget.context_switches_per_minute = 20;
+  ExpectWithinBudget("idle_stable", [] { return std::make_unique<StableSource>(); }, nullptr, budget);
+}
+
+TEST(ResourceBudget, UserAway) {
+  // Only input is polled, every 5s.
+  ResourceBudget budget;
+  budget.wakeups_per_minute = 12;
+  budget.cpu_ms_per_minute = 0.5;
+  budget.context_switches_per_minute = 30;
+  ExpectWithinBudget("user_away", [] { return std::make_unique<StableSource>(); },
+                     [] { return std::make_unique<AwayIdleSource>(); }, budget);
+}
+
+TEST(ResourceBudget, BusySwitching) {
+  // Every sample finds a switch, so sampling stays at every 500ms.
+  ResourceBudget budget;
+  budget.wakeups_per_minute = 120;
+  budget.cpu_ms_per_minute = 2;
+  budget.context_switches_per_minute = 300;
+  ExpectWithinBudget("busy_switching", [] { return std::make_unique<SwitchingSource>(); }, nullptr, budget);
+}
+
+TEST(ResourceBudget, HighCardinality) {
+  ResourceBudget budget;
+  // As busy as switching gets, plus new strings to encode on every sample.
+  budget.wakeups_per_minute = 120;
+  budget.cpu_ms_per_minute = 5;
+  budget.context_switches_per_minute = 300;
+  ExpectWithinBudget("high_cardinality", HighCardinalitySource, nullptr, budget);
+}
+
+}  // namespace test
+}  // namespace app_focus_tracker
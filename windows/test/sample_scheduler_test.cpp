@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "focus_tracker.h"
+#include "sample_scheduler.h"
+
+namespace app_focus_tracker {
+namespace test {
+
+namespace {
+
+using std::chrono::milliseconds;
+using Clock = SampleScheduler::Clock;
+
+const std::chrono::system_clock::time_point kWallStart{std::chrono::seconds(1700000000)};
+
+class StableSource : public FocusSource {
+ public:
+  bool Sample(FocusSample* sample) override {
+    sample->window_id = 1;
+    sample->app_name = "app";
+    sample->title = "title";
+    return true;
+  }
+};
+
+}  // namespace
+
+TEST(SampleScheduler, DeadlinesDoNotDrift) {
+  SampleScheduler scheduler(ScheduleOptions::Fixed(milliseconds(100)));
+  Clock::time_point start{};
+  Clock::time_point deadline = scheduler.Next(true, start, kWallStart);
+  EXPECT_EQ(deadline, start + milliseconds(100));
+  for (int i = 2; i <= 50; ++i) {
+    // Each sample wakes a little late and takes a while.
+    Clock::time_point now = deadline + milliseconds(7);
+    deadline = scheduler.Next(false, now, kWallStart + (now - start));
+    EXPECT_EQ(deadline, start + milliseconds(100 * i));
+  }
+}
+
+TEST(SampleScheduler, SkipsMissedTicksAfterOverrun) {
+  SampleScheduler scheduler(ScheduleOptions::Fixed(milliseconds(100)));
+  Clock::time_point start{};
+  scheduler.Next(true, start, kWallStart);
+  Clock::time_point late = start + milliseconds(450);
+  EXPECT_EQ(scheduler.Next(false, late, kWallStart), late + milliseconds(100));
+}
+
+TEST(SampleScheduler, BacksOffWhileStableAndResetsOnChange) {
+  ScheduleOptions options;
+  options.min_interval = milliseconds(250);
+  options.max_interval = milliseconds(4000);
+  SampleScheduler scheduler(options);
+  Clock::time_point now{};
+
+  std::vector<int64_t> intervals;
+  for (int i = 0; i < 7; ++i) {
+    scheduler.Next(i == 0, now, kWallStart);
+    intervals.push_back(scheduler.interval().count());
+  }
+  EXPECT_EQ(intervals, (std::vector<int64_t>{250, 500, 1000, 2000, 4000, 4000, 4000}));
+
+  scheduler.Next(true, now, kWallStart);
+  EXPECT_EQ(scheduler.interval(), milliseconds(250));
+}
+
+TEST(SampleScheduler, AlignsToWallClockBoundaries) {
+  ScheduleOptions options = ScheduleOptions::Fixed(milliseconds(1000));
+  options.align_to_wall_clock = true;
+  SampleScheduler scheduler(options);
+  Clock::time_point now{};
+
+  // 300ms past a second: wake at the next full second.
+  EXPECT_EQ(scheduler.Next(true, now, kWallStart + milliseconds(300)), now + milliseconds(700));
+  // 900ms past: the next second is too close, so take the one after.
+  EXPECT_EQ(scheduler.Next(false, now, kWallStart + milliseconds(900)), now + milliseconds(1100));
+}
+
+TEST(FocusTracker, AdaptiveScheduleSlowsDownWhileFocusIsStable) {
+  ScheduleOptions options;
+  options.min_interval = milliseconds(2);
+  options.max_interval = milliseconds(64);
+  std::mutex mutex;
+  std::vector<int64_t> intervals;
+  FocusTracker tracker(std::make_unique<StableSource>(), [&](const FocusSample& sample) {
+    std::lock_guard<std::mutex> lock(mutex);
+    intervals.push_back(sample.interval_us);
+  }, options);
+  ASSERT_TRUE(tracker.Start());
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (std::chrono::steady_clock::now() < deadline) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (intervals.size() >= 8) break;
+    }
+    std::this_thread::sleep_for(milliseconds(1));
+  }
+  tracker.Stop();
+
+  ASSERT_GE(intervals.size(), 8u);
+  EXPECT_LE(intervals[0], 2000);
+  EXPECT_GT(intervals[7], 32000);
+  EXPECT_LE(intervals[7], 64000);
+}
+
+}  // namespace test
+}  // namespace app_focus_tracker
@@ -0,0 +1,54 @@
+#ifndef FLUTTER_PLUGIN_TEST_SCOPED_TEMP_DIR_H_
+#define FLUTTER_PLUGIN_TEST_SCOPED_TEMP_DIR_H_
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace app_focus_tracker {
+namespace test {
+
+// An empty directory of its own under the system temp directory, removed
+// again on destruction. The name carries the running test, the process id
+// and a counter, so tests running in parallel processes (ctest -j) never
+// share one.
+class ScopedTempDir {
+ public:
+  ScopedTempDir() {
+    static int counter = 0;
+    const auto* test = ::testing::UnitTest::GetInstance()->current_test_info();
+    std::string name = "aft_";
+    if (test) name += std::string(test->test_suite_name()) + "_" + test->name() + "_";
+#ifdef _WIN32
+    name += std::to_string(_getpid());
+#else
+    name += std::to_string(getpid());
+#endif
+    name += "_" + std::to_string(++counter);
+    path_ = (std::filesystem::temp_directory_path() / name).string();
+    std::filesystem::remove_all(path_);
+  }
+  ~ScopedTempDir() {
+    std::error_code ec;
+    std::filesystem::remove_all(path_, ec);
+  }
+  ScopedTempDir(const ScopedTempDir&) = delete;
+  ScopedTempDir& operator=(const ScopedTempDir&) = delete;
+
+  const std::string& path() const { return path_; }
+
+ private:
+  std::string path_;
+};
+
+}  // namespace test
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_TEST_SCOPED_TEMP_DIR_H_
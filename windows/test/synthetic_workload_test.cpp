@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "latency_histogram.h"
+#include "synthetic_workload.h"
+#include "text_encoding.h"
+
+namespace app_focus_tracker {
+namespace test {
+
+namespace {
+
+std::vector<FocusSample> Generate(const WorkloadProfile& profile, int count) {
+  SyntheticFocusSource source(profile);
+  std::vector<FocusSample> samples(count);
+  for (FocusSample& sample : samples) EXPECT_TRUE(source.Sample(&sample));
+  return samples;
+}
+
+// Checks that |text| is well-formed UTF-8 by round-tripping its code
+// points through UTF-16.
+bool IsUtf8(const std::string& text) {
+  std::u16string utf16;
+  for (size_t i = 0; i < text.size();) {
+    unsigned char lead = static_cast<unsigned char>(text[i]);
+    size_t length = lead < 0x80 ? 1 : lead >> 5 == 6 ? 2 : lead >> 4 == 14 ? 3 : lead >> 3 == 30 ? 4 : 0;
+    if (length == 0 || i + length > text.size()) return false;
+    uint32_t code = length == 1 ? lead : lead & (0x7F >> length);
+    for (size_t j = 1; j < length; ++j) {
+      unsigned char next = static_cast<unsigned char>(text[i + j]);
+      if (next >> 6 != 2) return false;
+      code = code << 6 | (next & 0x3F);
+    }
+    if (code >= 0x10000) {
+      utf16.push_back(static_cast<char16_t>(0xD800 + ((code - 0x10000) >> 10)));
+      utf16.push_back(static_cast<char16_t>(0xDC00 + (code & 0x3FF)));
+    } else {
+      utf16.push_back(static_cast<char16_t>(code));
+    }
+    i += length;
+  }
+  return Utf16ToUtf8(utf16.data(), utf16.size()) == text;
+}
+
+WorkloadProfile Profile(const std::string& name) {
+  WorkloadProfile profile;
+  EXPECT_TRUE(FindWorkloadProfile(name, &profile));
+  return profile;
+}
+
+}  // namespace
+
+TEST(SyntheticWorkload, SameSeedSameSamples) {
+  WorkloadProfile profile = Profile("typical");
+  std::vector<FocusSample> a = Generate(profile, 2000);
+  std::vector<FocusSample> b = Generate(profile, 2000);
+  profile.seed = 2;
+  std::vector<FocusSample> c = Generate(profile, 2000);
+  bool differs = false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    EXPECT_EQ(a[i].window_id, b[i].window_id);
+    EXPECT_EQ(a[i].title, b[i].title);
+    differs |= a[i].window_id != c[i].window_id;
+  }
+  EXPECT_TRUE(differs);
+}
+
+TEST(SyntheticWorkload, AppPopularityFollowsZipf) {
+  WorkloadProfile profile = Profile("switch_storm");
+  profile.return_probability = 0;
+  std::map<std::string, int> visits;
+  for (const FocusSample& sample : Generate(profile, 100000)) ++visits[sample.app_name];
+  double harmonic = 0;
+  for (int k = 1; k <= 200; ++k) harmonic += std::pow(k, -1.1);
+  EXPECT_NEAR(visits["app0.exe"] / 100000.0, 1 / harmonic, 0.02);
+  EXPECT_NEAR(static_cast<double>(visits["app1.exe"]) / visits["app0.exe"], std::pow(2, -1.1), 0.05);
+  EXPECT_GT(visits.size(), 150u);
+}
+
+TEST(SyntheticWorkload, StaysAndSwitchesAtTheConfiguredRate) {
+  WorkloadProfile profile = Profile("typical");
+  SyntheticFocusSource source(profile);
+  FocusSample sample;
+  for (int i = 0; i < 100000; ++i) source.Sample(&sample);
+  double rate = static_cast<double>(source.switches()) / source.samples();
+  EXPECT_NEAR(rate, 1 - profile.stay_probability, 0.005);
+}
+
+TEST(SyntheticWorkload, FlappingAlternatesTwoWindows) {
+  std::vector<FocusSample> samples = Generate(Profile("flapping"), 1000);
+  std::set<uint64_t> windows;
+  for (size_t i = 0; i < samples.size(); ++i) {
+    windows.insert(samples[i].window_id);
+    if (i > 0) ASSERT_NE(samples[i].window_id, samples[i - 1].window_id);
+  }
+  EXPECT_EQ(windows.size(), 2u);
+}
+
+TEST(SyntheticWorkload, TitlesHaveTheConfiguredShape) {
+  std::set<std::string> churned;
+  for (const FocusSample& sample : Generate(Profile("title_churn"), 20000)) churned.insert(sample.title);
+  EXPECT_GT(churned.size(), 15000u);
+
+  for (const FocusSample& sample : Generate(Profile("huge_titles"), 100)) {
+    EXPECT_EQ(sample.title.size(), 4096u);
+  }
+  for (const FocusSample& sample : Generate(Profile("unicode"), 200)) {
+    ASSERT_EQ(sample.title.size(), 512u);
+    ASSERT_TRUE(IsUtf8(sample.title)) << sample.title;
+  }
+}
+
+TEST(SyntheticWorkload, ReportsEveryProfile) {
+  for (const WorkloadProfile& profile : WorkloadProfiles()) {
+    WorkloadReport report = RunWorkload(profile, 2000);
+    EXPECT_EQ(report.profile, profile.name);
+    EXPECT_EQ(report.samples, 2000u);
+    EXPECT_EQ(report.encoded_events, 2000u);
+    EXPECT_GT(report.samples_per_second, 0);
+    EXPECT_GT(report.latency_p99_ns, 0);
+    EXPECT_GE(report.latency_max_ns, report.latency_p99_ns);
+    EXPECT_GE(report.latency_p99_ns, report.latency_p50_ns);
+    // Every switch closes a span, and so does every retitle.
+    EXPECT_GE(report.spans, report.switches);
+    if (profile.title_change_probability == 0) EXPECT_EQ(report.spans, report.switches);
+  }
+}
+
+TEST(LatencyHistogram, PercentilesWithinBucketResolution) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.Percentile(50), 0);
+  for (int64_t ns = 1; ns <= 100000; ++ns) histogram.Record(ns * 1000);
+  EXPECT_EQ(histogram.count(), 100000u);
+  EXPECT_EQ(histogram.max(), 100000000);
+  EXPECT_NEAR(histogram.Percentile(50), 50000000, 50000000 * 0.07);
+  EXPECT_NEAR(histogram.Percentile(99), 99000000, 99000000 * 0.07);
+  EXPECT_EQ(histogram.Percentile(100), 100000000);
+  EXPECT_NEAR(histogram.mean(), 50000500, 1);
+  histogram.Record(3);
+  EXPECT_EQ(histogram.Percentile(0), 3);
+  histogram.Reset();
+  EXPECT_EQ(histogram.count(), 0u);
+}
+
+}  // namespace test
+}  // namespace app_focus_tracker
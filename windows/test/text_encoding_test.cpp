@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "text_encoding.h"
+
+namespace app_focus_tracker {
+namespace test {
+
+namespace {
+
+std::string Convert(const std::u16string& text) {
+  return Utf16ToUtf8(text.data(), text.size());
+}
+
+}  // namespace
+
+TEST(TextEncoding, ConvertsEveryUtf8Length) {
+  EXPECT_EQ(Convert(u""), "");
+  EXPECT_EQ(Convert(u"Inbox - Outlook"), "Inbox - Outlook");
+  EXPECT_EQ(Convert(u"café"), "caf\xc3\xa9");
+  EXPECT_EQ(Convert(u"日本"), "\xe6\x97\xa5\xe6\x9c\xac");
+  EXPECT_EQ(Convert(u"\U0001F600"), "\xf0\x9f\x98\x80");
+}
+
+TEST(TextEncoding, ReplacesUnpairedSurrogates) {
+  EXPECT_EQ(Convert(std::u16string(1, u'\xd83d') + u"a"), "\xef\xbf\xbd" "a");
+  EXPECT_EQ(Convert(std::u16string(1, u'\xde00')), "\xef\xbf\xbd");
+}
+
+}  // namespace test
+}  // namespace app_focus_tracker
@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "thread_qos.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace app_focus_tracker {
+namespace test {
+
+TEST(ThreadQos, DefaultIsANoOp) {
+  bool applied = false;
+  std::thread([&] { applied = ApplyThreadQos(ThreadQos()); }).join();
+  EXPECT_TRUE(applied);
+}
+
+#if defined(__linux__)
+TEST(ThreadQos, IdlePriorityUsesSchedIdle) {
+  int policy = -1;
+  std::thread([&] {
+    ThreadQos qos;
+    qos.priority = ThreadPriority::kIdle;
+    ASSERT_TRUE(ApplyThreadQos(qos));
+    sched_param param;
+    pthread_getschedparam(pthread_self(), &policy, &param);
+  }).join();
+  EXPECT_EQ(policy, SCHED_IDLE);
+}
+
+TEST(ThreadQos, AffinityPinsTheThread) {
+  int cpu = -1;
+  std::thread([&] {
+    ThreadQos qos;
+    qos.affinity_mask = 1;
+    ASSERT_TRUE(ApplyThreadQos(qos));
+    cpu = sched_getcpu();
+  }).join();
+  EXPECT_EQ(cpu, 0);
+}
+#endif
+
+}  // namespace test
+}  // namespace app_focus_tracker
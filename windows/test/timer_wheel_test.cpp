@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "focus_budgets.h"
+#include "focus_sampler.h"
+#include "focus_types.h"
+#include "timer_wheel.h"
+
+namespace app_focus_tracker {
+namespace test {
+
+namespace {
+
+constexpr int64_t kMinute = 60 * kMicrosPerSecond;
+constexpr int64_t kHour = 60 * kMinute;
+// Some midnight UTC.
+constexpr int64_t kDay0 = 19700 * kMicrosPerDay;
+
+class NamedSource : public FocusSource {
+ public:
+  explicit NamedSource(std::string name) : name_(std::move(name)) {}
+  bool Sample(FocusSample* sample) override {
+    sample->window_id = 1;
+    sample->app_name = name_;
+    sample->title = "title";
+    return true;
+  }
+
+ private:
+  std::string name_;
+};
+
+}  // namespace
+
+TEST(TimerWheel, FiresEachTimerOnceAtItsTick) {
+  TimerWheel wheel(1000, 0);
+  std::mt19937_64 random(7);
+  std::vector<int64_t> due;
+  std::vector<int64_t> fired_at;
+  // Spread over every level and the overflow list.
+  for (int i = 0; i < 5000; ++i) {
+    int64_t when = static_cast<int64_t>(random() % (int64_t{1} << 26)) * 1000 + 1;
+    due.push_back(when);
+    wheel.Schedule(when, [&, when](TimerWheel::TimerId, int64_t due_us) {
+      EXPECT_EQ(due_us, when);
+      fired_at.push_back(when);
+    });
+  }
+  EXPECT_EQ(wheel.size(), 5000u);
+
+  int64_t now = 0;
+  while (wheel.size() > 0) {
+    int64_t next = wheel.NextDue();
+    ASSERT_GT(next, now);
+    // NextDue is a lower bound: nothing may fire before it.
+    size_t before = fired_at.size();
+    wheel.Advance(next - 1);
+    ASSERT_EQ(fired_at.size(), before);
+    now = next;
+    wheel.Advance(now);
+  }
+  std::sort(due.begin(), due.end());
+  EXPECT_EQ(fired_at, due);
+}
+
+TEST(TimerWheel, CancelAndPeriodic) {
+  TimerWheel wheel(10, 0);
+  int fired = 0;
+  int periodic = 0;
+  TimerWheel::TimerId cancelled = wheel.Schedule(100, [&](TimerWheel::TimerId, int64_t) { ++fired; });
+  TimerWheel::TimerId repeating = wheel.Schedule(50, [&](TimerWheel::TimerId, int64_t due_us) {
+    EXPECT_EQ(due_us, 50 + 100 * periodic);
+    ++periodic;
+  }, 100);
+  EXPECT_TRUE(wheel.Cancel(cancelled));
+  EXPECT_FALSE(wheel.Cancel(cancelled));
+
+  wheel.Advance(1000);
+  EXPECT_EQ(fired, 0);
+  EXPECT_EQ(periodic, 10);
+  EXPECT_TRUE(wheel.Cancel(repeating));
+  EXPECT_EQ(wheel.size(), 0u);
+
+  // A timer may cancel itself and schedule another from its callback.
+  TimerWheel::TimerId self = 0;
+  int chained = 0;
+  self = wheel.Schedule(1100, [&](TimerWheel::TimerId id, int64_t) {
+    EXPECT_TRUE(wheel.Cancel(id));
+    wheel.Schedule(1200, [&](TimerWheel::TimerId, int64_t) { ++chained; });
+  }, 10);
+  wheel.Advance(2000);
+  EXPECT_EQ(chained, 1);
+  EXPECT_FALSE(wheel.Cancel(self));
+  EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(FocusBudgets, AlertsExactlyWhenTheLimitIsCrossed) {
+  TimerWheel wheel(10000, kDay0);
+  FocusBudgets budgets(&wheel);
+  std::vector<BudgetAlert> alerts;
+  BudgetRule social;
+  social.apps = {"Twitter.exe", "discord.exe"};
+  social.limit_us = 2 * kHour;
+  uint64_t id = budgets.Add(social, [&](const BudgetAlert& alert) { alerts.push_back(alert); }, kDay0);
+
+  // 90 minutes of Twitter, an hour of work, then Discord.
+  budgets.Focus("twitter.exe", kDay0);
+  wheel.Advance(kDay0 + 90 * kMinute);
+  budgets.Focus("code.exe", kDay0 + 90 * kMinute);
+  EXPECT_EQ(budgets.used_us(id, kDay0 + 100 * kMinute), 90 * kMinute);
+  wheel.Advance(kDay0 + 150 * kMinute);
+  budgets.Focus("Discord.exe", kDay0 + 150 * kMinute);
+  wheel.Advance(kDay0 + 179 * kMinute);
+  EXPECT_TRUE(alerts.empty());
+  wheel.Advance(kDay0 + 181 * kMinute);
+
+  ASSERT_EQ(alerts.size(), 1u);
+  EXPECT_EQ(alerts[0].rule_id, id);
+  EXPECT_EQ(alerts[0].app_name, "Discord.exe");
+  EXPECT_EQ(alerts[0].at_us, kDay0 + 180 * kMinute);
+  EXPECT_EQ(alerts[0].used_us, 2 * kHour);
+
+  // One alert per day; the next day starts from zero.
+  wheel.Advance(kDay0 + 23 * kHour);
+  EXPECT_EQ(alerts.size(), 1u);
+  wheel.Advance(kDay0 + kMicrosPerDay + 2 * kHour + kMinute);
+  ASSERT_EQ(alerts.size(), 2u);
+  EXPECT_EQ(alerts[1].at_us, kDay0 + kMicrosPerDay + 2 * kHour);
+
+  EXPECT_TRUE(budgets.Remove(id));
+  EXPECT_FALSE(budgets.Remove(id));
+  EXPECT_EQ(wheel.size(), 1u);  // the day rollover
+}
+
+TEST(FocusBudgets, ManyRulesOnlyArmTheFocusedApp) {
+  TimerWheel wheel(10000, kDay0);
+  FocusBudgets budgets(&wheel);
+  int alerts = 0;
+  for (int i = 0; i < 5000; ++i) {
+    BudgetRule rule;
+    rule.apps = {"app" + std::to_string(i)};
+    rule.limit_us = kMinute + i;
+    budgets.Add(rule, [&](const BudgetAlert&) { ++alerts; }, kDay0);
+  }
+  EXPECT_EQ(wheel.size(), 1u);
+  budgets.Focus("app42", kDay0);
+  EXPECT_EQ(wheel.size(), 2u);
+  wheel.Advance(kDay0 + 2 * kMinute);
+  EXPECT_EQ(alerts, 1);
+}
+
+TEST(FocusBudgets, DaysFollowTheLocalTimeZone) {
+  TimerWheel wheel(10000, kDay0);
+  FocusBudgets budgets(&wheel, 2 * kHour);
+  std::vector<BudgetAlert> alerts;
+  BudgetRule rule;
+  rule.apps = {"game.exe"};
+  rule.limit_us = 3 * kHour;
+  uint64_t id = budgets.Add(rule, [&](const BudgetAlert& alert) { alerts.push_back(alert); }, kDay0);
+  budgets.Focus("game.exe", kDay0);
+  wheel.Advance(kDay0 + 21 * kHour + 30 * kMinute);
+  ASSERT_EQ(alerts.size(), 1u);
+
+  // Moving west puts midnight an hour later, so 22:00 UTC is still today.
+  budgets.SetUtcOffset(kHour, kDay0 + 21 * kHour + 30 * kMinute);
+  wheel.Advance(kDay0 + 22 * kHour + 30 * kMinute);
+  EXPECT_EQ(budgets.used_us(id, kDay0 + 22 * kHour + 30 * kMinute), 22 * kHour + 30 * kMinute);
+
+  // Moving east past local midnight starts the next day at once.
+  budgets.SetUtcOffset(3 * kHour, kDay0 + 22 * kHour + 30 * kMinute);
+  EXPECT_EQ(budgets.used_us(id, kDay0 + 22 * kHour + 30 * kMinute), 0);
+  wheel.Advance(kDay0 + 25 * kHour + 31 * kMinute);
+  ASSERT_EQ(alerts.size(), 2u);
+  EXPECT_EQ(alerts[1].at_us, kDay0 + 25 * kHour + 30 * kMinute);
+  // The next day starts at midnight UTC+3.
+  budgets.Focus(std::string(), kDay0 + 25 * kHour + 31 * kMinute);
+  int64_t midnight = kDay0 + 2 * kMicrosPerDay - 3 * kHour;
+  wheel.Advance(midnight - kMinute);
+  EXPECT_GT(budgets.used_us(id, midnight - kMinute), 0);
+  wheel.Advance(midnight + kMinute);
+  EXPECT_EQ(budgets.used_us(id, midnight + kMinute), 0);
+}
+
+TEST(FocusSampler, RaisesBudgetAlertsBetweenSamples) {
+  // Samples are an hour apart, so only the timer can wake the thread.
+  FocusSampler sampler(std::make_unique<NamedSource>("game.exe"), std::chrono::hours(1));
+  auto id = sampler.Subscribe(SubscriptionOptions(), nullptr);
+  CurrentFocus focus;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!sampler.current().Read(&focus) && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  std::atomic<int> alerts{0};
+  BudgetRule rule;
+  rule.apps = {"GAME.EXE"};
+  rule.limit_us = 50000;
+  auto started = std::chrono::steady_clock::now();
+  sampler.AddBudget(rule, [&](const BudgetAlert&) { ++alerts; });
+  while (alerts == 0 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(alerts, 1);
+  EXPECT_GE(std::chrono::steady_clock::now() - started, std::chrono::milliseconds(30));
+
+  std::atomic<int> ticks{0};
+  auto now_us = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  auto timer = sampler.AddTimer(now_us + 10000, 10000, [&](TimerWheel::TimerId, int64_t) { ++ticks; });
+  while (ticks < 3 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_GE(ticks, 3);
+  EXPECT_TRUE(sampler.CancelTimer(timer));
+  sampler.Unsubscribe(id);
+}
+
+}  // namespace test
+}  // namespace app_focus_tracker
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "focus_tracker.h"
+#include "title_fetcher.h"
+
+namespace app_focus_tracker {
+namespace test {
+
+namespace {
+
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+// Title lookups for windows listed in |hung| block until released.
+class SlowTitleSource : public FocusSource {
+ public:
+  bool Sample(FocusSample* sample) override {
+    sample->window_id = window.load();
+    sample->app_name = "app";
+    return true;
+  }
+  bool slow_titles() const override { return true; }
+  bool FetchTitle(const FocusSample& sample, std::string* title) override {
+    ++fetches;
+    std::unique_lock<std::mutex> lock(mutex);
+    released.wait(lock, [&] { return hung != sample.window_id; });
+    *title = "window " + std::to_string(sample.window_id) + " v" + std::to_string(version);
+    return true;
+  }
+
+  void Release() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      hung = 0;
+    }
+    released.notify_all();
+  }
+
+  std::atomic<uint64_t> window{1};
+  std::atomic<int> fetches{0};
+  std::mutex mutex;
+  std::condition_variable released;
+  uint64_t hung = 0;
+  int version = 1;
+};
+
+}  // namespace
+
+TEST(TitleFetcher, FallsBackToLastKnownTitleWhenLate) {
+  auto shared = std::make_shared<SlowTitleSource>();
+  SlowTitleSource& source = *shared;
+  TitleFetcher fetcher(shared, milliseconds(20));
+  FocusSample sample;
+  sample.window_id = 1;
+  EXPECT_EQ(fetcher.Fetch(sample), "window 1 v1");
+
+  {
+    std::lock_guard<std::mutex> lock(source.mutex);
+    source.hung = 1;
+    source.version = 2;
+  }
+  auto started = steady_clock::now();
+  EXPECT_EQ(fetcher.Fetch(sample), "window 1 v1");
+  EXPECT_LT(steady_clock::now() - started, milliseconds(500));
+  EXPECT_EQ(fetcher.timeouts(), 1u);
+
+  // The stuck lookup is not queued behind: another window answers from
+  // the (empty) cache immediately.
+  FocusSample other;
+  other.window_id = 2;
+  started = steady_clock::now();
+  EXPECT_EQ(fetcher.Fetch(other), "");
+  EXPECT_LT(steady_clock::now() - started, milliseconds(10));
+  EXPECT_EQ(source.fetches, 2);
+
+  // Once the window answers, its late title is used.
+  source.Release();
+  auto deadline = steady_clock::now() + std::chrono::seconds(5);
+  std::string title;
+  while ((title = fetcher.Fetch(sample)) != "window 1 v2" && steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(milliseconds(1));
+  }
+  EXPECT_EQ(title, "window 1 v2");
+}
+
+TEST(TitleFetcher, DestructionDoesNotWaitForAHungWindow) {
+  auto source = std::make_shared<SlowTitleSource>();
+  {
+    std::lock_guard<std::mutex> lock(source->mutex);
+    source->hung = 1;
+  }
+  auto started = steady_clock::now();
+  {
+    TitleFetcher fetcher(source, milliseconds(20));
+    FocusSample sample;
+    sample.window_id = 1;
+    EXPECT_EQ(fetcher.Fetch(sample), "");
+  }
+  EXPECT_LT(steady_clock::now() - started, milliseconds(500));
+
+  // The abandoned helper still holds the source, and lets go once the
+  // window answers.
+  EXPECT_GT(source.use_count(), 1);
+  source->Release();
+  auto deadline = steady_clock::now() + std::chrono::seconds(5);
+  while (source.use_count() > 1 && steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(milliseconds(1));
+  }
+  EXPECT_EQ(source.use_count(), 1);
+}
+
+TEST(FocusTracker, HungTitleDoesNotStallSampling) {
+  auto owned = std::make_unique<SlowTitleSource>();
+  SlowTitleSource* source = owned.get();
+  ScheduleOptions options = ScheduleOptions::Fixed(milliseconds(1));
+  options.title_timeout = milliseconds(5);
+  std::mutex mutex;
+  std::vector<std::string> titles;
+  FocusTracker tracker(std::move(owned), [&](const FocusSample& sample) {
+    std::lock_guard<std::mutex> lock(mutex);
+    titles.push_back(sample.title);
+  }, options);
+  {
+    std::lock_guard<std::mutex> lock(source->mutex);
+    source->hung = 1;
+  }
+  ASSERT_TRUE(tracker.Start());
+
+  auto deadline = steady_clock::now() + std::chrono::seconds(5);
+  while (steady_clock::now() < deadline) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (titles.size() >= 10) break;
+    }
+    std::this_thread::sleep_for(milliseconds(1));
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_GE(titles.size(), 10u);
+    EXPECT_EQ(titles[9], "");
+  }
+  EXPECT_EQ(source->fetches, 1);
+
+  source->Release();
+  deadline = steady_clock::now() + std::chrono::seconds(5);
+  bool recovered = false;
+  while (!recovered && steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(milliseconds(1));
+    std::lock_guard<std::mutex> lock(mutex);
+    recovered = titles.back() == "window 1 v1";
+  }
+  EXPECT_TRUE(recovered);
+  tracker.Stop();
+}
+
+}  // namespace test
+}  // namespace app_focus_tracker
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <cctype>
+#include <string>
+#include <vector>
+
+#include "focus_query.h"
+#include "focus_store.h"
+#include "scoped_temp_dir.h"
+#include "title_index.h"
+
+namespace app_focus_tracker {
+namespace test {
+
+namespace {
+
+std::vector<uint32_t> LinearSearch(const StringDictionary& titles, const std::string& needle) {
+  std::vector<uint32_t> matches;
+  for (uint32_t id = 0; id < titles.size(); ++id) {
+    std::string title = *titles.Lookup(id);
+    std::string folded_title, folded_needle;
+    for (char c : title) folded_title += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    for (char c : needle) folded_needle += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    if (folded_title.find(folded_needle) != std::string::npos) matches.push_back(id);
+  }
+  return matches;
+}
+
+}  // namespace
+
+TEST(TitleTrigramIndex, MatchesLinearScan) {
+  StringDictionary titles;
+  for (int i = 0; i < 20000; ++i) {
+    titles.Intern("JIRA-" + std::to_string(i) + " Fix crash in module " + std::to_string(i % 97) +
+                  " - Google Chrome");
+  }
+  titles.Intern("Résumé – draft.docx");
+
+  TitleTrigramIndex index;
+  index.Update(titles);
+  EXPECT_EQ(index.indexed_titles(), titles.size());
+
+  for (const std::string needle : {"JIRA-1234 ", "jira-1234", "module 42 ", "chrome", "résumé",
+                                   "no such title", "-1", "zz"}) {
+    EXPECT_EQ(index.Search(titles, needle), LinearSearch(titles, needle)) << needle;
+  }
+  EXPECT_EQ(index.Search(titles, "chrome", 5).size(), 5u);
+}
+
+TEST(TitleTrigramIndex, UpdateIndexesOnlyNewTitles) {
+  StringDictionary titles;
+  titles.Intern("Inbox - Mail");
+  TitleTrigramIndex index;
+  index.Update(titles);
+  EXPECT_TRUE(index.Search(titles, "JIRA-1234").empty());
+
+  titles.Intern("JIRA-1234: login broken");
+  index.Update(titles);
+  EXPECT_EQ(index.Search(titles, "jira-1234"), std::vector<uint32_t>{1});
+}
+
+TEST(TitleTrigramIndex, FindsSessionsThroughTitlePostings) {
+  ScopedTempDir dir;
+  FocusStore::Options options;
+  options.journal.segment_bytes = 8 * 1024;
+  FocusStore store;
+  ASSERT_TRUE(store.Open(dir.path(), options));
+  int64_t t = 0;
+  for (int i = 0; i < 3000; ++i, t += 60 * kMicrosPerSecond) {
+    std::string title = i % 500 == 7 ? "JIRA-1234 - Jira" : "Doc " + std::to_string(i % 300);
+    ASSERT_TRUE(store.Append("Browser", title, t, t + 30 * kMicrosPerSecond));
+  }
+  store.journal().Flush();
+
+  TitleTrigramIndex index;
+  index.Update(store.titles());
+  SessionQuery query;
+  query.filter_titles = true;
+  query.title_ids = index.Search(store.titles(), "jira-1234");
+  ASSERT_EQ(query.title_ids.size(), 1u);
+
+  FocusQueryEngine engine(dir.path());
+  QueryStats stats;
+  uint64_t sessions = 0;
+  ASSERT_TRUE(engine.Query(query, [&](const FocusSession&) { return ++sessions, true; }, &stats));
+  EXPECT_EQ(sessions, 6u);
+  EXPECT_EQ(stats.rows_read, 6u);
+  EXPECT_GT(stats.segments_skipped, 0u);
+
+  store.Close();
+}
+
+TEST(TitleTrigramIndex, StoreKeepsItsIndexForTitleSearches) {
+  ScopedTempDir dir;
+  FocusStore::Options options;
+  options.journal.segment_bytes = 8 * 1024;
+  options.snapshot_interval_bytes = 0;
+  int64_t t = 0;
+  {
+    FocusStore store;
+    ASSERT_TRUE(store.Open(dir.path(), options));
+    for (int i = 0; i < 1000; ++i, t += 60 * kMicrosPerSecond) {
+      std::string title = i % 100 == 3 ? "JIRA-1234 - Jira" : "Doc " + std::to_string(i % 300);
+      ASSERT_TRUE(store.Append("Browser", title, t, t + 30 * kMicrosPerSecond));
+    }
+  }
+
+  // Titles from the snapshot and from later appends are both searchable.
+  FocusStore store;
+  ASSERT_TRUE(store.Open(dir.path(), options));
+  EXPECT_EQ(store.title_index().indexed_titles(), store.titles().size());
+  ASSERT_TRUE(store.Append("Browser", "JIRA-1234 comments - Jira", t, t + 30 * kMicrosPerSecond));
+  EXPECT_EQ(store.title_index().indexed_titles(), store.titles().size());
+  store.journal().Flush();
+
+  SessionQuery query;
+  query.title_contains = "jira-1234";
+  FocusQueryEngine engine(dir.path());
+  EXPECT_FALSE(engine.Query(query, [](const FocusSession&) { return true; }));
+  engine.SetTitleIndex(&store.titles(), &store.title_index());
+  QueryStats stats;
+  uint64_t sessions = 0;
+  ASSERT_TRUE(engine.Query(query, [&](const FocusSession&) { return ++sessions, true; }, &stats));
+  EXPECT_EQ(sessions, 11u);
+  EXPECT_EQ(stats.rows_read, 11u);
+
+  // Combined with explicit ids, only titles in both count.
+  query.filter_titles = true;
+  query.title_ids = {store.titles().Find("JIRA-1234 comments - Jira"), store.titles().Find("Doc 0")};
+  sessions = 0;
+  ASSERT_TRUE(engine.Query(query, [&](const FocusSession&) { return ++sessions, true; }));
+  EXPECT_EQ(sessions, 1u);
+}
+
+}  // namespace test
+}  // namespace app_focus_tracker
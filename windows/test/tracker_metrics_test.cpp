@@ -0,0 +1,142 @@
+#include <flutter/encodable_value.h>
+#include <flutter/standard_method_codec.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "event_encoding.h"
+#include "focus_journal.h"
+#include "focus_sampler.h"
+#include "scoped_temp_dir.h"
+#include "tracker_metrics.h"
+#include "virtual_clock.h"
+
+namespace app_focus_tracker {
+namespace test {
+
+namespace {
+
+using flutter::EncodableList;
+using flutter::EncodableMap;
+using flutter::EncodableValue;
+
+// 2026-01-01T00:00:00Z.
+constexpr int64_t kStartUs = 1767225600LL * 1000000;
+
+// Focus moves to a new window every |period| samples.
+class CountingSource : public FocusSource {
+ public:
+  explicit CountingSource(int period) : period_(period) {}
+  bool Sample(FocusSample* sample) override {
+    int window = n_++ / period_;
+    sample->window_id = static_cast<uint64_t>(window);
+    sample->app_name = "app" + std::to_string(window % 2);
+    return true;
+  }
+
+ private:
+  int period_;
+  int n_ = 0;
+};
+
+// Counter values at construction, to compare against later.
+class Baseline {
+ public:
+  Baseline() {
+    for (size_t i = 0; i < kCounterCount; ++i) values_.push_back(Metrics().value(static_cast<Counter>(i)));
+  }
+  uint64_t Delta(Counter counter) const {
+    return Metrics().value(counter) - values_[static_cast<size_t>(counter)];
+  }
+
+ private:
+  static const TrackerMetrics& Metrics() { return TrackerMetrics::Get(); }
+  std::vector<uint64_t> values_;
+};
+
+}  // namespace
+
+TEST(TrackerMetrics, NamesAreDistinct) {
+  std::set<std::string> names;
+  for (size_t i = 0; i < kCounterCount; ++i) names.insert(TrackerMetrics::Name(static_cast<Counter>(i)));
+  for (size_t i = 0; i < kGaugeCount; ++i) names.insert(TrackerMetrics::Name(static_cast<Gauge>(i)));
+  for (size_t i = 0; i < kTimingCount; ++i) names.insert(TrackerMetrics::Name(static_cast<Timing>(i)));
+  EXPECT_EQ(names.size(), kCounterCount + kGaugeCount + kTimingCount);
+  EXPECT_EQ(names.count(""), 0u);
+
+  EncodableValue value = EncodeMetrics(TrackerMetrics::Get());
+  const auto& encoded = std::get<EncodableMap>(value);
+  EXPECT_EQ(encoded.size(), names.size());
+  EXPECT_TRUE(std::holds_alternative<EncodableMap>(encoded.at(EncodableValue("fsync"))));
+}
+
+TEST(TrackerMetrics, CountsSamplesWakeupsMergesAndDrops) {
+  Baseline baseline;
+  VirtualClock clock(kStartUs);
+  ScheduleOptions schedule = ScheduleOptions::Fixed(std::chrono::seconds(1));
+  schedule.clock = &clock;
+  FocusSampler sampler(std::make_unique<CountingSource>(10), schedule);
+  SubscriptionOptions options;
+  options.granularity = Granularity::kSpans;
+  options.filter.apps = {"app0"};
+  sampler.Subscribe(options, [](const FocusSpan*, size_t) {});
+  clock.RunFor(std::chrono::seconds(59));
+
+  // Sixty samples in six windows of ten; five spans closed, of which the
+  // two for app1 were filtered out.
+  EXPECT_EQ(baseline.Delta(Counter::kSamples), 60u);
+  EXPECT_GE(baseline.Delta(Counter::kWakeups), 60u);
+  EXPECT_EQ(baseline.Delta(Counter::kSamplesMerged), 54u);
+  EXPECT_EQ(baseline.Delta(Counter::kEventsDropped), 2u);
+}
+
+TEST(TrackerMetrics, CountsJournalBytesAndFsyncs) {
+  ScopedTempDir dir;
+  Baseline baseline;
+  uint64_t fsyncs_timed = TrackerMetrics::Get().timing(Timing::kFsync).count();
+  FocusJournal journal;
+  ASSERT_TRUE(journal.Open(dir.path(), FocusJournal::Options()));
+  uint64_t header_bytes = journal.bytes_appended();
+  JournalRecord record;
+  record.type = JournalRecordType::kAppName;
+  record.text = "code";
+  ASSERT_TRUE(journal.Append(record));
+  ASSERT_TRUE(journal.Sync());
+
+  EXPECT_EQ(baseline.Delta(Counter::kJournalBytes), journal.bytes_appended() - header_bytes);
+  EXPECT_GE(baseline.Delta(Counter::kFsyncs), 1u);
+  EXPECT_GE(TrackerMetrics::Get().timing(Timing::kFsync).count(), fsyncs_timed + 1);
+}
+
+TEST(TrackerMetrics, EncodedSizeMatchesTheCodec) {
+  EncodableList list{EncodableValue(int32_t{1}), EncodableValue(), EncodableValue(std::vector<uint8_t>{1, 2})};
+  EncodableMap map;
+  map[EncodableValue("appName")] = EncodableValue(std::string(300, 'a'));
+  map[EncodableValue("start")] = EncodableValue(int64_t{1767225600000});
+  map[EncodableValue("flag")] = EncodableValue(true);
+  map[EncodableValue("list")] = EncodableValue(list);
+  EncodableValue value(map);
+
+  auto envelope = flutter::StandardMethodCodec::GetInstance().EncodeSuccessEnvelope(&value);
+  EXPECT_EQ(EncodedSize(value) + 1, envelope->size());
+}
+
+TEST(TrackerMetrics, CountersAreSafeFromManyThreads) {
+  Baseline baseline;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([] {
+      for (int i = 0; i < 10000; ++i) TrackerMetrics::Get().Add(Counter::kOsCalls);
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  EXPECT_EQ(baseline.Delta(Counter::kOsCalls), 40000u);
+}
+
+}  // namespace test
+}  // namespace app_focus_tracker
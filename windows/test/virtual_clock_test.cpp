@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "focus_sampler.h"
+#include "focus_tracker.h"
+#include "virtual_clock.h"
+
+namespace app_focus_tracker {
+namespace test {
+
+namespace {
+
+using std::chrono::hours;
+using std::chrono::seconds;
+
+// 2026-01-01T00:00:00Z.
+constexpr int64_t kStartUs = 1767225600LL * 1000000;
+constexpr int64_t kSecondUs = 1000000;
+
+// Focus moves to a new window every |period| samples.
+class CountingSource : public FocusSource {
+ public:
+  explicit CountingSource(int period) : period_(period) {}
+  bool Sample(FocusSample* sample) override {
+    int window = n_++ / period_;
+    sample->window_id = static_cast<uint64_t>(window);
+    sample->app_name = "app" + std::to_string(window % 2);
+    return true;
+  }
+
+ private:
+  int period_;
+  int n_ = 0;
+};
+
+// Wakes every wait |delay| late, as a starved background thread does,
+// while wall and steady time move on together.
+class LateClock : public VirtualClock {
+ public:
+  LateClock(int64_t wall_start_us, seconds delay) : VirtualClock(wall_start_us), delay_(delay) {}
+  bool WaitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& cv, SteadyTime deadline,
+                 const std::function<bool()>& done) override {
+    return VirtualClock::WaitUntil(lock, cv, deadline + delay_, done);
+  }
+
+ private:
+  seconds delay_;
+};
+
+ScheduleOptions Every(seconds interval, VirtualClock* clock) {
+  ScheduleOptions schedule = ScheduleOptions::Fixed(interval);
+  schedule.clock = clock;
+  return schedule;
+}
+
+}  // namespace
+
+TEST(VirtualClock, TimeOnlyMovesWhenRun) {
+  VirtualClock clock(kStartUs);
+  EXPECT_EQ(clock.WallNowUs(), kStartUs);
+  clock.RunFor(seconds(90));
+  EXPECT_EQ(clock.WallNowUs(), kStartUs + 90 * kSecondUs);
+  EXPECT_EQ(clock.SteadyNow().time_since_epoch(), seconds(90));
+  clock.Suspend(hours(1));
+  EXPECT_EQ(clock.SteadyNow().time_since_epoch(), seconds(90));
+  EXPECT_EQ(clock.WallNowUs(), kStartUs + (3600 + 90) * kSecondUs);
+}
+
+TEST(VirtualClock, SimulatesADayOfSamplingExactly) {
+  VirtualClock clock(kStartUs);
+  FocusSampler sampler(std::make_unique<CountingSource>(60), Every(seconds(1), &clock));
+  std::vector<FocusSpan> spans;
+  SubscriptionOptions options;
+  options.granularity = Granularity::kSpans;
+  sampler.Subscribe(options, [&spans](const FocusSpan* span, size_t) { spans.push_back(*span); });
+
+  clock.RunFor(hours(24));
+  // Samples at every second from 0 to 86400 inclusive; a new window every
+  // minute closes one span per minute.
+  ASSERT_EQ(spans.size(), 1440u);
+  for (size_t i = 0; i < spans.size(); ++i) {
+    EXPECT_EQ(spans[i].start_us, kStartUs + static_cast<int64_t>(i) * 60 * kSecondUs);
+    EXPECT_EQ(spans[i].duration_us(), 60 * kSecondUs);
+  }
+  EXPECT_EQ(clock.WallNowUs(), kStartUs + 86400 * kSecondUs);
+}
+
+TEST(VirtualClock, BudgetsRaiseOneAlertPerDay) {
+  VirtualClock clock(kStartUs);
+  FocusSampler sampler(std::make_unique<CountingSource>(1 << 30), Every(seconds(10), &clock));
+  sampler.Subscribe(SubscriptionOptions(), nullptr);
+  std::vector<BudgetAlert> alerts;
+  BudgetRule rule;
+  rule.apps = {"app0"};
+  rule.limit_us = 3600 * kSecondUs;
+  sampler.AddBudget(rule, [&alerts](const BudgetAlert& alert) { alerts.push_back(alert); });
+
+  clock.RunFor(hours(72));
+  ASSERT_EQ(alerts.size(), 3u);
+  for (size_t day = 0; day < alerts.size(); ++day) {
+    EXPECT_EQ(alerts[day].at_us, kStartUs + (static_cast<int64_t>(day) * 24 + 1) * 3600 * kSecondUs);
+    EXPECT_EQ(alerts[day].used_us, rule.limit_us);
+  }
+}
+
+TEST(VirtualClock, ReportsSuspendStampedWhenSamplingStopped) {
+  VirtualClock clock(kStartUs);
+  std::vector<FocusSample> samples;
+  FocusTracker tracker(std::make_unique<CountingSource>(1 << 30),
+                       [&samples](const FocusSample& sample) { samples.push_back(sample); },
+                       Every(seconds(1), &clock));
+  tracker.Start();
+  clock.RunFor(seconds(10));
+  clock.Suspend(hours(1));
+  clock.RunFor(seconds(2));
+  tracker.Stop();
+
+  std::vector<FocusSample> suspended;
+  for (const FocusSample& sample : samples) {
+    if (sample.kind == SampleKind::kSuspended) suspended.push_back(sample);
+  }
+  ASSERT_EQ(suspended.size(), 1u);
+  EXPECT_EQ(suspended[0].timestamp_us, kStartUs + 10 * kSecondUs);
+}
+
+TEST(VirtualClock, LateWakeupIsNotASuspend) {
+  // Each wait ends 60s late, four times the suspend threshold.
+  LateClock clock(kStartUs, seconds(60));
+  std::vector<FocusSample> samples;
+  FocusTracker tracker(std::make_unique<CountingSource>(1 << 30),
+                       [&samples](const FocusSample& sample) { samples.push_back(sample); },
+                       Every(seconds(1), &clock));
+  tracker.Start();
+  clock.RunFor(seconds(600));
+  tracker.Stop();
+
+  ASSERT_GE(samples.size(), 9u);
+  for (const FocusSample& sample : samples) {
+    EXPECT_EQ(sample.kind, SampleKind::kFocus);
+  }
+}
+
+}  // namespace test
+}  // namespace app_focus_tracker
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "focus_tracker.h"
+#include "x11_idle_source.h"
+
+namespace app_focus_tracker {
+namespace test {
+
+namespace {
+
+// Points DISPLAY somewhere else for the lifetime of the object.
+class ScopedDisplay {
+ public:
+  explicit ScopedDisplay(const char* display) {
+    if (const char* previous = std::getenv("DISPLAY")) previous_ = previous;
+    if (display) {
+      setenv("DISPLAY", display, 1);
+    } else {
+      unsetenv("DISPLAY");
+    }
+  }
+  ~ScopedDisplay() {
+    if (previous_) {
+      setenv("DISPLAY", previous_->c_str(), 1);
+    } else {
+      unsetenv("DISPLAY");
+    }
+  }
+
+ private:
+  std::optional<std::string> previous_;
+};
+
+class CountingSource : public FocusSource {
+ public:
+  explicit CountingSource(std::atomic<int>* samples) : samples_(samples) {}
+  bool Sample(FocusSample* sample) override {
+    ++*samples_;
+    sample->window_id = 1;
+    sample->app_name = "app";
+    return true;
+  }
+
+ private:
+  std::atomic<int>* samples_;
+};
+
+}  // namespace
+
+TEST(X11IdleSource, WithoutADisplayReportsNothingAndTheUserCountsAsActive) {
+  ScopedDisplay display(nullptr);
+  auto idle = std::make_unique<X11IdleSource>();
+  EXPECT_FALSE(idle->available());
+  int64_t idle_us = -1;
+  EXPECT_FALSE(idle->IdleTime(&idle_us));
+  EXPECT_EQ(idle_us, -1);
+
+  // The tracker falls back to sampling as if input never stopped.
+  std::atomic<int> samples{0};
+  ScheduleOptions schedule = ScheduleOptions::Fixed(std::chrono::milliseconds(1));
+  schedule.idle_threshold = std::chrono::milliseconds(0);
+  int idle_samples = 0;
+  FocusTracker tracker(std::make_unique<CountingSource>(&samples),
+                       [&idle_samples](const FocusSample& sample) {
+                         if (sample.kind == SampleKind::kIdle) ++idle_samples;
+                       },
+                       schedule, std::move(idle));
+  tracker.Start();
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (samples < 5 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  tracker.Stop();
+  EXPECT_GE(samples.load(), 5);
+  EXPECT_EQ(idle_samples, 0);
+}
+
+TEST(X11IdleSource, ReadsTheIdleCounterWhenAServerIsReachable) {
+  X11IdleSource idle;
+  if (!idle.available()) {
+    GTEST_SKIP() << "no X server with the XScreenSaver extension";
+  }
+  int64_t idle_us = -1;
+  ASSERT_TRUE(idle.IdleTime(&idle_us));
+  EXPECT_GE(idle_us, 0);
+}
+
+}  // namespace test
+}  // namespace app_focus_tracker
@@ -0,0 +1,37 @@
+#include "text_encoding.h"
+
+#include <cstdint>
+
+namespace app_focus_tracker {
+
+std::string Utf16ToUtf8(const char16_t* text, size_t length) {
+    std::string result;
+    // Titles are mostly ASCII; grow only for the rest.
+    result.reserve(length);
+    for (size_t i = 0; i < length; ++i) {
+        uint32_t c = text[i];
+        if (c < 0x80) {
+            result.push_back(static_cast<char>(c));
+            continue;
+        }
+        if (c >= 0xd800 && c < 0xdc00 && i + 1 < length && text[i + 1] >= 0xdc00 && text[i + 1] < 0xe000) {
+            c = 0x10000 + ((c - 0xd800) << 10) + (text[++i] - 0xdc00);
+        } else if (c >= 0xd800 && c < 0xe000) {
+            c = 0xfffd;
+        }
+        if (c < 0x800) {
+            result.push_back(static_cast<char>(0xc0 | (c >> 6)));
+        } else if (c < 0x10000) {
+            result.push_back(static_cast<char>(0xe0 | (c >> 12)));
+            result.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3f)));
+        } else {
+            result.push_back(static_cast<char>(0xf0 | (c >> 18)));
+            result.push_back(static_cast<char>(0x80 | ((c >> 12) & 0x3f)));
+            result.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3f)));
+        }
+        result.push_back(static_cast<char>(0x80 | (c & 0x3f)));
+    }
+    return result;
+}
+
+}  // namespace app_focus_tracker
@@ -0,0 +1,15 @@
+#ifndef FLUTTER_PLUGIN_TEXT_ENCODING_H_
+#define FLUTTER_PLUGIN_TEXT_ENCODING_H_
+
+#include <cstddef>
+#include <string>
+
+namespace app_focus_tracker {
+
+// Converts UTF-16 (e.g. a Win32 window title) to UTF-8 in a single pass.
+// Unpaired surrogates become U+FFFD, as WideCharToMultiByte does.
+std::string Utf16ToUtf8(const char16_t* text, size_t length);
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_TEXT_ENCODING_H_
@@ -0,0 +1,79 @@
+#include "thread_qos.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace app_focus_tracker {
+
+#if defined(_WIN32)
+
+bool ApplyThreadQos(const ThreadQos& qos) {
+    HANDLE thread = GetCurrentThread();
+    bool ok = true;
+    switch (qos.priority) {
+        case ThreadPriority::kNormal:
+            break;
+        case ThreadPriority::kBackground:
+            ok &= SetThreadPriority(thread, THREAD_MODE_BACKGROUND_BEGIN) != FALSE;
+            break;
+        case ThreadPriority::kIdle:
+            ok &= SetThreadPriority(thread, THREAD_PRIORITY_IDLE) != FALSE;
+            break;
+    }
+    if (qos.eco_qos) {
+        THREAD_POWER_THROTTLING_STATE state = {};
+        state.Version = THREAD_POWER_THROTTLING_CURRENT_VERSION;
+        state.ControlMask = THREAD_POWER_THROTTLING_EXECUTION_SPEED;
+        state.StateMask = THREAD_POWER_THROTTLING_EXECUTION_SPEED;
+        ok &= SetThreadInformation(thread, ThreadPowerThrottling, &state, sizeof(state)) != FALSE;
+    }
+    if (qos.affinity_mask != 0) {
+        ok &= SetThreadAffinityMask(thread, static_cast<DWORD_PTR>(qos.affinity_mask)) != 0;
+    }
+    return ok;
+}
+
+#elif defined(__linux__)
+
+bool ApplyThreadQos(const ThreadQos& qos) {
+    bool ok = true;
+    switch (qos.priority) {
+        case ThreadPriority::kNormal:
+            break;
+        case ThreadPriority::kBackground:
+            // Linux applies nice values per thread.
+            ok &= setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10) == 0;
+            break;
+        case ThreadPriority::kIdle: {
+            sched_param param = {};
+            ok &= pthread_setschedparam(pthread_self(), SCHED_IDLE, &param) == 0;
+            break;
+        }
+    }
+    if (qos.affinity_mask != 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu = 0; cpu < 64; ++cpu) {
+            if (qos.affinity_mask & (uint64_t{1} << cpu)) CPU_SET(cpu, &set);
+        }
+        ok &= pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+    return ok;
+}
+
+#else
+
+bool ApplyThreadQos(const ThreadQos& qos) {
+    return qos.priority == ThreadPriority::kNormal && qos.affinity_mask == 0;
+}
+
+#endif
+
+}  // namespace app_focus_tracker
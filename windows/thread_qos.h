@@ -0,0 +1,33 @@
+#ifndef FLUTTER_PLUGIN_THREAD_QOS_H_
+#define FLUTTER_PLUGIN_THREAD_QOS_H_
+
+#include <cstdint>
+
+namespace app_focus_tracker {
+
+enum class ThreadPriority : uint8_t {
+    kNormal,
+    // Below normal: THREAD_MODE_BACKGROUND_BEGIN on Windows (which also
+    // lowers I/O and memory priority), nice 10 on Linux.
+    kBackground,
+    // Runs only when nothing else wants the CPU: THREAD_PRIORITY_IDLE on
+    // Windows, SCHED_IDLE on Linux.
+    kIdle,
+};
+
+struct ThreadQos {
+    ThreadPriority priority = ThreadPriority::kNormal;
+    // Windows 11 EcoQoS: lets the OS run the thread on efficiency cores at
+    // low clock speeds. Ignored elsewhere.
+    bool eco_qos = false;
+    // Bit n allows CPU n; zero leaves affinity alone.
+    uint64_t affinity_mask = 0;
+};
+
+// Applies |qos| to the calling thread. Returns false if any part of it
+// could not be applied; the rest still takes effect.
+bool ApplyThreadQos(const ThreadQos& qos);
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_THREAD_QOS_H_
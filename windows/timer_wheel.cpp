@@ -0,0 +1,193 @@
+#include "timer_wheel.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace app_focus_tracker {
+
+TimerWheel::TimerWheel(int64_t tick_us, int64_t start_us) : tick_us_(std::max<int64_t>(tick_us, 1)) {
+    tick_ = TickOf(start_us);
+    for (auto& level : heads_) {
+        std::fill(std::begin(level), std::end(level), kNil);
+    }
+}
+
+int64_t TimerWheel::TickOf(int64_t time_us) const {
+    // Round up so a timer never fires before its due time.
+    int64_t tick = time_us / tick_us_;
+    if (tick * tick_us_ < time_us) ++tick;
+    return tick;
+}
+
+int32_t& TimerWheel::Head(int level, int slot) {
+    return level == kOverflow ? overflow_ : heads_[level][slot];
+}
+
+int32_t TimerWheel::Head(int level, int slot) const {
+    return level == kOverflow ? overflow_ : heads_[level][slot];
+}
+
+TimerWheel::TimerId TimerWheel::Schedule(int64_t due_us, Callback callback, int64_t period_us) {
+    int32_t index;
+    if (!free_.empty()) {
+        index = free_.back();
+        free_.pop_back();
+    } else {
+        index = static_cast<int32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+    Node& node = nodes_[index];
+    node.due_us = due_us;
+    node.due_tick = std::max(TickOf(due_us), tick_ + 1);
+    node.period_us = period_us;
+    node.callback = std::move(callback);
+    node.live = true;
+    node.firing = false;
+    node.cancelled = false;
+    ++size_;
+    Place(index);
+    return (static_cast<TimerId>(node.generation) << 32) | static_cast<uint32_t>(index + 1);
+}
+
+bool TimerWheel::Cancel(TimerId id) {
+    int64_t index = static_cast<int64_t>(id & 0xffffffffu) - 1;
+    if (index < 0 || index >= static_cast<int64_t>(nodes_.size())) return false;
+    Node& node = nodes_[index];
+    if (!node.live || node.cancelled || node.generation != static_cast<uint32_t>(id >> 32)) return false;
+    if (node.firing) {
+        // Fire() frees it once the callback returns.
+        node.cancelled = true;
+        return true;
+    }
+    Unlink(static_cast<int32_t>(index));
+    Free(static_cast<int32_t>(index));
+    return true;
+}
+
+void TimerWheel::Place(int32_t index) {
+    Node& node = nodes_[index];
+    int64_t delta = node.due_tick - tick_;
+    for (int level = 0; level < kLevels; ++level) {
+        if (delta < (int64_t{1} << (kSlotBits * (level + 1)))) {
+            Link(index, level, static_cast<int>((node.due_tick >> (kSlotBits * level)) & (kSlots - 1)));
+            return;
+        }
+    }
+    Link(index, kOverflow, 0);
+}
+
+void TimerWheel::Link(int32_t index, int level, int slot) {
+    Node& node = nodes_[index];
+    int32_t& head = Head(level, slot);
+    node.level = static_cast<int16_t>(level);
+    node.slot = static_cast<int16_t>(slot);
+    node.prev = kNil;
+    node.next = head;
+    if (head != kNil) nodes_[head].prev = index;
+    head = index;
+}
+
+void TimerWheel::Unlink(int32_t index) {
+    Node& node = nodes_[index];
+    if (node.level == kNil) return;
+    if (node.prev != kNil) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        Head(node.level, node.slot) = node.next;
+    }
+    if (node.next != kNil) nodes_[node.next].prev = node.prev;
+    node.prev = node.next = kNil;
+    node.level = kNil;
+}
+
+void TimerWheel::Free(int32_t index) {
+    Node& node = nodes_[index];
+    node.callback = nullptr;
+    node.live = false;
+    ++node.generation;
+    free_.push_back(index);
+    --size_;
+}
+
+void TimerWheel::Cascade(int level) {
+    int32_t& head = Head(level, level == kOverflow ? 0 : static_cast<int>((tick_ >> (kSlotBits * level)) & (kSlots - 1)));
+    int32_t index = head;
+    head = kNil;
+    while (index != kNil) {
+        int32_t next = nodes_[index].next;
+        nodes_[index].level = kNil;
+        Place(index);
+        index = next;
+    }
+}
+
+void TimerWheel::Fire(int32_t index) {
+    Node& node = nodes_[index];
+    TimerId id = (static_cast<TimerId>(node.generation) << 32) | static_cast<uint32_t>(index + 1);
+    Callback callback = std::move(node.callback);
+    node.firing = true;
+    callback(id, node.due_us);
+    // |nodes_| is a deque, so |node| survives timers scheduled meanwhile.
+    node.firing = false;
+    if (node.cancelled || node.period_us <= 0) {
+        Free(index);
+        return;
+    }
+    node.callback = std::move(callback);
+    node.due_us += node.period_us;
+    node.due_tick = std::max(TickOf(node.due_us), tick_ + 1);
+    Place(index);
+}
+
+size_t TimerWheel::Advance(int64_t now_us) {
+    int64_t target = now_us / tick_us_;
+    size_t fired = 0;
+    while (tick_ < target) {
+        if (size_ == 0) {
+            tick_ = target;
+            break;
+        }
+        ++tick_;
+        // Refill lower levels from the top down whenever a level wraps.
+        int wrapped = 0;
+        while (wrapped < kLevels - 1 && ((tick_ >> (kSlotBits * (wrapped + 1))) << (kSlotBits * (wrapped + 1))) == tick_) {
+            ++wrapped;
+        }
+        if (wrapped == kLevels - 1) Cascade(kOverflow);
+        for (int level = wrapped; level >= 1; --level) {
+            Cascade(level);
+        }
+        int32_t& head = heads_[0][tick_ & (kSlots - 1)];
+        while (head != kNil) {
+            int32_t index = head;
+            Unlink(index);
+            Fire(index);
+            ++fired;
+        }
+    }
+    return fired;
+}
+
+int64_t TimerWheel::NextDue() const {
+    if (size_ == 0) return std::numeric_limits<int64_t>::max();
+    int64_t best = std::numeric_limits<int64_t>::max();
+    for (int level = 0; level < kLevels; ++level) {
+        int shift = kSlotBits * level;
+        int64_t block = tick_ >> shift;
+        for (int k = 1; k <= kSlots; ++k) {
+            if (heads_[level][(block + k) & (kSlots - 1)] != kNil) {
+                // The slot holds nothing due before its block starts.
+                best = std::min(best, ((block + k) << shift) * tick_us_);
+                break;
+            }
+        }
+    }
+    if (overflow_ != kNil) {
+        int shift = kSlotBits * (kLevels - 1);
+        best = std::min(best, (((tick_ >> shift) + 1) << shift) * tick_us_);
+    }
+    return best;
+}
+
+}  // namespace app_focus_tracker
@@ -0,0 +1,90 @@
+#ifndef FLUTTER_PLUGIN_TIMER_WHEEL_H_
+#define FLUTTER_PLUGIN_TIMER_WHEEL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace app_focus_tracker {
+
+// Hierarchical timing wheel: four levels of 64 slots, each level covering
+// 64 times the span of the one below, plus an overflow list for timers
+// further out. Scheduling and cancelling are O(1), and advancing costs O(1)
+// per tick plus the timers that fire. Not thread-safe; the owner advances
+// it from one thread.
+class TimerWheel {
+public:
+    using TimerId = uint64_t;
+    // Receives the time the timer was due, which may be earlier than the
+    // time Advance() was called with.
+    using Callback = std::function<void(TimerId id, int64_t due_us)>;
+
+    static constexpr TimerId kInvalidTimer = 0;
+
+    explicit TimerWheel(int64_t tick_us = 10000, int64_t start_us = 0);
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // Runs |callback| once the wheel is advanced past |due_us|, then every
+    // |period_us| after that if it is positive. Times in the past fire on
+    // the next Advance().
+    TimerId Schedule(int64_t due_us, Callback callback, int64_t period_us = 0);
+    // Returns false if |id| already fired (and is not periodic) or was
+    // cancelled. Safe to call from a callback, including on itself.
+    bool Cancel(TimerId id);
+    // Fires every timer due at or before |now_us|. Returns how many fired.
+    size_t Advance(int64_t now_us);
+
+    // A lower bound on the next due time, exact to the tick for timers less
+    // than 64 ticks out; INT64_MAX when nothing is scheduled.
+    int64_t NextDue() const;
+    size_t size() const { return size_; }
+    int64_t tick_us() const { return tick_us_; }
+
+private:
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 6;
+    static constexpr int kSlots = 1 << kSlotBits;
+    static constexpr int kOverflow = kLevels;
+    static constexpr int32_t kNil = -1;
+
+    struct Node {
+        int64_t due_us = 0;
+        int64_t due_tick = 0;
+        int64_t period_us = 0;
+        Callback callback;
+        uint32_t generation = 0;
+        int32_t prev = kNil;
+        int32_t next = kNil;
+        int16_t level = kNil;
+        int16_t slot = 0;
+        bool live = false;
+        bool firing = false;
+        bool cancelled = false;
+    };
+
+    int64_t TickOf(int64_t time_us) const;
+    void Place(int32_t index);
+    void Link(int32_t index, int level, int slot);
+    void Unlink(int32_t index);
+    void Free(int32_t index);
+    void Cascade(int level);
+    void Fire(int32_t index);
+    int32_t& Head(int level, int slot);
+    int32_t Head(int level, int slot) const;
+
+    int64_t tick_us_;
+    // Every timer due at or before this tick has fired.
+    int64_t tick_;
+    size_t size_ = 0;
+    std::deque<Node> nodes_;
+    std::vector<int32_t> free_;
+    int32_t heads_[kLevels][kSlots];
+    int32_t overflow_ = kNil;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_TIMER_WHEEL_H_
@@ -0,0 +1,95 @@
+#include "title_fetcher.h"
+
+#include <utility>
+
+#include "pipeline_tracing.h"
+#include "tracker_metrics.h"
+
+namespace app_focus_tracker {
+
+TitleFetcher::TitleFetcher(std::shared_ptr<FocusSource> source, std::chrono::milliseconds timeout,
+                           const ThreadQos& qos)
+    : timeout_(timeout), state_(std::make_shared<State>()) {
+    state_->source = std::move(source);
+    thread_ = std::thread(&TitleFetcher::Run, state_, qos);
+}
+
+TitleFetcher::~TitleFetcher() {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->stop = true;
+    state_->cv.notify_all();
+    // Joining a helper stuck on a hung window would hang shutdown with it.
+    bool exited = state_->cv.wait_for(lock, timeout_, [this] { return state_->exited; });
+    lock.unlock();
+    if (exited) {
+        thread_.join();
+    } else {
+        thread_.detach();
+    }
+}
+
+std::string TitleFetcher::Fetch(const FocusSample& sample) {
+    TrackerMetrics& metrics = TrackerMetrics::Get();
+    metrics.Add(Counter::kTitleFetches);
+    ScopedTiming timing(Timing::kTitleFetch);
+    TracingScope tracing("awaitTitle");
+    State& state = *state_;
+    std::unique_lock<std::mutex> lock(state.mutex);
+    if (state.completed != state.requested) {
+        ++state.timeouts;
+        metrics.Add(Counter::kTitleTimeouts);
+        return Cached(state, sample.window_id);
+    }
+    state.request = sample;
+    uint64_t ticket = ++state.requested;
+    state.cv.notify_all();
+    if (!state.cv.wait_for(lock, timeout_, [&] { return state.completed >= ticket; })) {
+        ++state.timeouts;
+        metrics.Add(Counter::kTitleTimeouts);
+    }
+    return Cached(state, sample.window_id);
+}
+
+uint64_t TitleFetcher::timeouts() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->timeouts;
+}
+
+std::string TitleFetcher::Cached(const State& state, uint64_t window_id) {
+    auto it = state.cache.find(window_id);
+    return it == state.cache.end() ? std::string() : it->second;
+}
+
+void TitleFetcher::Run(std::shared_ptr<State> state, ThreadQos qos) {
+    ApplyThreadQos(qos);
+    PipelineTracing::SetThreadName("title fetcher");
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (true) {
+        state->cv.wait(lock, [&] { return state->stop || state->requested != state->completed; });
+        if (state->requested == state->completed) break;
+        FocusSample request = state->request;
+        uint64_t ticket = state->requested;
+
+        lock.unlock();
+        std::string title;
+        bool ok;
+        {
+            TracingScope tracing("fetchTitle");
+            ok = state->source->FetchTitle(request, &title);
+        }
+        lock.lock();
+
+        if (ok) {
+            if (state->cache.size() >= kMaxCachedWindows && !state->cache.count(request.window_id)) {
+                state->cache.clear();
+            }
+            state->cache[request.window_id] = std::move(title);
+        }
+        state->completed = ticket;
+        state->cv.notify_all();
+    }
+    state->exited = true;
+    state->cv.notify_all();
+}
+
+}  // namespace app_focus_tracker
@@ -0,0 +1,67 @@
+#ifndef FLUTTER_PLUGIN_TITLE_FETCHER_H_
+#define FLUTTER_PLUGIN_TITLE_FETCHER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "focus_source.h"
+#include "thread_qos.h"
+
+namespace app_focus_tracker {
+
+// Runs FocusSource::FetchTitle() on a helper thread so a window that does
+// not answer cannot stall sampling. A lookup that misses its deadline falls
+// back to the last title seen for that window; its result still lands in
+// the cache once it arrives. While a lookup is stuck, later calls do not
+// queue behind it and answer from the cache straight away.
+class TitleFetcher {
+public:
+    TitleFetcher(std::shared_ptr<FocusSource> source, std::chrono::milliseconds timeout,
+                 const ThreadQos& qos = ThreadQos());
+    // Waits up to |timeout| for a lookup still in progress. A helper stuck
+    // past that is detached and exits once the window answers; it keeps the
+    // source alive until then.
+    ~TitleFetcher();
+    TitleFetcher(const TitleFetcher&) = delete;
+    TitleFetcher& operator=(const TitleFetcher&) = delete;
+
+    std::string Fetch(const FocusSample& sample);
+
+    // Lookups answered from the cache because they were late or blocked.
+    uint64_t timeouts() const;
+
+private:
+    static constexpr size_t kMaxCachedWindows = 1024;
+
+    // Everything the helper touches, shared so it may outlive the fetcher.
+    struct State {
+        std::shared_ptr<FocusSource> source;
+        std::mutex mutex;
+        std::condition_variable cv;
+        FocusSample request;
+        uint64_t requested = 0;
+        uint64_t completed = 0;
+        bool stop = false;
+        bool exited = false;
+        uint64_t timeouts = 0;
+        std::unordered_map<uint64_t, std::string> cache;
+    };
+
+    static void Run(std::shared_ptr<State> state, ThreadQos qos);
+    static std::string Cached(const State& state, uint64_t window_id);
+
+    std::chrono::milliseconds timeout_;
+    std::shared_ptr<State> state_;
+    std::thread thread_;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_TITLE_FETCHER_H_
@@ -0,0 +1,83 @@
+#include "title_index.h"
+
+#include <algorithm>
+
+namespace app_focus_tracker {
+
+namespace {
+
+inline uint8_t Fold(char c) {
+    uint8_t byte = static_cast<uint8_t>(c);
+    return byte >= 'A' && byte <= 'Z' ? byte + ('a' - 'A') : byte;
+}
+
+inline uint32_t Trigram(const std::string& text, size_t i) {
+    return (static_cast<uint32_t>(Fold(text[i])) << 16) |
+           (static_cast<uint32_t>(Fold(text[i + 1])) << 8) | Fold(text[i + 2]);
+}
+
+bool ContainsFolded(const std::string& haystack, const std::string& needle) {
+    return std::search(haystack.begin(), haystack.end(), needle.begin(), needle.end(),
+                       [](char a, char b) { return Fold(a) == Fold(b); }) != haystack.end();
+}
+
+}  // namespace
+
+void TitleTrigramIndex::Update(const StringDictionary& titles) {
+    for (; indexed_ < titles.size(); ++indexed_) {
+        const std::string& title = *titles.Lookup(indexed_);
+        for (size_t i = 0; i + 3 <= title.size(); ++i) {
+            std::vector<uint32_t>& posting = postings_[Trigram(title, i)];
+            // Ids arrive in ascending order, so a repeat is always at the back.
+            if (posting.empty() || posting.back() != indexed_) {
+                posting.push_back(indexed_);
+            }
+        }
+    }
+}
+
+std::vector<uint32_t> TitleTrigramIndex::Search(const StringDictionary& titles,
+                                                const std::string& needle, size_t limit) const {
+    std::vector<uint32_t> matches;
+    if (limit == 0) return matches;
+
+    if (needle.size() < 3) {
+        for (uint32_t id = 0; id < indexed_ && matches.size() < limit; ++id) {
+            if (ContainsFolded(*titles.Lookup(id), needle)) matches.push_back(id);
+        }
+        return matches;
+    }
+
+    std::vector<const std::vector<uint32_t>*> lists;
+    for (size_t i = 0; i + 3 <= needle.size(); ++i) {
+        auto it = postings_.find(Trigram(needle, i));
+        if (it == postings_.end()) return matches;
+        lists.push_back(&it->second);
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b) {
+                  return a->size() != b->size() ? a->size() < b->size() : a < b;
+              });
+    lists.erase(std::unique(lists.begin(), lists.end()), lists.end());
+
+    // Walk the shortest list and probe the others; every survivor is then
+    // verified, since sharing all trigrams does not imply a substring match.
+    for (uint32_t id : *lists.front()) {
+        bool in_all = true;
+        for (size_t i = 1; in_all && i < lists.size(); ++i) {
+            in_all = std::binary_search(lists[i]->begin(), lists[i]->end(), id);
+        }
+        if (in_all && ContainsFolded(*titles.Lookup(id), needle)) {
+            matches.push_back(id);
+            if (matches.size() >= limit) break;
+        }
+    }
+    return matches;
+}
+
+void TitleTrigramIndex::Clear() {
+    postings_.clear();
+    indexed_ = 0;
+}
+
+}  // namespace app_focus_tracker
@@ -0,0 +1,41 @@
+#ifndef FLUTTER_PLUGIN_TITLE_INDEX_H_
+#define FLUTTER_PLUGIN_TITLE_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "string_dictionary.h"
+
+namespace app_focus_tracker {
+
+// Trigram index over the interned window titles. Each posting list holds
+// the ascending ids of the titles containing a trigram, so a substring
+// search intersects a few lists and only verifies the survivors instead of
+// scanning every stored title. Matching folds ASCII case; other bytes,
+// including UTF-8 sequences, must match exactly.
+class TitleTrigramIndex {
+public:
+    // Indexes the titles added to |titles| since the previous call.
+    void Update(const StringDictionary& titles);
+
+    // Ids of titles containing |needle|, ascending, at most |limit| of them.
+    // Needles shorter than a trigram fall back to a linear scan.
+    std::vector<uint32_t> Search(const StringDictionary& titles, const std::string& needle,
+                                 size_t limit = std::numeric_limits<size_t>::max()) const;
+
+    size_t indexed_titles() const { return indexed_; }
+    size_t trigram_count() const { return postings_.size(); }
+    void Clear();
+
+private:
+    std::unordered_map<uint32_t, std::vector<uint32_t>> postings_;
+    uint32_t indexed_ = 0;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_TITLE_INDEX_H_
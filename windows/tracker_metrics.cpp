@@ -0,0 +1,64 @@
+#include "tracker_metrics.h"
+
+#include "clock.h"
+
+namespace app_focus_tracker {
+
+TrackerMetrics& TrackerMetrics::Get() {
+    static TrackerMetrics metrics;
+    return metrics;
+}
+
+const char* TrackerMetrics::Name(Counter counter) {
+    switch (counter) {
+        case Counter::kSamples:
+            return "samples";
+        case Counter::kOsCalls:
+            return "osCalls";
+        case Counter::kTitleFetches:
+            return "titleFetches";
+        case Counter::kTitleTimeouts:
+            return "titleTimeouts";
+        case Counter::kSamplesMerged:
+            return "samplesMerged";
+        case Counter::kEventsEmitted:
+            return "eventsEmitted";
+        case Counter::kEventBytes:
+            return "eventBytes";
+        case Counter::kEventsDropped:
+            return "eventsDropped";
+        case Counter::kJournalBytes:
+            return "journalBytes";
+        case Counter::kFsyncs:
+            return "fsyncs";
+        case Counter::kWakeups:
+            return "wakeups";
+    }
+    return "";
+}
+
+const char* TrackerMetrics::Name(Gauge gauge) {
+    switch (gauge) {
+        case Gauge::kQueueDepth:
+            return "queueDepth";
+    }
+    return "";
+}
+
+const char* TrackerMetrics::Name(Timing timing) {
+    switch (timing) {
+        case Timing::kTitleFetch:
+            return "titleFetch";
+        case Timing::kFsync:
+            return "fsync";
+    }
+    return "";
+}
+
+ScopedTiming::ScopedTiming(Timing timing) : timing_(timing), start_ns_(MonotonicNowNs()) {}
+
+ScopedTiming::~ScopedTiming() {
+    TrackerMetrics::Get().Record(timing_, MonotonicNowNs() - start_ns_);
+}
+
+}  // namespace app_focus_tracker
@@ -0,0 +1,110 @@
+#ifndef FLUTTER_PLUGIN_TRACKER_METRICS_H_
+#define FLUTTER_PLUGIN_TRACKER_METRICS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "latency_histogram.h"
+
+namespace app_focus_tracker {
+
+// Monotonic counts since the process started.
+enum class Counter : uint8_t {
+    // FocusSource::Sample() calls.
+    kSamples,
+    // Calls into the OS for focus, titles and idle time.
+    kOsCalls,
+    kTitleFetches,
+    // Title lookups that missed their deadline or found the helper busy.
+    kTitleTimeouts,
+    // Samples that extended the open span instead of starting a new one.
+    kSamplesMerged,
+    // Events sent on the event channel, and their encoded size.
+    kEventsEmitted,
+    kEventBytes,
+    // Spans a subscriber's filter rejected, events that were stale by the
+    // time the platform thread got to them, and tasks that could not be
+    // handed to the platform thread at all.
+    kEventsDropped,
+    kJournalBytes,
+    kFsyncs,
+    // Times the sampling thread woke up.
+    kWakeups,
+};
+constexpr size_t kCounterCount = 11;
+
+// Values that go up and down.
+enum class Gauge : uint8_t {
+    // Events encoded but not yet picked up by the platform thread.
+    kQueueDepth,
+};
+constexpr size_t kGaugeCount = 1;
+
+// Durations, in nanoseconds.
+enum class Timing : uint8_t {
+    kTitleFetch,
+    kFsync,
+};
+constexpr size_t kTimingCount = 2;
+
+// Process-wide operational metrics. Updating one is a relaxed atomic add
+// on its own cache line (timings: a few), so the sampling path can count
+// freely; readers get values that are each current but not a consistent
+// snapshot of all of them.
+class TrackerMetrics {
+public:
+    static TrackerMetrics& Get();
+
+    void Add(Counter counter, uint64_t n = 1) {
+        counters_[static_cast<size_t>(counter)].value.fetch_add(n, std::memory_order_relaxed);
+    }
+    void Adjust(Gauge gauge, int64_t delta) {
+        gauges_[static_cast<size_t>(gauge)].value.fetch_add(delta, std::memory_order_relaxed);
+    }
+    void Record(Timing timing, int64_t ns) { timings_[static_cast<size_t>(timing)].Record(ns); }
+
+    uint64_t value(Counter counter) const {
+        return counters_[static_cast<size_t>(counter)].value.load(std::memory_order_relaxed);
+    }
+    int64_t value(Gauge gauge) const {
+        return gauges_[static_cast<size_t>(gauge)].value.load(std::memory_order_relaxed);
+    }
+    const LatencyHistogram& timing(Timing timing) const { return timings_[static_cast<size_t>(timing)]; }
+
+    // Names as getMetrics reports them, e.g. "eventsEmitted".
+    static const char* Name(Counter counter);
+    static const char* Name(Gauge gauge);
+    static const char* Name(Timing timing);
+
+private:
+    struct alignas(64) CounterSlot {
+        std::atomic<uint64_t> value{0};
+    };
+    struct alignas(64) GaugeSlot {
+        std::atomic<int64_t> value{0};
+    };
+
+    TrackerMetrics() = default;
+
+    CounterSlot counters_[kCounterCount];
+    GaugeSlot gauges_[kGaugeCount];
+    LatencyHistogram timings_[kTimingCount];
+};
+
+// Measures from construction to destruction into a Timing.
+class ScopedTiming {
+public:
+    explicit ScopedTiming(Timing timing);
+    ~ScopedTiming();
+    ScopedTiming(const ScopedTiming&) = delete;
+    ScopedTiming& operator=(const ScopedTiming&) = delete;
+
+private:
+    Timing timing_;
+    int64_t start_ns_;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_TRACKER_METRICS_H_
@@ -0,0 +1,77 @@
+#include "virtual_clock.h"
+
+#include <algorithm>
+
+namespace app_focus_tracker {
+
+VirtualClock::VirtualClock(int64_t wall_start_us) : wall_offset_(wall_start_us) {}
+
+Clock::SteadyTime VirtualClock::SteadyNow() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return NowLocked();
+}
+
+std::chrono::system_clock::time_point VirtualClock::WallNow() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(wall_offset_ + elapsed_));
+}
+
+bool VirtualClock::WaitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& cv,
+                             SteadyTime deadline, const std::function<bool()>& done) {
+    while (!done()) {
+        std::unique_lock<std::mutex> guard(mutex_);
+        if (deadline <= limit_) {
+            // Nothing else can happen before |deadline| within this run.
+            if (deadline > NowLocked()) elapsed_ = deadline - SteadyTime();
+            guard.unlock();
+            return done();
+        }
+        uint64_t generation = generation_.load();
+        ++waiting_;
+        sleepers_.push_back(&cv);
+        quiet_.notify_all();
+        guard.unlock();
+        // RunUntil() notifies |cv| without holding |lock|, so a wake-up can
+        // slip past; the short real timeout bounds that case.
+        cv.wait_for(lock, std::chrono::milliseconds(1),
+                    [&] { return done() || generation_.load() != generation; });
+        guard.lock();
+        sleepers_.erase(std::find(sleepers_.begin(), sleepers_.end(), &cv));
+        // A new run has already reset the count.
+        if (generation_.load() == generation) --waiting_;
+    }
+    return true;
+}
+
+void VirtualClock::ThreadStarting() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    ++threads_;
+}
+
+void VirtualClock::ThreadExited() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    --threads_;
+    quiet_.notify_all();
+}
+
+void VirtualClock::RunUntil(SteadyTime until) {
+    std::unique_lock<std::mutex> guard(mutex_);
+    limit_ = std::max(limit_, until);
+    ++generation_;
+    waiting_ = 0;
+    for (std::condition_variable* cv : sleepers_) cv->notify_all();
+    quiet_.wait(guard, [this] { return waiting_ >= threads_; });
+    if (until > NowLocked()) elapsed_ = until - SteadyTime();
+}
+
+void VirtualClock::RunFor(std::chrono::microseconds duration) {
+    RunUntil(SteadyNow() + duration);
+}
+
+void VirtualClock::Suspend(std::chrono::microseconds duration) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    wall_offset_ += duration;
+}
+
+}  // namespace app_focus_tracker
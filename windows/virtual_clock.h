@@ -0,0 +1,62 @@
+#ifndef FLUTTER_PLUGIN_VIRTUAL_CLOCK_H_
+#define FLUTTER_PLUGIN_VIRTUAL_CLOCK_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "clock.h"
+
+namespace app_focus_tracker {
+
+// Simulated time for the sampling thread. Time only moves inside
+// RunUntil(): a wait that ends before the end of the run returns at once
+// with time jumped to its deadline, so a simulated month costs only the
+// work done in it and produces the same samples on every run. A wait that
+// ends later blocks until a run reaches it. Meant for one waiting thread;
+// with several, each jumps to its own deadlines.
+class VirtualClock : public Clock {
+public:
+    // Starts at steady time zero and wall time |wall_start_us|.
+    explicit VirtualClock(int64_t wall_start_us);
+
+    SteadyTime SteadyNow() override;
+    std::chrono::system_clock::time_point WallNow() override;
+    bool WaitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& cv, SteadyTime deadline,
+                   const std::function<bool()>& done) override;
+    void ThreadStarting() override;
+    void ThreadExited() override;
+
+    // Lets waiting threads run until time reaches |until|, then returns once
+    // each of them is waiting for something later (or has exited). Must not
+    // be called from a thread that waits on this clock.
+    void RunUntil(SteadyTime until);
+    void RunFor(std::chrono::microseconds duration);
+    // Moves the wall clock on by |duration| while the steady clock stands
+    // still, as a suspended machine looks where the steady clock stops.
+    void Suspend(std::chrono::microseconds duration);
+
+private:
+    SteadyTime NowLocked() const { return SteadyTime() + elapsed_; }
+
+    std::mutex mutex_;
+    // Signalled whenever a thread starts waiting or exits.
+    std::condition_variable quiet_;
+    std::chrono::steady_clock::duration elapsed_{0};
+    std::chrono::microseconds wall_offset_;
+    SteadyTime limit_;
+    // Bumped by RunUntil() so waiters re-check their deadline.
+    std::atomic<uint64_t> generation_{0};
+    int threads_ = 0;
+    int waiting_ = 0;
+    // Condition variables of blocked threads, notified when time moves.
+    std::vector<std::condition_variable*> sleepers_;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_VIRTUAL_CLOCK_H_
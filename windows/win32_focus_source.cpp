@@ -0,0 +1,78 @@
+#include "win32_focus_source.h"
+
+#include <windows.h>
+
+#include <iterator>
+
+#include "text_encoding.h"
+#include "tracker_metrics.h"
+
+namespace app_focus_tracker {
+
+namespace {
+
+std::string ToUtf8(const wchar_t* text, int length) {
+    if (length <= 0) return std::string();
+    return Utf16ToUtf8(reinterpret_cast<const char16_t*>(text), static_cast<size_t>(length));
+}
+
+std::string GetWindowTitle(HWND hwnd) {
+    wchar_t window_title[256];
+    int length = GetWindowTextW(hwnd, window_title, static_cast<int>(std::size(window_title)));
+    return ToUtf8(window_title, length);
+}
+
+// Executable name of |process_id| without directory or extension.
+std::string GetProcessName(DWORD process_id) {
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, process_id);
+    if (!process) return std::string();
+    wchar_t path[MAX_PATH];
+    DWORD length = MAX_PATH;
+    BOOL ok = QueryFullProcessImageNameW(process, 0, path, &length);
+    CloseHandle(process);
+    if (!ok) return std::string();
+
+    const wchar_t* name = path;
+    const wchar_t* extension = path + length;
+    for (const wchar_t* p = path; p < path + length; ++p) {
+        if (*p == L'\\' || *p == L'/') name = p + 1;
+        if (*p == L'.') extension = p;
+    }
+    if (extension < name) extension = path + length;
+    return ToUtf8(name, static_cast<int>(extension - name));
+}
+
+}  // namespace
+
+bool Win32FocusSource::Sample(FocusSample* sample) {
+    TrackerMetrics& metrics = TrackerMetrics::Get();
+    HWND hwnd = GetForegroundWindow();
+    metrics.Add(Counter::kOsCalls);
+    if (!hwnd) return false;
+    DWORD process_id = 0;
+    GetWindowThreadProcessId(hwnd, &process_id);
+    metrics.Add(Counter::kOsCalls);
+
+    // The foreground process rarely changes between samples.
+    if (process_id != cached_process_id_) {
+        // OpenProcess, QueryFullProcessImageNameW and CloseHandle.
+        metrics.Add(Counter::kOsCalls, 3);
+        cached_process_id_ = process_id;
+        cached_app_name_ = GetProcessName(process_id);
+    }
+
+    sample->window_id = reinterpret_cast<uintptr_t>(hwnd);
+    sample->process_id = process_id;
+    sample->app_name = cached_app_name_;
+    return true;
+}
+
+bool Win32FocusSource::FetchTitle(const FocusSample& sample, std::string* title) {
+    HWND hwnd = reinterpret_cast<HWND>(static_cast<uintptr_t>(sample.window_id));
+    TrackerMetrics::Get().Add(Counter::kOsCalls, 2);
+    if (!IsWindow(hwnd)) return false;
+    *title = GetWindowTitle(hwnd);
+    return true;
+}
+
+}  // namespace app_focus_tracker
@@ -0,0 +1,26 @@
+#ifndef FLUTTER_PLUGIN_WIN32_FOCUS_SOURCE_H_
+#define FLUTTER_PLUGIN_WIN32_FOCUS_SOURCE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "focus_source.h"
+
+namespace app_focus_tracker {
+
+// FocusSource backed by GetForegroundWindow(). GetWindowText() may have to
+// message the window's thread, so titles are fetched separately.
+class Win32FocusSource : public FocusSource {
+public:
+    bool Sample(FocusSample* sample) override;
+    bool slow_titles() const override { return true; }
+    bool FetchTitle(const FocusSample& sample, std::string* title) override;
+
+private:
+    uint32_t cached_process_id_ = 0;
+    std::string cached_app_name_;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_WIN32_FOCUS_SOURCE_H_
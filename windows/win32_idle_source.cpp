@@ -0,0 +1,20 @@
+#include "win32_idle_source.h"
+
+#include <windows.h>
+
+#include "tracker_metrics.h"
+
+namespace app_focus_tracker {
+
+bool Win32IdleSource::IdleTime(int64_t* idle_us) {
+    LASTINPUTINFO info = {};
+    info.cbSize = sizeof(info);
+    TrackerMetrics::Get().Add(Counter::kOsCalls, 2);
+    if (!GetLastInputInfo(&info)) return false;
+    // Both are 32-bit tick counts, so the difference survives wraparound.
+    DWORD idle_ms = GetTickCount() - info.dwTime;
+    *idle_us = static_cast<int64_t>(idle_ms) * 1000;
+    return true;
+}
+
+}  // namespace app_focus_tracker
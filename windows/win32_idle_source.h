@@ -0,0 +1,17 @@
+#ifndef FLUTTER_PLUGIN_WIN32_IDLE_SOURCE_H_
+#define FLUTTER_PLUGIN_WIN32_IDLE_SOURCE_H_
+
+#include "idle_source.h"
+
+namespace app_focus_tracker {
+
+// IdleSource backed by GetLastInputInfo(), which covers input in every
+// session on the current desktop.
+class Win32IdleSource : public IdleSource {
+public:
+    bool IdleTime(int64_t* idle_us) override;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_WIN32_IDLE_SOURCE_H_
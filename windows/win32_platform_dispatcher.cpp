@@ -0,0 +1,86 @@
+#include "win32_platform_dispatcher.h"
+
+#include <utility>
+
+#include "tracker_metrics.h"
+
+namespace app_focus_tracker {
+
+namespace {
+
+constexpr wchar_t kWindowClass[] = L"AppFocusTrackerPlatformDispatcher";
+// The window is private to the dispatcher, so any WM_APP message will do.
+constexpr UINT kDrainMessage = WM_APP + 1;
+
+HINSTANCE ModuleInstance() {
+    HMODULE module = nullptr;
+    GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                       reinterpret_cast<LPCWSTR>(&ModuleInstance), &module);
+    return module;
+}
+
+}  // namespace
+
+std::unique_ptr<Win32PlatformDispatcher> Win32PlatformDispatcher::Create() {
+    HINSTANCE instance = ModuleInstance();
+    WNDCLASSEXW window_class = {};
+    window_class.cbSize = sizeof(window_class);
+    window_class.lpfnWndProc = &Win32PlatformDispatcher::WindowProc;
+    window_class.hInstance = instance;
+    window_class.lpszClassName = kWindowClass;
+    // Every engine in the process shares the class.
+    if (!RegisterClassExW(&window_class) && GetLastError() != ERROR_CLASS_ALREADY_EXISTS) {
+        return nullptr;
+    }
+    HWND window = CreateWindowExW(0, kWindowClass, L"", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, instance,
+                                  nullptr);
+    if (!window) return nullptr;
+    std::unique_ptr<Win32PlatformDispatcher> dispatcher(new Win32PlatformDispatcher(window));
+    SetWindowLongPtrW(window, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(dispatcher.get()));
+    return dispatcher;
+}
+
+Win32PlatformDispatcher::Win32PlatformDispatcher(HWND window) : window_(window) {}
+
+Win32PlatformDispatcher::~Win32PlatformDispatcher() {
+    SetWindowLongPtrW(window_, GWLP_USERDATA, 0);
+    DestroyWindow(window_);
+}
+
+void Win32PlatformDispatcher::Post(std::function<void()> task) {
+    // Declared before the lock so dropped tasks are destroyed after it is
+    // released.
+    std::deque<std::function<void()>> dropped;
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+    if (posted_) return;
+    posted_ = PostMessageW(window_, kDrainMessage, 0, 0) != FALSE;
+    if (!posted_) {
+        // The platform thread's queue is full; nothing would drain these.
+        TrackerMetrics::Get().Add(Counter::kEventsDropped, tasks_.size());
+        dropped.swap(tasks_);
+    }
+}
+
+LRESULT CALLBACK Win32PlatformDispatcher::WindowProc(HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam) {
+    if (message == kDrainMessage) {
+        auto* dispatcher = reinterpret_cast<Win32PlatformDispatcher*>(GetWindowLongPtrW(hwnd, GWLP_USERDATA));
+        if (dispatcher) dispatcher->Drain();
+        return 0;
+    }
+    return DefWindowProcW(hwnd, message, wparam, lparam);
+}
+
+void Win32PlatformDispatcher::Drain() {
+    std::deque<std::function<void()>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks.swap(tasks_);
+        posted_ = false;
+    }
+    for (auto& task : tasks) {
+        task();
+    }
+}
+
+}  // namespace app_focus_tracker
@@ -0,0 +1,49 @@
+#ifndef FLUTTER_PLUGIN_WIN32_PLATFORM_DISPATCHER_H_
+#define FLUTTER_PLUGIN_WIN32_PLATFORM_DISPATCHER_H_
+
+#include <windows.h>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "platform_dispatcher.h"
+
+namespace app_focus_tracker {
+
+// Posts a message to a message-only window of its own, created on the
+// platform thread, and drains the task queue from that window's procedure.
+// Unlike the runner's top-level window it exists for headless engines too.
+class Win32PlatformDispatcher : public PlatformDispatcher {
+public:
+    // Must be called on the platform thread. Returns null if the window
+    // cannot be created, in which case nothing could ever be delivered.
+    static std::unique_ptr<Win32PlatformDispatcher> Create();
+
+    ~Win32PlatformDispatcher() override;
+    Win32PlatformDispatcher(const Win32PlatformDispatcher&) = delete;
+    Win32PlatformDispatcher& operator=(const Win32PlatformDispatcher&) = delete;
+
+    // Tasks are never run on the calling thread. If the wake-up message
+    // cannot be posted, everything queued is dropped and counted in
+    // Counter::kEventsDropped.
+    void Post(std::function<void()> task) override;
+
+private:
+    explicit Win32PlatformDispatcher(HWND window);
+
+    static LRESULT CALLBACK WindowProc(HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam);
+    void Drain();
+
+    HWND window_;
+
+    std::mutex mutex_;
+    std::deque<std::function<void()>> tasks_;
+    // True while a wake-up message is in flight, so bursts post only one.
+    bool posted_ = false;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_WIN32_PLATFORM_DISPATCHER_H_
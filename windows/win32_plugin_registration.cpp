@@ -0,0 +1,96 @@
+#include "app_focus_tracker_plugin.h"
+
+#include <flutter/plugin_registrar_windows.h>
+#include <windows.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "win32_focus_source.h"
+#include "win32_idle_source.h"
+#include "win32_platform_dispatcher.h"
+#include "win32_session_monitor.h"
+
+namespace {
+
+// Local time minus UTC right now, daylight saving time included.
+int64_t LocalUtcOffsetUs() {
+    SYSTEMTIME utc;
+    SYSTEMTIME local;
+    GetSystemTime(&utc);
+    if (!SystemTimeToTzSpecificLocalTime(nullptr, &utc, &local)) return 0;
+    FILETIME utc_file;
+    FILETIME local_file;
+    if (!SystemTimeToFileTime(&utc, &utc_file) || !SystemTimeToFileTime(&local, &local_file)) return 0;
+    ULARGE_INTEGER utc_ticks;
+    ULARGE_INTEGER local_ticks;
+    utc_ticks.LowPart = utc_file.dwLowDateTime;
+    utc_ticks.HighPart = utc_file.dwHighDateTime;
+    local_ticks.LowPart = local_file.dwLowDateTime;
+    local_ticks.HighPart = local_file.dwHighDateTime;
+    // FILETIMEs count 100ns ticks.
+    return (static_cast<int64_t>(local_ticks.QuadPart) - static_cast<int64_t>(utc_ticks.QuadPart)) / 10;
+}
+
+}  // namespace
+
+// Wiring that needs the Windows embedder; the rest of the plugin lives in
+// app_focus_tracker_plugin.cpp and also builds on the host.
+void AppFocusTrackerPlugin::RegisterWithRegistrar(flutter::PluginRegistrarWindows* registrar) {
+    // Events can only reach Dart through the platform thread, so without a
+    // dispatcher the plugin stays unregistered rather than sending from the
+    // sampling thread.
+    auto dispatcher = app_focus_tracker::Win32PlatformDispatcher::Create();
+    if (!dispatcher) return;
+
+    // Every engine in the process shares one sampler. It samples twice a
+    // second right after focus moves and backs off to every 8s while focus
+    // stays put, waking on wall-clock boundaries. After five minutes
+    // without input it stops sampling until input resumes. Its threads run
+    // in background mode under EcoQoS so they never compete with the UI.
+    app_focus_tracker::ScheduleOptions schedule;
+    schedule.min_interval = std::chrono::milliseconds(500);
+    schedule.max_interval = std::chrono::seconds(8);
+    schedule.align_to_wall_clock = true;
+    schedule.qos.priority = app_focus_tracker::ThreadPriority::kBackground;
+    schedule.qos.eco_qos = true;
+    auto sampler = app_focus_tracker::FocusSampler::Acquire(
+        [] { return std::make_unique<app_focus_tracker::Win32FocusSource>(); }, schedule,
+        [] { return std::make_unique<app_focus_tracker::Win32IdleSource>(); });
+    // Budget days start at local midnight.
+    sampler->SetUtcOffset(LocalUtcOffsetUs());
+    auto plugin = std::make_unique<AppFocusTrackerPlugin>(
+        std::move(sampler), std::move(dispatcher));
+
+    // Lock pauses sampling outright; a suspend closes the open span now,
+    // and the tracker notices the resume itself. Time zone and daylight
+    // saving changes move the start of the budget day.
+    std::weak_ptr<app_focus_tracker::FocusSampler> weak_sampler = plugin->sampler_;
+    plugin->session_monitor_ = std::make_unique<app_focus_tracker::Win32SessionMonitor>(
+        registrar, [weak_sampler](app_focus_tracker::SessionEvent event) {
+            auto target = weak_sampler.lock();
+            if (!target) return;
+            switch (event) {
+                case app_focus_tracker::SessionEvent::kLocked:
+                    target->SetSessionLocked(true);
+                    break;
+                case app_focus_tracker::SessionEvent::kUnlocked:
+                    target->SetSessionLocked(false);
+                    break;
+                case app_focus_tracker::SessionEvent::kSuspending:
+                    target->NotifySuspended(std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::system_clock::now().time_since_epoch()).count());
+                    break;
+                case app_focus_tracker::SessionEvent::kResumed:
+                    break;
+                case app_focus_tracker::SessionEvent::kTimeChanged:
+                    target->SetUtcOffset(LocalUtcOffsetUs());
+                    break;
+            }
+        });
+
+    plugin->ConnectChannels(registrar->messenger());
+    registrar->AddPlugin(std::move(plugin));
+}
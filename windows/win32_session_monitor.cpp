@@ -0,0 +1,45 @@
+#include "win32_session_monitor.h"
+
+#include <wtsapi32.h>
+
+#include <utility>
+
+namespace app_focus_tracker {
+
+Win32SessionMonitor::Win32SessionMonitor(flutter::PluginRegistrarWindows* registrar, Callback callback)
+    : registrar_(registrar), callback_(std::move(callback)) {
+    if (flutter::FlutterView* view = registrar_->GetView()) {
+        window_ = GetAncestor(view->GetNativeWindow(), GA_ROOT);
+    }
+    if (window_) {
+        registered_ = WTSRegisterSessionNotification(window_, NOTIFY_FOR_THIS_SESSION) != FALSE;
+    }
+    delegate_id_ = registrar_->RegisterTopLevelWindowProcDelegate(
+        [this](HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam) {
+            return HandleMessage(hwnd, message, wparam, lparam);
+        });
+}
+
+Win32SessionMonitor::~Win32SessionMonitor() {
+    registrar_->UnregisterTopLevelWindowProcDelegate(delegate_id_);
+    if (registered_) {
+        WTSUnRegisterSessionNotification(window_);
+    }
+}
+
+std::optional<LRESULT> Win32SessionMonitor::HandleMessage(HWND hwnd, UINT message, WPARAM wparam,
+                                                          LPARAM lparam) {
+    // Other delegates may want these too, so never consume them.
+    if (message == WM_WTSSESSION_CHANGE) {
+        if (wparam == WTS_SESSION_LOCK) callback_(SessionEvent::kLocked);
+        if (wparam == WTS_SESSION_UNLOCK) callback_(SessionEvent::kUnlocked);
+    } else if (message == WM_POWERBROADCAST) {
+        if (wparam == PBT_APMSUSPEND) callback_(SessionEvent::kSuspending);
+        if (wparam == PBT_APMRESUMEAUTOMATIC) callback_(SessionEvent::kResumed);
+    } else if (message == WM_TIMECHANGE) {
+        callback_(SessionEvent::kTimeChanged);
+    }
+    return std::nullopt;
+}
+
+}  // namespace app_focus_tracker
@@ -0,0 +1,34 @@
+#ifndef FLUTTER_PLUGIN_WIN32_SESSION_MONITOR_H_
+#define FLUTTER_PLUGIN_WIN32_SESSION_MONITOR_H_
+
+#include <flutter/plugin_registrar_windows.h>
+#include <windows.h>
+
+#include <optional>
+
+#include "session_monitor.h"
+
+namespace app_focus_tracker {
+
+// Watches WM_WTSSESSION_CHANGE, WM_POWERBROADCAST and WM_TIMECHANGE from
+// the runner's top-level window procedure.
+class Win32SessionMonitor : public SessionMonitor {
+public:
+    Win32SessionMonitor(flutter::PluginRegistrarWindows* registrar, Callback callback);
+    ~Win32SessionMonitor() override;
+    Win32SessionMonitor(const Win32SessionMonitor&) = delete;
+    Win32SessionMonitor& operator=(const Win32SessionMonitor&) = delete;
+
+private:
+    std::optional<LRESULT> HandleMessage(HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam);
+
+    flutter::PluginRegistrarWindows* registrar_;
+    Callback callback_;
+    int delegate_id_ = 0;
+    HWND window_ = nullptr;
+    bool registered_ = false;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_WIN32_SESSION_MONITOR_H_
@@ -0,0 +1,70 @@
+#include "x11_idle_source.h"
+
+#include <dlfcn.h>
+
+#include "tracker_metrics.h"
+
+namespace app_focus_tracker {
+
+namespace {
+
+// Mirrors XScreenSaverInfo from <X11/extensions/scrnsaver.h>.
+struct ScreenSaverInfo {
+    unsigned long window;
+    int state;
+    int kind;
+    unsigned long til_or_since;
+    unsigned long idle;
+    unsigned long event_mask;
+};
+
+}  // namespace
+
+struct X11IdleSource::Api {
+    void* x11 = nullptr;
+    void* xss = nullptr;
+    void* (*open_display)(const char*) = nullptr;
+    int (*close_display)(void*) = nullptr;
+    unsigned long (*default_root_window)(void*) = nullptr;
+    int (*free)(void*) = nullptr;
+    ScreenSaverInfo* (*alloc_info)() = nullptr;
+    int (*query_info)(void*, unsigned long, ScreenSaverInfo*) = nullptr;
+};
+
+X11IdleSource::X11IdleSource() : api_(new Api) {
+    api_->x11 = dlopen("libX11.so.6", RTLD_LAZY | RTLD_LOCAL);
+    api_->xss = dlopen("libXss.so.1", RTLD_LAZY | RTLD_LOCAL);
+    if (!api_->x11 || !api_->xss) return;
+    api_->open_display = reinterpret_cast<void* (*)(const char*)>(dlsym(api_->x11, "XOpenDisplay"));
+    api_->close_display = reinterpret_cast<int (*)(void*)>(dlsym(api_->x11, "XCloseDisplay"));
+    api_->default_root_window = reinterpret_cast<unsigned long (*)(void*)>(dlsym(api_->x11, "XDefaultRootWindow"));
+    api_->free = reinterpret_cast<int (*)(void*)>(dlsym(api_->x11, "XFree"));
+    api_->alloc_info = reinterpret_cast<ScreenSaverInfo* (*)()>(dlsym(api_->xss, "XScreenSaverAllocInfo"));
+    api_->query_info = reinterpret_cast<int (*)(void*, unsigned long, ScreenSaverInfo*)>(
+        dlsym(api_->xss, "XScreenSaverQueryInfo"));
+    if (!api_->open_display || !api_->close_display || !api_->default_root_window || !api_->free ||
+        !api_->alloc_info || !api_->query_info) {
+        return;
+    }
+    display_ = api_->open_display(nullptr);
+    if (display_) info_ = api_->alloc_info();
+}
+
+X11IdleSource::~X11IdleSource() {
+    if (info_) api_->free(info_);
+    if (display_) api_->close_display(display_);
+    if (api_->xss) dlclose(api_->xss);
+    if (api_->x11) dlclose(api_->x11);
+    delete api_;
+}
+
+bool X11IdleSource::IdleTime(int64_t* idle_us) {
+    if (!display_ || !info_) return false;
+    auto* info = static_cast<ScreenSaverInfo*>(info_);
+    TrackerMetrics::Get().Add(Counter::kOsCalls, 2);
+    if (!api_->query_info(display_, api_->default_root_window(display_), info)) return false;
+    *idle_us = static_cast<int64_t>(info->idle) * 1000;
+    return true;
+}
+
+}  // namespace app_focus_tracker
@@ -0,0 +1,31 @@
+#ifndef FLUTTER_PLUGIN_X11_IDLE_SOURCE_H_
+#define FLUTTER_PLUGIN_X11_IDLE_SOURCE_H_
+
+#include "idle_source.h"
+
+namespace app_focus_tracker {
+
+// IdleSource backed by the XScreenSaver extension's idle counter. libX11
+// and libXss are loaded at runtime, so hosts without X (or without the
+// extension) build fine and simply report no idle time.
+class X11IdleSource : public IdleSource {
+public:
+    X11IdleSource();
+    ~X11IdleSource() override;
+    X11IdleSource(const X11IdleSource&) = delete;
+    X11IdleSource& operator=(const X11IdleSource&) = delete;
+
+    bool IdleTime(int64_t* idle_us) override;
+    bool available() const { return display_ != nullptr; }
+
+private:
+    struct Api;
+
+    Api* api_ = nullptr;
+    void* display_ = nullptr;
+    void* info_ = nullptr;
+};
+
+}  // namespace app_focus_tracker
+
+#endif  // FLUTTER_PLUGIN_X11_IDLE_SOURCE_H_